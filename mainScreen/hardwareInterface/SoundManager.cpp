@@ -1,4 +1,5 @@
 #include "SoundManager.h"
+#include "utils/audiomixer.h"
 #include <QFile>
 #include <QDebug>
 #include <unistd.h>
@@ -7,7 +8,6 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QStringList>
-#include <QTemporaryFile>
 #include <algorithm>
 
 SoundManager* SoundManager::instance = nullptr;
@@ -23,8 +23,6 @@ SoundManager* SoundManager::getInstance()
 SoundManager::SoundManager() : 
     backgroundVolume(0.8f),
     effectVolume(1.0f),
-    backgroundPcm(nullptr),
-    effectPcm(nullptr),
     isBackgroundPlaying(false),
     dumpMode(false)  // 덤프 모드 초기화
 {
@@ -106,48 +104,33 @@ SoundManager::SoundManager() :
     soundFilePath[FAIL_SOUND] = ":/music/fail_sound.wav";
     soundFilePath[DUMMY_SOUND] = "";  // 더미 사운드는 빈 문자열
     
-    // PCM 디바이스 열기 시도
-    bool pcmInitSuccess = false;
-    
-    // 배경음악용 PCM 초기화
-    if (!openPcm(&backgroundPcm, "hw:0,0")) {
-        qDebug() << "ERROR: Failed to open hw:0,0, trying alternative device";
-        if (!openPcm(&backgroundPcm, "default")) {
-            qDebug() << "ERROR: Failed to open default device as well";
-            // 모든 PCM 디바이스 초기화 실패
-            pcmInitSuccess = false;
-        } else {
-            pcmInitSuccess = true;
-        }
+    // PCM 디바이스 하나를 열어 믹싱 엔진에 넘김 (배경음악과 효과음이 공유)
+    snd_pcm_t *pcm = nullptr;
+    if (!openPcm(&pcm, "default")) {
+        qDebug() << "ERROR: Failed to open any PCM device";
+    } else if (!engine.configure(pcm, soundBank.outputRate(), soundBank.outputChannels())) {
+        qDebug() << "ERROR: Failed to configure PCM device";
+        snd_pcm_close(pcm);
     } else {
-        pcmInitSuccess = true;
-    }
-    
-    // 효과음용 PCM 초기화
-    if (!openPcm(&effectPcm, "hw:0,0")) {
-        qDebug() << "ERROR: Failed to open effect device hw:0,0";
-        if (!openPcm(&effectPcm, "default")) {
-            qDebug() << "ERROR: Failed to open default device for effects";
-            // 효과음 PCM 초기화 실패, 성공 플래그 업데이트
-            pcmInitSuccess = false;
+        // 효과음을 장치 포맷으로 미리 디코드 (재생 시 임시 파일/헤더 파싱 없음)
+        soundBank.setOutputFormat(engine.outputRate(), engine.outputChannels());
+        for (QMap<SoundEffect, QString>::const_iterator it = soundFilePath.constBegin(); it != soundFilePath.constEnd(); ++it) {
+            if (!it.value().isEmpty()) {
+                soundBank.add(it.key(), it.value());
+            }
+        }
+        soundBank.preload();
+        soundBank.add(BACKGROUND_MUSIC_ID, backgroundMusicPath);
+
+        if (!engine.start()) {
+            qDebug() << "ERROR: Failed to start audio engine";
         }
     }
     
     // PCM 초기화 실패시 덤프 모드 활성화
-    if (!pcmInitSuccess || !backgroundPcm || !effectPcm) {
+    if (!engine.isRunning()) {
         qDebug() << "WARNING: PCM initialization failed - activating dump mode";
         dumpMode = true;
-        
-        // NULL 포인터 정리
-        if (backgroundPcm) {
-            snd_pcm_close(backgroundPcm);
-            backgroundPcm = nullptr;
-        }
-        
-        if (effectPcm) {
-            snd_pcm_close(effectPcm);
-            effectPcm = nullptr;
-        }
     }
     
     // PCM 장치 정보 출력
@@ -199,16 +182,8 @@ void SoundManager::cleanup()
     // 배경음악 중지
     stopBackgroundMusic();
     
-    // PCM 디바이스 닫기
-    if (backgroundPcm) {
-        snd_pcm_close(backgroundPcm);
-        backgroundPcm = nullptr;
-    }
-    
-    if (effectPcm) {
-        snd_pcm_close(effectPcm);
-        effectPcm = nullptr;
-    }
+    // 믹싱 스레드 종료 및 PCM 디바이스 닫기
+    engine.stop();
     
     qDebug() << "DEBUG: SoundManager resource cleanup completed";
 }
@@ -273,11 +248,17 @@ void SoundManager::playBackgroundMusic()
         return;
     }
     
-    qDebug() << "Starting background music playback";
-    isBackgroundPlaying = true;
+    // 처음 재생할 때 디코드 (이후에는 메모리에서 반복)
+    SoundBank::Sample sample = soundBank.sample(BACKGROUND_MUSIC_ID);
+    if (!sample.isValid()) {
+        qDebug() << "ERROR: Background music not available:" << backgroundMusicPath;
+        return;
+    }
     
-    // 배경음악 스레드 생성
-    pthread_create(&backgroundThread, NULL, backgroundThreadFunc, this);
+    qDebug() << "Starting background music playback";
+    if (engine.playMusic(sample, AudioMixer::gainFromVolume(backgroundVolume))) {
+        isBackgroundPlaying = true;
+    }
 }
 
 void SoundManager::stopBackgroundMusic()
@@ -294,33 +275,7 @@ void SoundManager::stopBackgroundMusic()
     
     qDebug() << "Stopping background music playback";
     isBackgroundPlaying = false;
-    
-    // 재생 스레드가 종료될 때까지 대기
-    pthread_join(backgroundThread, NULL);
-    qDebug() << "Background music thread terminated";
-}
-
-void* SoundManager::backgroundThreadFunc(void *arg)
-{
-    SoundManager *soundManager = static_cast<SoundManager*>(arg);
-    
-    // 덤프 모드인 경우 즉시 종료
-    if (soundManager->dumpMode) {
-        qDebug() << "WARNING: backgroundThreadFunc called in dump mode - terminating thread";
-        return nullptr;
-    }
-    
-    // PCM 디바이스가 열려있지 않으면 그대로 종료
-    if (!soundManager->backgroundPcm) {
-        qDebug() << "ERROR: Background PCM device is not open";
-        return nullptr;
-    }
-    
-    qDebug() << "Background music thread started";
-    soundManager->playWavFile(soundManager->backgroundPcm, soundManager->backgroundMusicPath, true, 1.0f);
-    qDebug() << "Background music thread finished";
-    
-    return nullptr;
+    engine.stopMusic();
 }
 
 void SoundManager::playEffect(SoundEffect effect)
@@ -341,49 +296,23 @@ void SoundManager::playEffect(SoundEffect effect)
         return;
     }
     
-    // 효과음 파일 경로 가져오기
-    QString filePath = soundFilePath[effect];
-    
-    qDebug() << "Playing sound effect: " << filePath;
-    
-    // 모든 효과음은 스레드에서 재생
-    QThread *thread = QThread::create([this, filePath, effect]() {
-        // 효과음용 임시 PCM 핸들 생성
-        snd_pcm_t *tempPcm = nullptr;
-        if (!openPcm(&tempPcm, "hw:0,0")) {
-            qDebug() << "ERROR: Failed to open temporary PCM device for effect";
-            // PCM 장치를 열지 못하면, 소리 없이 계속 진행
-            return;
-        }
-        
-        // PCM 장치가 NULL인지 확인하고 로그 남기기 (추가 보호 조치)
-        if (!tempPcm) {
-            qDebug() << "ERROR: tempPcm is NULL even after successful openPcm!";
-            return;
-        }
-        
-        // 효과음 재생 (볼륨 증가)
-        float volumeMult = 2.0f;
-        // SUCCESS_SOUND와 FAIL_SOUND는 볼륨을 더 높임
-        if (effect == SUCCESS_SOUND || effect == FAIL_SOUND) {
-            volumeMult = 3.0f;
-        }
-        
-        qDebug() << "Starting sound effect playback - Volume:" << volumeMult;
-        playWavFile(tempPcm, filePath, false, volumeMult);
-        qDebug() << "Sound effect playback completed";
-        
-        // 사용 후 PCM 핸들 닫기
-        if (tempPcm) {
-            snd_pcm_drain(tempPcm);
-            snd_pcm_close(tempPcm);
-        }
-    });
+    // 미리 디코드된 효과음 가져오기
+    SoundBank::Sample sample = soundBank.sample(effect);
+    if (!sample.isValid()) {
+        qDebug() << "ERROR: Sound effect not available:" << soundFilePath[effect];
+        return;
+    }
     
-    thread->start();
+    // 효과음 볼륨 증가, SUCCESS_SOUND와 FAIL_SOUND는 더 높임
+    float volumeMult = 2.0f;
+    if (effect == SUCCESS_SOUND || effect == FAIL_SOUND) {
+        volumeMult = 3.0f;
+    }
     
-    // 스레드 자동 삭제 설정
-    connect(thread, &QThread::finished, thread, &QThread::deleteLater);
+    // 믹싱 스레드에 재생 명령만 넣고 바로 반환 (다음 주기부터 섞임)
+    if (!engine.playEffect(sample, AudioMixer::gainFromVolume(volumeMult * effectVolume))) {
+        qDebug() << "WARNING: Sound effect dropped (command queue full):" << soundFilePath[effect];
+    }
 }
 
 void SoundManager::setBackgroundVolume(float volume)
@@ -396,41 +325,9 @@ void SoundManager::setBackgroundVolume(float volume)
     
     qDebug() << "Background music volume changed: " << oldVolume << " -> " << backgroundVolume;
     
-    // If currently playing, restart background music to apply volume change immediately
+    // 재생 중이면 믹싱 스레드가 다음 주기부터 새 게인 적용 (재시작 없음)
     if (isBackgroundPlaying) {
-        qDebug() << "Background music is playing - restarting to apply volume change immediately";
-        
-        // Stop background music
-        bool wasPlaying = isBackgroundPlaying;
-        isBackgroundPlaying = false;
-        
-        // Wait for existing thread to terminate
-        pthread_join(backgroundThread, NULL);
-        
-        // Reset PCM device state
-        if (backgroundPcm) {
-            snd_pcm_drop(backgroundPcm);
-            snd_pcm_close(backgroundPcm);
-            backgroundPcm = nullptr;
-            
-            // Reopen PCM device
-            if (!openPcm(&backgroundPcm, "hw:0,0")) {
-                if (!openPcm(&backgroundPcm, "default")) {
-                    qDebug() << "ERROR: Failed to reopen background PCM device";
-                    return;
-                }
-            }
-            qDebug() << "Background music PCM device reinitialized";
-        }
-        
-        // Restart background music (with new volume)
-        if (wasPlaying) {
-            isBackgroundPlaying = true;
-            pthread_create(&backgroundThread, NULL, backgroundThreadFunc, this);
-            qDebug() << "Background music restarted with new volume: " << backgroundVolume;
-        }
-    } else {
-        qDebug() << "Background music not playing - new volume will be applied on next playback: " << backgroundVolume;
+        engine.setMusicGain(AudioMixer::gainFromVolume(backgroundVolume));
     }
     
     // ALSA volume control
@@ -510,260 +407,3 @@ void SoundManager::setEffectVolume(float volume)
     // 이 메서드는 즉시 효과음 재생에 영향을 주지 않음
     // 다음 효과음 재생부터 적용됨
 }
-
-void SoundManager::playWavFile(snd_pcm_t *pcm, const QString &filename, bool loop, float volumeMultiplier)
-{
-    if (!pcm) {
-        qDebug() << "ERROR: PCM device is NULL";
-        return;
-    }
-    
-    // 적용할 실제 볼륨 계산 (배경음악인지 효과음인지에 따라 다른 볼륨 값 사용)
-    float actualVolumeMultiplier = volumeMultiplier;
-    if (loop) {
-        // 배경음악인 경우
-        actualVolumeMultiplier *= backgroundVolume;
-        qDebug() << "Background music playback - Volume multiplier:" << volumeMultiplier << " x Volume setting:" << backgroundVolume 
-                 << " = Final volume:" << actualVolumeMultiplier;
-    } else {
-        // 효과음인 경우
-        actualVolumeMultiplier *= effectVolume;
-        qDebug() << "Sound effect playback - Volume multiplier:" << volumeMultiplier << " x Volume setting:" << effectVolume 
-                 << " = Final volume:" << actualVolumeMultiplier;
-    }
-    
-    QFile file;
-    QString actualFilename = filename;
-    QTemporaryFile *tempFile = nullptr;
-    
-    // 파일 오류시 조기 복귀 (방어적 코딩 추가)
-    if (actualFilename.isEmpty()) {
-        qDebug() << "ERROR: Empty filename provided to playWavFile";
-        return;
-    }
-    
-    // 리소스 파일인 경우 임시 파일에 복사
-    if (filename.startsWith(":/")) {
-        QFile resourceFile(filename);
-        if (!resourceFile.open(QIODevice::ReadOnly)) {
-            qDebug() << "ERROR: Cannot open resource file:" << filename;
-            return;
-        }
-        
-        qDebug() << "Successfully opened resource file: " << filename;
-        
-        // 임시 파일 생성
-        tempFile = new QTemporaryFile();
-        tempFile->setAutoRemove(true);
-        if (!tempFile->open()) {
-            qDebug() << "ERROR: Cannot create temporary file";
-            resourceFile.close();
-            delete tempFile;
-            return;
-        }
-        
-        qDebug() << "Successfully created temporary file: " << tempFile->fileName();
-        
-        // 리소스 데이터를 임시 파일에 복사
-        QByteArray data = resourceFile.readAll();
-        tempFile->write(data);
-        tempFile->flush();
-        
-        actualFilename = tempFile->fileName();
-        resourceFile.close();
-    }
-    
-    // 임시 파일이나 일반 파일 열기
-    file.setFileName(actualFilename);
-    if (!file.open(QIODevice::ReadOnly)) {
-        qDebug() << "ERROR: Cannot open WAV file:" << actualFilename;
-        delete tempFile;
-        return;
-    }
-    
-    // WAV 헤더 크기
-    const int WAV_HEADER_SIZE = 44;
-    
-    // WAV 헤더 읽기
-    QByteArray header = file.read(WAV_HEADER_SIZE);
-    
-    if (header.size() < WAV_HEADER_SIZE) {
-        qDebug() << "ERROR: Invalid WAV header size:" << header.size();
-        file.close();
-        delete tempFile;
-        return;
-    }
-    
-    // PCM 파라미터 확인
-    unsigned int channels = header[22];
-    unsigned int sample_rate = (unsigned char)header[24] + 
-                               ((unsigned char)header[25] << 8) + 
-                               ((unsigned char)header[26] << 16) + 
-                               ((unsigned char)header[27] << 24);
-    unsigned int bits_per_sample = header[34];
-    
-    // 간단한 파일 정보만 출력
-    qDebug() << "WAV file information: " << filename;
-    qDebug() << "Channels: " << channels << ", Sample rate: " << sample_rate 
-             << "Hz, Bit depth: " << bits_per_sample << "bit";
-    
-    // ALSA 하드웨어 파라미터 설정
-    snd_pcm_hw_params_t *params;
-    snd_pcm_hw_params_alloca(&params);
-    
-    int err = snd_pcm_hw_params_any(pcm, params);
-    if (err < 0) {
-        qDebug() << "ERROR: Cannot initialize hardware parameters:" << snd_strerror(err);
-        file.close();
-        delete tempFile;
-        return;
-    }
-    
-    // 접근 모드 설정
-    err = snd_pcm_hw_params_set_access(pcm, params, SND_PCM_ACCESS_RW_INTERLEAVED);
-    if (err < 0) {
-        qDebug() << "ERROR: Cannot set access mode:" << snd_strerror(err);
-        file.close();
-        delete tempFile;
-        return;
-    }
-    
-    // 포맷 설정 - 24비트 특수 처리 제거하고 단순화
-    snd_pcm_format_t format;
-    
-    if (bits_per_sample == 8)
-        format = SND_PCM_FORMAT_U8;
-    else if (bits_per_sample == 16)
-        format = SND_PCM_FORMAT_S16_LE;
-    else {
-        qDebug() << "ERROR: Unsupported bits per sample:" << bits_per_sample;
-        file.close();
-        delete tempFile;
-        return;
-    }
-    
-    // 포맷 설정
-    err = snd_pcm_hw_params_set_format(pcm, params, format);
-    if (err < 0) {
-        qDebug() << "ERROR: Cannot set format:" << snd_strerror(err);
-        file.close();
-        delete tempFile;
-        return;
-    }
-    
-    // 채널 수 설정
-    err = snd_pcm_hw_params_set_channels(pcm, params, channels);
-    if (err < 0) {
-        qDebug() << "ERROR: Cannot set channels:" << snd_strerror(err);
-        file.close();
-        delete tempFile;
-        return;
-    }
-    
-    // 샘플 레이트 설정
-    unsigned int exactRate = sample_rate;
-    err = snd_pcm_hw_params_set_rate_near(pcm, params, &exactRate, 0);
-    if (err < 0) {
-        qDebug() << "ERROR: Cannot set sample rate:" << snd_strerror(err);
-        file.close();
-        delete tempFile;
-        return;
-    }
-    
-    // 버퍼 크기 및 주기 설정
-    snd_pcm_uframes_t buffer_size = 16384;
-    err = snd_pcm_hw_params_set_buffer_size_near(pcm, params, &buffer_size);
-    if (err < 0) {
-        qDebug() << "ERROR: Cannot set buffer size:" << snd_strerror(err);
-        file.close();
-        delete tempFile;
-        return;
-    }
-    
-    snd_pcm_uframes_t period_size = 4096;
-    err = snd_pcm_hw_params_set_period_size_near(pcm, params, &period_size, 0);
-    if (err < 0) {
-        qDebug() << "ERROR: Cannot set period size:" << snd_strerror(err);
-        file.close();
-        delete tempFile;
-        return;
-    }
-    
-    // 파라미터 적용
-    err = snd_pcm_hw_params(pcm, params);
-    if (err < 0) {
-        qDebug() << "ERROR: Cannot set hardware parameters:" << snd_strerror(err);
-        file.close();
-        delete tempFile;
-        return;
-    }
-    
-    // 재생 버퍼 할당
-    int frameSize = channels * (bits_per_sample / 8);
-    char *buffer = new char[period_size * frameSize];
-    
-    do {
-        file.seek(WAV_HEADER_SIZE);
-        
-        // 파일에서 데이터 읽고 재생
-        while (!file.atEnd() && (loop || !loop)) {
-            qint64 bytesRead = file.read(buffer, period_size * frameSize);
-            
-            if (bytesRead <= 0) {
-                break;
-            }
-            
-            // 변수 미리 선언
-            snd_pcm_uframes_t frames;
-            snd_pcm_sframes_t written;
-                    
-            // 샘플의 볼륨 조절 (재생 전)
-            if (bits_per_sample == 16) {
-                // 계산된 볼륨 적용
-                for (unsigned int i = 0; i < bytesRead / 2; i++) {
-                    short *sample = reinterpret_cast<short*>(buffer) + i;
-                    float adjusted = static_cast<float>(*sample) * actualVolumeMultiplier;
-                    *sample = static_cast<short>(std::min(32767.0f, std::max(-32768.0f, adjusted)));
-                }
-            }
-            
-            // 재생
-            frames = bytesRead / frameSize;
-            written = snd_pcm_writei(pcm, buffer, frames);
-            
-            if (written < 0) {
-                written = snd_pcm_recover(pcm, written, 0);
-                if (written < 0) {
-                    qDebug() << "ERROR: Recovery failed:" << snd_strerror(written);
-                    break;
-                }
-            }
-            
-            // 효과음이거나 재생 중지 명령이 있으면 종료
-            if (!loop || (loop && !isBackgroundPlaying)) {
-                if (bytesRead < period_size * frameSize || !isBackgroundPlaying) {
-                    break;
-                }
-            }
-        }
-        
-        // 루프 아니면 종료
-        if (!loop) {
-            break;
-        }
-        
-    } while (loop && isBackgroundPlaying);
-    
-    delete[] buffer;
-    file.close();
-    
-    // 임시 파일 정리
-    if (tempFile) {
-        delete tempFile;
-    }
-    
-    // 효과음이면 drain
-    if (!loop) {
-        snd_pcm_drain(pcm);
-    }
-} 
\ No newline at end of file
@@ -11,6 +11,8 @@
 #include <QDebug>
 #include <QFileInfo>
 #include <QCoreApplication>
+#include "utils/soundbank.h"
+#include "hardwareInterface/audioengine.h"
 
 class SoundManager : public QObject
 {
@@ -52,32 +54,35 @@ public:
     // 추가: 덤프 모드 상태 확인
     bool isDumpMode() const { return dumpMode; }
 
+    // 출력 지연/언더런 통계 (snd_pcm_delay 기준 출력 대기 시간, 효과음 요청부터 출력까지의 지연)
+    AudioEngine::Stats getAudioStats() const { return engine.getStats(); }
+
 private:
     SoundManager();
     ~SoundManager();
     
     // 파일 경로 매핑
     QMap<SoundEffect, QString> soundFilePath;
+
+    // 효과음/배경음악 샘플 (장치 포맷으로 한 번 준비, 재생은 메모리에서)
+    // 효과음은 시작 시, 배경음악은 처음 재생할 때 준비 (IMA-ADPCM은 압축된 채로 스트리밍)
+    SoundBank soundBank;
+    static const int BACKGROUND_MUSIC_ID = -1;
+
+    // 단일 믹싱 스레드 (PCM 핸들 하나를 배경음악과 효과음이 공유)
+    AudioEngine engine;
     
     // 볼륨 레벨
     float backgroundVolume;
     float effectVolume;
     
-    // ALSA 핸들
-    snd_pcm_t *backgroundPcm;
-    snd_pcm_t *effectPcm;
-    
-    // 배경음악 스레드
-    pthread_t backgroundThread;
+    // 배경음악 재생 상태
     std::atomic<bool> isBackgroundPlaying;
     
     // 덤프 모드 플래그 (오디오 초기화 실패 시 활성화)
     bool dumpMode;
     
-    // WAV 파일 재생 함수
     bool openPcm(snd_pcm_t **pcm, const char *device);
-    void playWavFile(snd_pcm_t *pcm, const QString &filename, bool loop, float volumeMultiplier);
-    static void* backgroundThreadFunc(void *arg);
 
     // 싱글톤 인스턴스
     static SoundManager *instance;
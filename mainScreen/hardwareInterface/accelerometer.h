@@ -2,12 +2,8 @@
 #define ACCELEROMETER_H
 
 #include <QObject>
-#include <QFile>
-#include <QSocketNotifier>
-#include <QThread>
-#include <QMutex>
-#include <linux/input.h>
 #include <QDebug>
+#include "hardwareInterface/inputhub.h"
 
 // 가속도 데이터를 저장하는 구조체
 struct AccelerometerData {
@@ -19,41 +15,7 @@ struct AccelerometerData {
 // Qt 메타 타입 시스템에 AccelerometerData 등록
 Q_DECLARE_METATYPE(AccelerometerData)
 
-// 가속도 센서 이벤트 읽기를 담당할 스레드 클래스
-class AccelerometerReaderThread : public QThread
-{
-    Q_OBJECT
-    
-public:
-    AccelerometerReaderThread(QObject *parent = nullptr);
-    ~AccelerometerReaderThread();
-    
-    // 스레드 시작 전 초기화
-    bool initialize();
-    void stopReading();
-
-signals:
-    // 가속도 값 변경 이벤트 발생 시 신호
-    void accelerometerDataChanged(const AccelerometerData &data);
-    // 장치 연결 해제 신호
-    void deviceDisconnected();
-
-protected:
-    // 스레드 실행 함수
-    void run() override;
-    
-private:
-    // 가속도 센서 디바이스 파일 경로 찾기
-    QString findAccelerometerDevice();
-    
-    QString devicePath;
-    bool stopRequested;
-    QMutex mutex;
-    
-    // 현재 가속도 데이터
-    AccelerometerData currentData;
-};
-
+// 가속도 센서 (InputHub 스레드가 장치를 epoll로 기다려 SYN_REPORT마다 한 샘플씩 전달)
 class Accelerometer : public QObject
 {
     Q_OBJECT
@@ -84,7 +46,11 @@ private slots:
     void handleDeviceDisconnected();
 
 private:
-    AccelerometerReaderThread *readerThread;  // 센서 읽기 스레드
+    // 가속도 센서 디바이스 파일 경로 찾기
+    QString findAccelerometerDevice();
+    void release();
+
+    int deviceId;                             // InputHub 장치 id (-1이면 미등록)
     bool initialized;                         // 초기화 상태
     AccelerometerData currentData;            // 최신 가속도 데이터
 };
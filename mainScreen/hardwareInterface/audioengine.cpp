@@ -0,0 +1,616 @@
+#include "audioengine.h"
+#include "utils/audiomixer.h"
+#include <QDebug>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <sched.h>
+#include <time.h>
+
+namespace {
+// 믹싱 스레드 실시간 우선순위 (권한이 없으면 일반 스케줄링으로 계속)
+const int REALTIME_PRIORITY = 50;
+
+// 장치가 이 시간 안에 빈 자리를 만들지 않으면 멈춘 것으로 보고 복구
+const int WAIT_TIMEOUT_MS = 500;
+
+qint64 monotonicUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (qint64)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+int environmentInt(const char *name, int defaultValue, int minValue, int maxValue)
+{
+    QByteArray value = qgetenv(name);
+    if (value.isEmpty())
+        return defaultValue;
+
+    bool ok = false;
+    int number = value.toInt(&ok);
+    return ok ? qBound(minValue, number, maxValue) : defaultValue;
+}
+}
+
+AudioEngine::AudioEngine() :
+    pcm(NULL),
+    rate(0),
+    channels(0),
+    mmapAccess(false),
+    periodFrames(0),
+    bufferFrames(0),
+    running(false),
+    stopRequested(false),
+    wakeFd(-1),
+    deviceIdle(true),
+    pendingEffects(0),
+    pendingQueuedSum(0),
+    pendingQueuedMin(0),
+    periodsWritten(0),
+    xruns(0),
+    droppedCommands(0),
+    stolenVoices(0),
+    lastDelayUs(0),
+    maxDelayUs(0),
+    effectsStarted(0),
+    lastEffectLatencyUs(0),
+    totalEffectLatencyUs(0),
+    maxEffectLatencyUs(0)
+{
+}
+
+AudioEngine::~AudioEngine()
+{
+    stop();
+}
+
+bool AudioEngine::configure(snd_pcm_t *device, unsigned int requestedRate, unsigned int requestedChannels)
+{
+    if (!device || isRunning())
+        return false;
+
+    snd_pcm_hw_params_t *params;
+    snd_pcm_hw_params_alloca(&params);
+
+    unsigned int exactRate = requestedRate;
+    unsigned int exactChannels = requestedChannels;
+    snd_pcm_uframes_t period = environmentInt("COLORBINGO_AUDIO_PERIOD", DEFAULT_PERIOD_FRAMES, 32, 8192);
+    snd_pcm_uframes_t buffer = period * environmentInt("COLORBINGO_AUDIO_PERIODS", DEFAULT_PERIOD_COUNT, 2, 16);
+    bool useMmap = qgetenv("COLORBINGO_AUDIO_MMAP") != "0";
+
+    int err = snd_pcm_hw_params_any(device, params);
+    // 장치 버퍼에 직접 믹싱 (지원하지 않는 장치/플러그인이면 writei)
+    if (err >= 0 && useMmap) {
+        if (snd_pcm_hw_params_set_access(device, params, SND_PCM_ACCESS_MMAP_INTERLEAVED) < 0) {
+            qDebug() << "AudioEngine: MMAP_INTERLEAVED not supported, using writei";
+            useMmap = false;
+        }
+    }
+    if (err >= 0 && !useMmap)
+        err = snd_pcm_hw_params_set_access(device, params, SND_PCM_ACCESS_RW_INTERLEAVED);
+    if (err >= 0)
+        err = snd_pcm_hw_params_set_format(device, params, SND_PCM_FORMAT_S16_LE);
+    if (err >= 0)
+        err = snd_pcm_hw_params_set_channels_near(device, params, &exactChannels);
+    if (err >= 0)
+        err = snd_pcm_hw_params_set_rate_near(device, params, &exactRate, 0);
+    if (err >= 0)
+        err = snd_pcm_hw_params_set_period_size_near(device, params, &period, 0);
+    if (err >= 0)
+        err = snd_pcm_hw_params_set_buffer_size_near(device, params, &buffer);
+    if (err >= 0)
+        err = snd_pcm_hw_params(device, params);
+    if (err >= 0)
+        err = snd_pcm_get_params(device, &buffer, &period);
+    if (err < 0) {
+        qDebug() << "AudioEngine: cannot configure PCM:" << snd_strerror(err);
+        return false;
+    }
+
+    // writei는 첫 주기를 쓰면 바로 시작 (mmap은 writePeriodMmap에서 직접 시작), 주기 하나가 비면 깨어남
+    snd_pcm_sw_params_t *swparams;
+    snd_pcm_sw_params_alloca(&swparams);
+    snd_pcm_sw_params_current(device, swparams);
+    snd_pcm_sw_params_set_start_threshold(device, swparams, period);
+    snd_pcm_sw_params_set_avail_min(device, swparams, period);
+    err = snd_pcm_sw_params(device, swparams);
+    if (err < 0) {
+        qDebug() << "AudioEngine: cannot set software parameters:" << snd_strerror(err);
+    }
+
+    pcm = device;
+    rate = exactRate;
+    channels = exactChannels;
+    mmapAccess = useMmap;
+    periodFrames = (int)period;
+    bufferFrames = (int)buffer;
+
+    qDebug() << "AudioEngine:" << (mmapAccess ? "mmap" : "writei") << "S16_LE" << rate << "Hz" << channels << "ch, period" << periodFrames
+             << "frames, buffer" << bufferFrames << "frames ("
+             << (bufferFrames * 1000.0 / rate) << "ms buffered)";
+    return true;
+}
+
+bool AudioEngine::start()
+{
+    if (!pcm || isRunning())
+        return false;
+
+    wakeFd = eventfd(0, EFD_CLOEXEC);
+    if (wakeFd == -1) {
+        qDebug() << "AudioEngine: eventfd error:" << strerror(errno);
+        return false;
+    }
+
+    // 커널 선택 로그는 오디오 스레드 밖에서
+    AudioMixer::kernelName();
+
+    // 스트리밍 음성의 블록 버퍼 (오디오 스레드에서는 할당하지 않음)
+    Voice *voices[MAX_EFFECT_VOICES + 1];
+    voices[0] = &music;
+    for (int i = 0; i < MAX_EFFECT_VOICES; i++) {
+        voices[i + 1] = &effects[i];
+    }
+    for (int v = 0; v < MAX_EFFECT_VOICES + 1; v++) {
+        if (!voices[v]->blockBuffer) {
+            voices[v]->blockBuffer = static_cast<qint16*>(qMallocAligned(
+                    (size_t)ImaAdpcm::MAX_BLOCK_FRAMES * channels * sizeof(qint16), SoundBank::ALIGNMENT));
+        }
+        if (!voices[v]->blockBuffer) {
+            qDebug() << "AudioEngine: cannot allocate voice block buffer";
+            return false;
+        }
+    }
+
+    stopRequested = false;
+    running = true;
+    if (pthread_create(&thread, NULL, threadFunc, this) != 0) {
+        qDebug() << "AudioEngine: failed to create mixer thread";
+        running = false;
+        close(wakeFd);
+        wakeFd = -1;
+        return false;
+    }
+    return true;
+}
+
+void AudioEngine::stop()
+{
+    if (isRunning()) {
+        stopRequested = true;
+        uint64_t one = 1;
+        if (write(wakeFd, &one, sizeof(one)) == -1) {
+            qDebug() << "AudioEngine: eventfd write error:" << strerror(errno);
+        }
+        pthread_join(thread, NULL);
+        running = false;
+
+        Stats stats = getStats();
+        qDebug() << "AudioEngine: stopped - periods" << stats.periodsWritten << "xruns" << stats.xruns
+                 << "dropped commands" << stats.droppedCommands << "stolen voices" << stats.stolenVoices;
+        qDebug() << "AudioEngine: output delay last" << stats.lastDelayUs / 1000.0 << "ms max" << stats.maxDelayUs / 1000.0
+                 << "ms, effect latency avg" << stats.avgEffectLatencyUs / 1000.0 << "ms max"
+                 << stats.maxEffectLatencyUs / 1000.0 << "ms over" << stats.effectsStarted << "effects";
+    }
+
+    if (wakeFd != -1) {
+        close(wakeFd);
+        wakeFd = -1;
+    }
+    if (pcm) {
+        snd_pcm_drop(pcm);
+        snd_pcm_close(pcm);
+        pcm = NULL;
+    }
+
+    music.active = false;
+    qFreeAligned(music.blockBuffer);
+    music.blockBuffer = NULL;
+    for (int i = 0; i < MAX_EFFECT_VOICES; i++) {
+        effects[i].active = false;
+        qFreeAligned(effects[i].blockBuffer);
+        effects[i].blockBuffer = NULL;
+    }
+}
+
+bool AudioEngine::sendCommand(CommandType type, const SoundBank::Sample &sample, int gain)
+{
+    if (!isRunning())
+        return false;
+
+    Command command = { type, sample, gain, monotonicUs() };
+    if (!commands.push(command)) {
+        droppedCommands.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // 유휴 상태로 잠든 스레드 깨우기 (재생 중이면 카운터만 쌓였다가 한 번에 소비됨)
+    uint64_t one = 1;
+    if (write(wakeFd, &one, sizeof(one)) == -1) {
+        qDebug() << "AudioEngine: eventfd write error:" << strerror(errno);
+    }
+    return true;
+}
+
+bool AudioEngine::playEffect(const SoundBank::Sample &sample, int gain)
+{
+    if (!sample.isValid() || sample.channels != (int)channels)
+        return false;
+    return sendCommand(COMMAND_PLAY_EFFECT, sample, gain);
+}
+
+bool AudioEngine::playMusic(const SoundBank::Sample &sample, int gain)
+{
+    if (!sample.isValid() || sample.channels != (int)channels)
+        return false;
+    return sendCommand(COMMAND_PLAY_MUSIC, sample, gain);
+}
+
+bool AudioEngine::stopMusic()
+{
+    return sendCommand(COMMAND_STOP_MUSIC, SoundBank::Sample(), 0);
+}
+
+bool AudioEngine::setMusicGain(int gain)
+{
+    return sendCommand(COMMAND_MUSIC_GAIN, SoundBank::Sample(), gain);
+}
+
+AudioEngine::Stats AudioEngine::getStats() const
+{
+    Stats stats;
+    stats.rate = rate;
+    stats.channels = channels;
+    stats.periodFrames = periodFrames;
+    stats.bufferFrames = bufferFrames;
+    stats.periodsWritten = periodsWritten.load(std::memory_order_relaxed);
+    stats.xruns = xruns.load(std::memory_order_relaxed);
+    stats.droppedCommands = droppedCommands.load(std::memory_order_relaxed);
+    stats.stolenVoices = stolenVoices.load(std::memory_order_relaxed);
+    stats.mmapAccess = mmapAccess;
+    stats.lastDelayUs = lastDelayUs.load(std::memory_order_relaxed);
+    stats.maxDelayUs = maxDelayUs.load(std::memory_order_relaxed);
+    stats.effectsStarted = effectsStarted.load(std::memory_order_relaxed);
+    stats.lastEffectLatencyUs = lastEffectLatencyUs.load(std::memory_order_relaxed);
+    stats.maxEffectLatencyUs = maxEffectLatencyUs.load(std::memory_order_relaxed);
+    stats.avgEffectLatencyUs = stats.effectsStarted > 0
+            ? totalEffectLatencyUs.load(std::memory_order_relaxed) / (qint64)stats.effectsStarted : 0;
+    return stats;
+}
+
+void AudioEngine::startVoice(Voice &voice, const SoundBank::Sample &sample, int gain, bool loop)
+{
+    voice.data = sample.data;
+    voice.adpcm = sample.adpcm;
+    voice.blockFrames = 0;
+    voice.blockPosition = 0;
+    voice.frames = sample.frames;
+    voice.position = 0;
+    voice.gain = gain;
+    voice.loop = loop;
+    voice.active = true;
+}
+
+void AudioEngine::applyCommands()
+{
+    Command command;
+    while (commands.pop(command)) {
+        switch (command.type) {
+        case COMMAND_PLAY_EFFECT: {
+            // 빈 음성, 없으면 남은 프레임이 가장 적은(곧 끝날) 효과음을 대체
+            // (길이가 다른 효과음끼리는 진행 위치만으로 남은 시간을 알 수 없음)
+            Voice *target = NULL;
+            for (int i = 0; i < MAX_EFFECT_VOICES; i++) {
+                if (!effects[i].active) {
+                    target = &effects[i];
+                    break;
+                }
+                if (!target || effects[i].frames - effects[i].position < target->frames - target->position)
+                    target = &effects[i];
+            }
+            if (target->active)
+                stolenVoices.fetch_add(1, std::memory_order_relaxed);
+            startVoice(*target, command.sample, command.gain, false);
+
+            if (pendingEffects == 0 || command.queuedUs < pendingQueuedMin)
+                pendingQueuedMin = command.queuedUs;
+            pendingQueuedSum += command.queuedUs;
+            pendingEffects++;
+            break;
+        }
+        case COMMAND_PLAY_MUSIC:
+            startVoice(music, command.sample, command.gain, true);
+            break;
+        case COMMAND_STOP_MUSIC:
+            music.active = false;
+            break;
+        case COMMAND_MUSIC_GAIN:
+            music.gain = command.gain;
+            break;
+        }
+    }
+}
+
+bool AudioEngine::hasActiveVoices() const
+{
+    if (music.active)
+        return true;
+    for (int i = 0; i < MAX_EFFECT_VOICES; i++) {
+        if (effects[i].active)
+            return true;
+    }
+    return false;
+}
+
+const qint16 *AudioEngine::nextChunk(Voice &voice, int &available)
+{
+    if (voice.data) {
+        available = voice.frames - voice.position;
+        return voice.data + voice.position * channels;
+    }
+
+    // 스트리밍: 현재 블록을 다 썼으면 다음 블록 디코드 (블록 경계와 위치가 항상 맞음)
+    if (voice.blockPosition >= voice.blockFrames) {
+        voice.blockFrames = ImaAdpcm::decodeBlock(voice.adpcm, voice.position / voice.adpcm.framesPerBlock,
+                                                  voice.blockBuffer, channels);
+        voice.blockPosition = 0;
+    }
+    available = qMin(voice.blockFrames - voice.blockPosition, voice.frames - voice.position);
+    return voice.blockBuffer + voice.blockPosition * channels;
+}
+
+void AudioEngine::mixPeriod(qint16 *out, int frames)
+{
+    memset(out, 0, (size_t)frames * channels * sizeof(qint16));
+
+    Voice *voices[MAX_EFFECT_VOICES + 1];
+    int count = 0;
+    voices[count++] = &music;
+    for (int i = 0; i < MAX_EFFECT_VOICES; i++) {
+        voices[count++] = &effects[i];
+    }
+
+    for (int v = 0; v < count; v++) {
+        Voice &voice = *voices[v];
+        if (!voice.active)
+            continue;
+
+        // 반복 음성은 끝에 닿으면 처음부터 이어서 채움
+        int done = 0;
+        while (done < frames && voice.active) {
+            int available = 0;
+            const qint16 *src = nextChunk(voice, available);
+            if (available <= 0) {
+                // 손상된 블록: 더 진행할 수 없으므로 음성 종료
+                voice.active = false;
+                break;
+            }
+
+            int n = qMin(frames - done, available);
+            if (voice.gain > 0) {
+                AudioMixer::mix(out + done * channels, src, n * channels, voice.gain);
+            }
+            done += n;
+            voice.position += n;
+            voice.blockPosition += n;
+            if (voice.position >= voice.frames) {
+                if (voice.loop) {
+                    voice.position = 0;
+                    voice.blockFrames = 0;
+                    voice.blockPosition = 0;
+                } else {
+                    voice.active = false;
+                }
+            }
+        }
+    }
+}
+
+bool AudioEngine::recover(int err)
+{
+    if (err == -EPIPE || err == -ESTRPIPE)
+        xruns.fetch_add(1, std::memory_order_relaxed);
+
+    err = snd_pcm_recover(pcm, err, 1);
+    if (err < 0) {
+        qDebug() << "AudioEngine: recovery failed:" << snd_strerror(err);
+        return false;
+    }
+    return true;
+}
+
+bool AudioEngine::waitForSpace()
+{
+    // 장치 버퍼에 주기 하나가 들어갈 자리가 생길 때까지 대기 (명령은 그 다음에 꺼냄)
+    while (!stopRequested.load(std::memory_order_acquire)) {
+        snd_pcm_sframes_t avail = snd_pcm_avail_update(pcm);
+        if (avail < 0) {
+            if (!recover((int)avail))
+                return false;
+            continue;
+        }
+        if (avail >= periodFrames)
+            return true;
+
+        int err = snd_pcm_wait(pcm, WAIT_TIMEOUT_MS);
+        if (err == 0) {
+            qDebug() << "AudioEngine: device stalled, restarting stream";
+            err = -EPIPE;
+        }
+        if (err < 0 && !recover(err))
+            return false;
+    }
+    return false;
+}
+
+bool AudioEngine::writePeriodMmap(int frames)
+{
+    // 장치 버퍼 링의 끝에서 나뉠 수 있으므로 받은 만큼씩 직접 믹싱
+    while (frames > 0) {
+        const snd_pcm_channel_area_t *areas;
+        snd_pcm_uframes_t offset;
+        snd_pcm_uframes_t count = frames;
+        int err = snd_pcm_mmap_begin(pcm, &areas, &offset, &count);
+        if (err < 0) {
+            if (!recover(err))
+                return false;
+            continue;
+        }
+
+        qint16 *out = reinterpret_cast<qint16*>(static_cast<char*>(areas[0].addr)
+                                                + areas[0].first / 8 + offset * areas[0].step / 8);
+        mixPeriod(out, (int)count);
+
+        snd_pcm_sframes_t committed = snd_pcm_mmap_commit(pcm, offset, count);
+        if (committed < 0 || (snd_pcm_uframes_t)committed != count) {
+            if (!recover(committed < 0 ? (int)committed : -EPIPE))
+                return false;
+        }
+        frames -= (int)count;
+    }
+
+    // mmap 전송은 자동 시작되지 않으므로 첫 주기(또는 xrun 복구 후)에 직접 시작
+    if (snd_pcm_state(pcm) == SND_PCM_STATE_PREPARED) {
+        int err = snd_pcm_start(pcm);
+        if (err < 0 && !recover(err))
+            return false;
+    }
+
+    periodsWritten.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool AudioEngine::writePeriodRw(qint16 *buffer, int frames)
+{
+    mixPeriod(buffer, frames);
+
+    while (frames > 0) {
+        snd_pcm_sframes_t written = snd_pcm_writei(pcm, buffer, frames);
+        if (written < 0) {
+            if (!recover((int)written))
+                return false;
+            continue;
+        }
+        buffer += written * channels;
+        frames -= (int)written;
+    }
+    periodsWritten.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void AudioEngine::measureLatency()
+{
+    snd_pcm_sframes_t delay = 0;
+    if (snd_pcm_delay(pcm, &delay) < 0)
+        return;
+
+    qint64 now = monotonicUs();
+    qint64 delayUs = (qint64)delay * 1000000 / rate;
+    lastDelayUs.store(delayUs, std::memory_order_relaxed);
+    if (delayUs > maxDelayUs.load(std::memory_order_relaxed))
+        maxDelayUs.store(delayUs, std::memory_order_relaxed);
+
+    if (pendingEffects == 0)
+        return;
+
+    // 방금 쓴 주기의 첫 샘플은 대기 중인 프레임 중 주기 하나를 뺀 만큼 뒤에 출력된다
+    qint64 heardUs = now + (qint64)qMax(0L, (long)delay - periodFrames) * 1000000 / rate;
+    qint64 latency = heardUs - pendingQueuedMin;
+    lastEffectLatencyUs.store(latency, std::memory_order_relaxed);
+    if (latency > maxEffectLatencyUs.load(std::memory_order_relaxed))
+        maxEffectLatencyUs.store(latency, std::memory_order_relaxed);
+    totalEffectLatencyUs.fetch_add(heardUs * pendingEffects - pendingQueuedSum, std::memory_order_relaxed);
+    effectsStarted.fetch_add(pendingEffects, std::memory_order_relaxed);
+
+    pendingEffects = 0;
+    pendingQueuedSum = 0;
+}
+
+void AudioEngine::waitForCommand()
+{
+    uint64_t value;
+    if (read(wakeFd, &value, sizeof(value)) == -1 && errno != EINTR) {
+        qDebug() << "AudioEngine: eventfd read error:" << strerror(errno);
+    }
+}
+
+void* AudioEngine::threadFunc(void *arg)
+{
+    static_cast<AudioEngine*>(arg)->run();
+    return NULL;
+}
+
+void AudioEngine::run()
+{
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = REALTIME_PRIORITY;
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+        qDebug() << "AudioEngine: SCHED_FIFO not permitted, using normal priority";
+    }
+
+    // writei 경로용 믹싱 버퍼 (mmap이면 장치 버퍼에 직접 믹싱)
+    qint16 *buffer = NULL;
+    if (!mmapAccess) {
+        buffer = static_cast<qint16*>(qMallocAligned((size_t)periodFrames * channels * sizeof(qint16),
+                                                     SoundBank::ALIGNMENT));
+        if (!buffer) {
+            qDebug() << "AudioEngine: cannot allocate mix buffer";
+            return;
+        }
+    }
+
+    // 마지막 음성이 끝난 뒤 장치 버퍼에 남은 소리가 다 나갈 때까지 무음을 채운 다음 멈춤
+    int silentPeriods = 0;
+    int drainPeriods = (bufferFrames + periodFrames - 1) / periodFrames;
+    deviceIdle = true;
+
+    while (!stopRequested.load(std::memory_order_acquire)) {
+        // 재생 중에는 빈 자리가 생긴 뒤에 명령을 꺼내 새 효과음이 가능한 한 빨리 들리게 함
+        bool ok = deviceIdle || waitForSpace();
+
+        if (ok) {
+            applyCommands();
+
+            if (!hasActiveVoices()) {
+                if (deviceIdle || silentPeriods >= drainPeriods) {
+                    if (!deviceIdle) {
+                        snd_pcm_drop(pcm);
+                        deviceIdle = true;
+                    }
+                    waitForCommand();
+                    continue;
+                }
+                silentPeriods++;
+            } else {
+                silentPeriods = 0;
+                if (deviceIdle) {
+                    snd_pcm_prepare(pcm);
+                    deviceIdle = false;
+                }
+            }
+
+            ok = mmapAccess ? writePeriodMmap(periodFrames) : writePeriodRw(buffer, periodFrames);
+        }
+
+        if (ok) {
+            measureLatency();
+        } else if (!stopRequested.load(std::memory_order_acquire)) {
+            // 복구할 수 없는 오류: 재생 중인 소리를 버리고 다음 명령까지 대기
+            qDebug() << "AudioEngine: device error, stopping all voices";
+            snd_pcm_drop(pcm);
+            deviceIdle = true;
+            music.active = false;
+            for (int i = 0; i < MAX_EFFECT_VOICES; i++) {
+                effects[i].active = false;
+            }
+            pendingEffects = 0;
+            pendingQueuedSum = 0;
+        }
+    }
+
+    if (buffer)
+        qFreeAligned(buffer);
+}
@@ -0,0 +1,155 @@
+#ifndef AUDIOENGINE_H
+#define AUDIOENGINE_H
+
+#include <alsa/asoundlib.h>
+#include <pthread.h>
+#include <atomic>
+#include "utils/soundbank.h"
+#include "utils/spscqueue.h"
+
+// 단일 실시간 오디오 엔진
+// PCM 핸들 하나를 소유한 오래 사는 스레드가 배경음악 1음성 + 효과음 MAX_EFFECT_VOICES 음성을
+// 고정 크기 주기(period) 단위로 믹싱해 장치에 쓴다. IMA-ADPCM 샘플은 음성마다 블록 하나
+// (최대 ImaAdpcm::MAX_BLOCK_FRAMES) 크기의 버퍼에 필요할 때 디코드하며 믹싱한다. 효과음마다 스레드를 만들거나
+// 장치를 여닫지 않으므로 효과음이 겹치거나 배경음악이 재생 중이어도 장치 경합이 없다.
+//
+// 명령(재생/정지/볼륨)은 잠금 없는 SPSC 큐로 전달된다. 생산자는 GUI 스레드 하나로 가정한다.
+// 재생할 때는 아무 음성도 없으면 장치를 멈추고 eventfd에서 잠들어 유휴 CPU가 0이다.
+//
+// 저지연 설정: 기본 256 프레임 x 3 주기 (44.1kHz에서 버퍼 약 17ms)
+// 장치 버퍼에 주기 하나만큼 빈 자리가 생길 때까지 기다린 뒤에 명령을 꺼내 믹싱하므로
+// 효과음은 대기 중인 버퍼만큼만 늦게 들린다. 가능하면 MMAP_INTERLEAVED로 장치 버퍼에
+// 직접 믹싱하고(복사 없음), 안 되면 RW_INTERLEAVED writei로 대체한다.
+// 언더런(xrun)과 suspend는 snd_pcm_recover로 복구하고 횟수를 통계에 남긴다.
+//
+// COLORBINGO_AUDIO_PERIOD=<프레임>    주기 크기 (기본 256)
+// COLORBINGO_AUDIO_PERIODS=<개수>     버퍼의 주기 수 (기본 3)
+// COLORBINGO_AUDIO_MMAP=0             mmap 접근 비활성 (writei 사용)
+class AudioEngine
+{
+public:
+    static const int MAX_EFFECT_VOICES = 8;
+    static const int DEFAULT_PERIOD_FRAMES = 256;
+    static const int DEFAULT_PERIOD_COUNT = 3;
+
+    struct Stats {
+        unsigned int rate;
+        unsigned int channels;
+        bool mmapAccess;            // MMAP_INTERLEAVED 사용 중 (아니면 writei)
+        int periodFrames;           // 실제 협상된 주기/버퍼 크기
+        int bufferFrames;
+        quint64 periodsWritten;
+        quint64 xruns;              // 언더런/suspend 복구 횟수
+        quint64 droppedCommands;    // 큐가 가득 차 버려진 명령
+        quint64 stolenVoices;       // 빈 음성이 없어 가장 오래된 효과음을 대체한 횟수
+        qint64 lastDelayUs;         // 마지막 주기를 쓴 직후 snd_pcm_delay (출력 대기 시간)
+        qint64 maxDelayUs;
+        quint64 effectsStarted;     // 이하 효과음 요청(playEffect)부터 첫 샘플이 출력될 때까지
+        qint64 lastEffectLatencyUs;
+        qint64 avgEffectLatencyUs;
+        qint64 maxEffectLatencyUs;
+    };
+
+    AudioEngine();
+    ~AudioEngine();
+
+    // 열린 PCM으로 하드웨어 파라미터를 설정 (S16 인터리브, 레이트/채널은 가까운 값으로 협상)
+    // 성공하면 PCM 소유권을 가져가며 outputRate/outputChannels로 실제 포맷 확인
+    bool configure(snd_pcm_t *pcm, unsigned int rate, unsigned int channels);
+    unsigned int outputRate() const { return rate; }
+    unsigned int outputChannels() const { return channels; }
+
+    // 믹싱 스레드 시작/종료 (stop은 PCM도 닫음)
+    bool start();
+    void stop();
+    bool isRunning() const { return running.load(std::memory_order_acquire); }
+
+    // GUI 스레드: 명령 전달 (게인은 AudioMixer Q12)
+    bool playEffect(const SoundBank::Sample &sample, int gain);
+    bool playMusic(const SoundBank::Sample &sample, int gain);
+    bool stopMusic();
+    bool setMusicGain(int gain);
+
+    Stats getStats() const;
+
+private:
+    enum CommandType {
+        COMMAND_PLAY_EFFECT,
+        COMMAND_PLAY_MUSIC,
+        COMMAND_STOP_MUSIC,
+        COMMAND_MUSIC_GAIN
+    };
+
+    struct Command {
+        CommandType type;
+        SoundBank::Sample sample;
+        int gain;
+        qint64 queuedUs;            // 요청 시각 (CLOCK_MONOTONIC)
+    };
+
+    struct Voice {
+        const qint16 *data;         // 디코드된 PCM
+        ImaAdpcm::Layout adpcm;     // 스트리밍 음성이면 블록 배열
+        qint16 *blockBuffer;        // 스트리밍 음성의 현재 블록 디코드 결과 (start에서 할당)
+        int blockFrames;
+        int blockPosition;
+        int frames;
+        int position;
+        int gain;
+        bool loop;
+        bool active;
+
+        Voice() : data(NULL), blockBuffer(NULL), blockFrames(0), blockPosition(0),
+                  frames(0), position(0), gain(0), loop(false), active(false) {}
+    };
+
+    bool sendCommand(CommandType type, const SoundBank::Sample &sample, int gain);
+    void applyCommands();
+    void startVoice(Voice &voice, const SoundBank::Sample &sample, int gain, bool loop);
+    bool hasActiveVoices() const;
+    const qint16 *nextChunk(Voice &voice, int &available);
+    void mixPeriod(qint16 *out, int frames);
+    bool recover(int err);
+    bool waitForSpace();
+    bool writePeriodMmap(int frames);
+    bool writePeriodRw(qint16 *buffer, int frames);
+    void measureLatency();
+    void waitForCommand();
+    static void* threadFunc(void *arg);
+    void run();
+
+    snd_pcm_t *pcm;
+    unsigned int rate;
+    unsigned int channels;
+    bool mmapAccess;
+    int periodFrames;
+    int bufferFrames;
+
+    pthread_t thread;
+    std::atomic<bool> running;
+    std::atomic<bool> stopRequested;
+    int wakeFd;                         // 유휴 상태의 스레드를 깨우는 eventfd
+
+    SpscQueue<Command, 64> commands;
+
+    // 이하 오디오 스레드 전용
+    Voice music;
+    Voice effects[MAX_EFFECT_VOICES];
+    bool deviceIdle;
+    int pendingEffects;                 // 이번 주기에 시작된 효과음 (지연 측정용)
+    qint64 pendingQueuedSum;
+    qint64 pendingQueuedMin;
+
+    std::atomic<quint64> periodsWritten;
+    std::atomic<quint64> xruns;
+    std::atomic<quint64> droppedCommands;
+    std::atomic<quint64> stolenVoices;
+    std::atomic<qint64> lastDelayUs;
+    std::atomic<qint64> maxDelayUs;
+    std::atomic<quint64> effectsStarted;
+    std::atomic<qint64> lastEffectLatencyUs;
+    std::atomic<qint64> totalEffectLatencyUs;
+    std::atomic<qint64> maxEffectLatencyUs;
+};
+
+#endif // AUDIOENGINE_H
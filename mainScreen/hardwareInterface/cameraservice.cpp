@@ -0,0 +1,100 @@
+#include "hardwareInterface/cameraservice.h"
+#include <QDebug>
+
+CameraService* CameraService::instance = nullptr;
+
+CameraService* CameraService::getInstance()
+{
+    if (instance == nullptr) {
+        instance = new CameraService();
+    }
+    return instance;
+}
+
+CameraService::CameraService() :
+    QObject(nullptr),
+    camera(new V4L2Camera(this))
+{
+}
+
+CameraService::~CameraService()
+{
+    cleanup();
+}
+
+void CameraService::warmUp()
+{
+    if (camera->isCameraCapturing() || camera->isOpening())
+        return;
+
+    if (subscribers.isEmpty()) {
+        camera->setConversionEnabled(false);
+    }
+    camera->startCapturingAsync();
+}
+
+bool CameraService::subscribe(QObject *subscriber)
+{
+    if (!subscriber)
+        return false;
+
+    if (subscribers.contains(subscriber))
+        return true;
+
+    subscribers.insert(subscriber);
+    connect(subscriber, &QObject::destroyed, this, &CameraService::onSubscriberDestroyed);
+
+    if (subscribers.size() == 1) {
+        camera->setConversionEnabled(true);
+    }
+
+    // 첫 구독 이후에는 스트리밍을 유지 (화면 전환마다 STREAMOFF/REQBUFS/mmap을 반복하지 않음)
+    // 아직 열리지 않았거나 이전 열기가 실패했으면 작업 스레드에서 다시 시도
+    if (!camera->isCameraCapturing() && !camera->isOpening()) {
+        camera->startCapturingAsync();
+    }
+
+    qDebug() << "CameraService: subscribed" << subscriber->metaObject()->className()
+             << "(" << subscribers.size() << "subscribers )";
+    return true;
+}
+
+void CameraService::unsubscribe(QObject *subscriber)
+{
+    if (!subscribers.contains(subscriber))
+        return;
+
+    disconnect(subscriber, &QObject::destroyed, this, &CameraService::onSubscriberDestroyed);
+
+    // 숨겨진 화면이 계속 프레임/연결 끊김 알림을 받지 않도록 연결 해제
+    disconnect(camera, nullptr, subscriber, nullptr);
+
+    qDebug() << "CameraService: unsubscribed" << subscriber->metaObject()->className();
+    releaseSubscriber(subscriber);
+}
+
+void CameraService::onSubscriberDestroyed(QObject *subscriber)
+{
+    // 파괴된 객체의 연결은 Qt가 이미 정리함
+    releaseSubscriber(subscriber);
+}
+
+void CameraService::releaseSubscriber(QObject *subscriber)
+{
+    subscribers.remove(subscriber);
+
+    if (subscribers.isEmpty()) {
+        // 장치는 계속 스트리밍하고 캡처 스레드는 버퍼만 드라이버에 돌려줌
+        camera->setConversionEnabled(false);
+        camera->getAutoMatcher()->clear();
+        qDebug() << "CameraService: no subscribers, frame conversion paused";
+    }
+}
+
+void CameraService::cleanup()
+{
+    subscribers.clear();
+    if (camera) {
+        camera->closeCamera();
+    }
+}
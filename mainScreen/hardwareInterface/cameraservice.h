@@ -0,0 +1,54 @@
+#ifndef CAMERASERVICE_H
+#define CAMERASERVICE_H
+
+#include <QObject>
+#include <QSet>
+#include "hardwareInterface/v4l2camera.h"
+
+// 프로세스 전체에서 하나의 V4L2Camera를 공유하는 서비스
+// 장치는 한 번 연 뒤 계속 스트리밍하고, 화면(구독자)이 바뀔 때는 구독만 옮긴다.
+// 구독자가 하나도 없으면 캡처 스레드는 버퍼만 돌려주고 RGB 변환/알림을 멈춘다.
+class CameraService : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 싱글톤 인스턴스 가져오기
+    static CameraService* getInstance();
+
+    // 공유 카메라 (시그널 연결과 프레임 조회용, 열기/닫기는 서비스가 관리)
+    V4L2Camera *getCamera() const { return camera; }
+
+    // 구독 전에 작업 스레드에서 장치를 미리 열고 스트리밍 시작 (변환은 첫 구독 때 재개)
+    void warmUp();
+    // 장치가 열려 스트리밍 중인지 (아니면 열기 진행 중이거나 실패, 완료는 V4L2Camera::cameraReady)
+    bool isReady() const { return camera->isCameraCapturing(); }
+
+    // 구독 등록: 첫 구독자가 생기면 변환을 재개하고, 장치가 준비되지 않았으면 비동기 열기 시작
+    // (같은 구독자의 중복 등록은 무시, 구독자가 파괴되면 자동 해제)
+    bool subscribe(QObject *subscriber);
+    // 구독 해제: 카메라에서 subscriber로 가는 시그널 연결도 함께 끊는다
+    // 마지막 구독자가 빠지면 변환만 멈추고 장치는 계속 스트리밍
+    void unsubscribe(QObject *subscriber);
+    bool isSubscribed(QObject *subscriber) const { return subscribers.contains(subscriber); }
+    int subscriberCount() const { return subscribers.size(); }
+
+    // 리소스 정리 (프로그램 종료 시 캡처 중지 및 장치 닫기)
+    void cleanup();
+
+private slots:
+    void onSubscriberDestroyed(QObject *subscriber);
+
+private:
+    CameraService();
+    ~CameraService();
+
+    void releaseSubscriber(QObject *subscriber);
+
+    V4L2Camera *camera;
+    QSet<QObject*> subscribers;
+
+    static CameraService *instance;
+};
+
+#endif // CAMERASERVICE_H
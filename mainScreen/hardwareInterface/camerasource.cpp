@@ -0,0 +1,525 @@
+#include "hardwareInterface/camerasource.h"
+#include "hardwareInterface/v4l2camera.h"
+#include "utils/framedecoder.h"
+#include <QDebug>
+#include <QStringList>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <sys/timerfd.h>
+#include <linux/videodev2.h>
+
+const char CameraRecorder::FILE_MAGIC[8] = { 'C', 'B', 'R', 'A', 'W', '0', '1', '\n' };
+
+CameraSource *CameraSource::createFromEnvironment()
+{
+    QString spec = QString::fromLocal8Bit(qgetenv("COLORBINGO_CAMERA_SOURCE"));
+    if (spec.isEmpty() || spec == "v4l2")
+        return NULL;
+
+    int colon = spec.indexOf(':');
+    QString kind = (colon == -1) ? spec : spec.left(colon);
+    QString arg = (colon == -1) ? QString() : spec.mid(colon + 1);
+
+    if (kind == "replay" || kind == "replay-fast") {
+        if (arg.isEmpty()) {
+            qDebug() << "COLORBINGO_CAMERA_SOURCE: replay needs a file path";
+            return NULL;
+        }
+        return new ReplaySource(arg, kind == "replay");
+    }
+
+    if (kind == "synthetic") {
+        QStringList parts = arg.split(':');
+        SyntheticSource::Pattern pattern = SyntheticSource::GRADIENT;
+        if (!parts.isEmpty() && !parts.at(0).isEmpty()
+                && !SyntheticSource::parsePattern(parts.at(0), pattern)) {
+            qDebug() << "COLORBINGO_CAMERA_SOURCE: unknown synthetic pattern" << parts.at(0);
+            return NULL;
+        }
+        int fps = (parts.count() > 1) ? parts.at(1).toInt() : 30;
+        return new SyntheticSource(pattern, fps > 0 ? fps : 30);
+    }
+
+    qDebug() << "COLORBINGO_CAMERA_SOURCE: unknown source" << spec;
+    return NULL;
+}
+
+// ---------------------------------------------------------------------------
+// TimedSource
+
+TimedSource::TimedSource() :
+    timerFd(-1)
+{
+}
+
+TimedSource::~TimedSource()
+{
+    if (timerFd != -1) {
+        ::close(timerFd);
+    }
+}
+
+bool TimedSource::open()
+{
+    if (timerFd != -1)
+        return true;
+
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerFd == -1) {
+        qDebug() << "timerfd_create error:" << strerror(errno);
+        return false;
+    }
+
+    if (!openSource()) {
+        ::close(timerFd);
+        timerFd = -1;
+        return false;
+    }
+    return true;
+}
+
+void TimedSource::close()
+{
+    if (timerFd == -1)
+        return;
+
+    stop();
+    closeSource();
+    ::close(timerFd);
+    timerFd = -1;
+}
+
+qint64 TimedSource::monotonicNowUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (qint64)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+bool TimedSource::scheduleAt(qint64 monotonicUs)
+{
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+
+    // 이미 지난 시각이면 즉시 만료 (it_value가 0이면 해제되므로 최소 1ns)
+    qint64 now = monotonicNowUs();
+    if (monotonicUs <= now) {
+        spec.it_value.tv_nsec = 1;
+        return timerfd_settime(timerFd, 0, &spec, NULL) == 0;
+    }
+
+    spec.it_value.tv_sec = monotonicUs / 1000000;
+    spec.it_value.tv_nsec = (monotonicUs % 1000000) * 1000;
+    return timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &spec, NULL) == 0;
+}
+
+bool TimedSource::schedulePeriodic(qint64 intervalUs)
+{
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.it_interval.tv_sec = intervalUs / 1000000;
+    spec.it_interval.tv_nsec = (intervalUs % 1000000) * 1000;
+    spec.it_value = spec.it_interval;
+    return timerfd_settime(timerFd, 0, &spec, NULL) == 0;
+}
+
+quint64 TimedSource::consumeExpirations()
+{
+    quint64 expirations = 0;
+    if (read(timerFd, &expirations, sizeof(expirations)) != sizeof(expirations))
+        return 0;
+    return expirations;
+}
+
+// ---------------------------------------------------------------------------
+// ReplaySource
+
+ReplaySource::ReplaySource(const QString &path, bool realtime) :
+    filePath(path),
+    realtime(realtime),
+    frameSequence(0),
+    frameTimestampUs(0),
+    firstTimestampUs(0),
+    playbackStartUs(0),
+    haveFrame(false)
+{
+    memset(&sourceFormat, 0, sizeof(sourceFormat));
+}
+
+QString ReplaySource::description() const
+{
+    return QString("replay:%1%2").arg(filePath).arg(realtime ? "" : " (fast)");
+}
+
+bool ReplaySource::openSource()
+{
+    file.setFileName(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "Cannot open camera recording" << filePath << ":" << file.errorString();
+        return false;
+    }
+
+    if (!rewind() || !readNextFrame()) {
+        qDebug() << "Camera recording is empty or invalid:" << filePath;
+        file.close();
+        return false;
+    }
+
+    // 첫 프레임의 포맷을 재생 포맷으로 사용
+    qDebug() << "Replaying camera recording" << filePath << sourceFormat.width << "x" << sourceFormat.height;
+    return true;
+}
+
+void ReplaySource::closeSource()
+{
+    file.close();
+    haveFrame = false;
+}
+
+bool ReplaySource::rewind()
+{
+    char magic[sizeof(CameraRecorder::FILE_MAGIC)];
+    if (!file.seek(0) || file.read(magic, sizeof(magic)) != (qint64)sizeof(magic)
+            || memcmp(magic, CameraRecorder::FILE_MAGIC, sizeof(magic)) != 0) {
+        return false;
+    }
+    return true;
+}
+
+static const quint32 MAX_REPLAY_DIMENSION = 8192;
+static const qint64 MAX_COMPRESSED_FRAME_SIZE = 16 * 1024 * 1024;
+
+// 헤더의 포맷으로 가능한 최대 프레임 크기 (헤더 자체가 말이 안 되면 0)
+static qint64 maxFrameSize(const CameraRecorder::RecordHeader &header)
+{
+    if (header.width == 0 || header.height == 0
+            || header.width > MAX_REPLAY_DIMENSION || header.height > MAX_REPLAY_DIMENSION) {
+        return 0;
+    }
+
+    // 압축 포맷(MJPEG 등)은 행 간격이 없으므로 고정 상한
+    quint32 minimum = FrameDecoder::minBytesPerLine(header.pixelFormat, header.width);
+    if (minimum == 0)
+        return MAX_COMPRESSED_FRAME_SIZE;
+
+    // 한 행보다 짧은 간격은 변환기가 버퍼 끝을 넘어 읽게 되므로 거부
+    if (header.bytesPerLine < minimum || header.bytesPerLine > header.width * 4)
+        return 0;
+
+    qint64 planeSize = (qint64)header.bytesPerLine * header.height;
+    return header.pixelFormat == V4L2_PIX_FMT_NV12 ? planeSize * 3 / 2 : planeSize;
+}
+
+bool ReplaySource::readNextFrame()
+{
+    CameraRecorder::RecordHeader header;
+
+    for (;;) {
+        if (file.read(reinterpret_cast<char *>(&header), sizeof(header)) != (qint64)sizeof(header))
+            return false;
+
+        if (header.magic != CameraRecorder::FRAME_MAGIC) {
+            qDebug() << "Corrupt frame header in" << filePath;
+            return false;
+        }
+
+        // 파일에 적힌 크기를 그대로 믿지 않음 (깨진 파일로 거대한 할당을 하지 않도록)
+        qint64 remaining = file.size() - file.pos();
+        qint64 limit = maxFrameSize(header);
+        if (limit == 0 || header.size > limit || header.size > remaining) {
+            qDebug() << "Invalid frame size" << header.size << "in" << filePath
+                     << "limit" << limit << "remaining" << remaining;
+            return false;
+        }
+
+        frameData.resize(header.size);
+        if (file.read(frameData.data(), header.size) != (qint64)header.size)
+            return false;
+
+        if (!haveFrame && sourceFormat.width == 0) {
+            sourceFormat.pixelFormat = header.pixelFormat;
+            sourceFormat.width = header.width;
+            sourceFormat.height = header.height;
+            sourceFormat.bytesPerLine = header.bytesPerLine;
+        } else if (header.pixelFormat != sourceFormat.pixelFormat
+                   || (int)header.width != sourceFormat.width || (int)header.height != sourceFormat.height) {
+            // 중간에 포맷이 바뀐 프레임은 건너뜀
+            continue;
+        }
+
+        frameSequence = header.sequence;
+        frameTimestampUs = header.timestampUs;
+        haveFrame = true;
+        return true;
+    }
+}
+
+bool ReplaySource::start()
+{
+    if (!isOpen())
+        return false;
+
+    // 처음부터 다시 재생
+    if (!rewind() || !readNextFrame())
+        return false;
+
+    firstTimestampUs = frameTimestampUs;
+    playbackStartUs = monotonicNowUs();
+    return scheduleAt(playbackStartUs);
+}
+
+void ReplaySource::stop()
+{
+    if (isOpen()) {
+        schedulePeriodic(0);
+    }
+}
+
+bool ReplaySource::acquire(SourceFrame &frame)
+{
+    if (!consumeExpirations() || !haveFrame)
+        return false;
+
+    frame.data = reinterpret_cast<const uchar *>(frameData.constData());
+    frame.size = frameData.size();
+    frame.sequence = frameSequence;
+    // 재생 시각 기준으로 타임스탬프를 옮겨 지연 측정이 실제 장치와 같은 의미를 갖게 함
+    frame.timestampUs = playbackStartUs + (frameTimestampUs - firstTimestampUs);
+    return true;
+}
+
+void ReplaySource::release()
+{
+    // 다음 프레임을 미리 읽고 기록된 간격에 맞춰 예약 (끝에 도달하면 처음부터 반복)
+    qint64 previousUs = playbackStartUs + (frameTimestampUs - firstTimestampUs);
+    if (!readNextFrame()) {
+        if (!rewind() || !readNextFrame()) {
+            haveFrame = false;
+            return;
+        }
+        firstTimestampUs = frameTimestampUs;
+        playbackStartUs = qMax(previousUs, monotonicNowUs());
+    }
+
+    if (realtime) {
+        scheduleAt(playbackStartUs + (frameTimestampUs - firstTimestampUs));
+    } else {
+        scheduleAt(0);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// SyntheticSource
+
+SyntheticSource::SyntheticSource(Pattern pattern, int fps) :
+    pattern(pattern),
+    fps(fps),
+    sequence(0),
+    lastSolidIndex(-1)
+{
+    sourceFormat.pixelFormat = V4L2_PIX_FMT_YUYV;
+    sourceFormat.width = 640;
+    sourceFormat.height = 480;
+    sourceFormat.bytesPerLine = sourceFormat.width * 2;
+    frameData.resize(sourceFormat.bytesPerLine * sourceFormat.height);
+}
+
+bool SyntheticSource::parsePattern(const QString &name, Pattern &pattern)
+{
+    if (name == "solid") {
+        pattern = SOLID;
+    } else if (name == "gradient") {
+        pattern = GRADIENT;
+    } else if (name == "noise") {
+        pattern = NOISE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+QString SyntheticSource::description() const
+{
+    static const char *names[] = { "solid", "gradient", "noise" };
+    return QString("synthetic:%1:%2").arg(names[pattern]).arg(fps);
+}
+
+bool SyntheticSource::start()
+{
+    if (!isOpen())
+        return false;
+
+    sequence = 0;
+    lastSolidIndex = -1;
+    return schedulePeriodic(1000000 / fps);
+}
+
+void SyntheticSource::stop()
+{
+    if (isOpen()) {
+        schedulePeriodic(0);
+    }
+}
+
+bool SyntheticSource::acquire(SourceFrame &frame)
+{
+    quint64 expirations = consumeExpirations();
+    if (!expirations)
+        return false;
+
+    // 밀린 주기는 건너뛴 프레임으로 취급 (실제 장치의 시퀀스 번호와 같은 의미)
+    sequence += (quint32)expirations;
+    generate();
+
+    frame.data = reinterpret_cast<const uchar *>(frameData.constData());
+    frame.size = frameData.size();
+    frame.sequence = sequence;
+    frame.timestampUs = monotonicNowUs();
+    return true;
+}
+
+void SyntheticSource::fillSolid(int r, int g, int b)
+{
+    // BT.601 RGB -> YUV (FrameDecoder의 역변환과 짝)
+    int y = qBound(0, (int)(0.299 * r + 0.587 * g + 0.114 * b), 255);
+    int u = qBound(0, (int)((b - y) * 0.564 + 128), 255);
+    int v = qBound(0, (int)((r - y) * 0.713 + 128), 255);
+
+    uchar *p = reinterpret_cast<uchar *>(frameData.data());
+    int pairs = frameData.size() / 4;
+    for (int i = 0; i < pairs; i++) {
+        p[0] = y;
+        p[1] = u;
+        p[2] = y;
+        p[3] = v;
+        p += 4;
+    }
+}
+
+void SyntheticSource::generate()
+{
+    uchar *data = reinterpret_cast<uchar *>(frameData.data());
+    int width = sourceFormat.width;
+    int height = sourceFormat.height;
+
+    switch (pattern) {
+    case SOLID: {
+        // 1초마다 다음 색으로 전환 (색이 바뀔 때만 다시 채움)
+        static const int palette[][3] = {
+            { 220, 40, 40 }, { 40, 200, 60 }, { 40, 80, 220 },
+            { 230, 210, 50 }, { 200, 60, 200 }, { 50, 200, 210 },
+            { 240, 140, 40 }, { 128, 128, 128 }, { 245, 245, 245 }
+        };
+        int count = sizeof(palette) / sizeof(palette[0]);
+        int index = (sequence / fps) % count;
+        if (index != lastSolidIndex) {
+            fillSolid(palette[index][0], palette[index][1], palette[index][2]);
+            lastSolidIndex = index;
+        }
+        break;
+    }
+    case GRADIENT: {
+        // 가로 밝기 램프 + 세로 색차 램프, 프레임마다 가로로 흘러감
+        int shift = sequence * 4;
+        for (int y = 0; y < height; y++) {
+            uchar *row = data + y * sourceFormat.bytesPerLine;
+            uchar u = (uchar)(y * 255 / height);
+            uchar v = (uchar)(255 - u);
+            for (int x = 0; x < width; x += 2) {
+                row[0] = (uchar)((x + shift) & 0xFF);
+                row[1] = u;
+                row[2] = (uchar)((x + 1 + shift) & 0xFF);
+                row[3] = v;
+                row += 4;
+            }
+        }
+        break;
+    }
+    case NOISE: {
+        // 시퀀스 번호로 시드를 정해 같은 프레임 번호는 항상 같은 결과 (xorshift32)
+        quint32 state = 2463534242u ^ (sequence * 2654435761u);
+        quint32 *words = reinterpret_cast<quint32 *>(data);
+        int count = frameData.size() / 4;
+        for (int i = 0; i < count; i++) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            words[i] = state;
+        }
+        break;
+    }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// CameraRecorder
+
+CameraRecorder::CameraRecorder(const QString &path) :
+    failed(false),
+    framesWritten(0)
+{
+    file.setFileName(path);
+}
+
+CameraRecorder::~CameraRecorder()
+{
+    if (file.isOpen()) {
+        file.close();
+        qDebug() << "Camera recording closed:" << file.fileName() << framesWritten << "frames";
+    }
+}
+
+CameraRecorder *CameraRecorder::createFromEnvironment()
+{
+    QString path = QString::fromLocal8Bit(qgetenv("COLORBINGO_CAMERA_RECORD"));
+    if (path.isEmpty())
+        return NULL;
+    return new CameraRecorder(path);
+}
+
+void CameraRecorder::write(const RawFrame &frame)
+{
+    if (failed)
+        return;
+
+    // 첫 프레임에서 파일 생성
+    if (!file.isOpen()) {
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+                || file.write(FILE_MAGIC, sizeof(FILE_MAGIC)) != (qint64)sizeof(FILE_MAGIC)) {
+            qDebug() << "Cannot create camera recording" << file.fileName() << ":" << file.errorString();
+            failed = true;
+            return;
+        }
+        qDebug() << "Recording camera frames to" << file.fileName();
+    }
+
+    RecordHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = FRAME_MAGIC;
+    header.pixelFormat = frame.pixelFormat;
+    header.width = frame.width;
+    header.height = frame.height;
+    header.bytesPerLine = frame.bytesPerLine;
+    header.sequence = frame.sequence;
+    header.timestampUs = frame.timestampUs;
+    header.size = frame.bytesUsed;
+
+    if (file.write(reinterpret_cast<const char *>(&header), sizeof(header)) != (qint64)sizeof(header)
+            || file.write(static_cast<const char *>(frame.data), frame.bytesUsed) != (qint64)frame.bytesUsed) {
+        qDebug() << "Camera recording write error:" << file.errorString();
+        failed = true;
+        file.close();
+        return;
+    }
+
+    framesWritten++;
+}
+
+void CameraRecorder::flush()
+{
+    if (file.isOpen()) {
+        file.flush();
+    }
+}
@@ -0,0 +1,178 @@
+#ifndef CAMERASOURCE_H
+#define CAMERASOURCE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QFile>
+
+struct RawFrame;
+
+// 프레임 공급원의 버퍼 배치 (V4L2_PIX_FMT_* 기준)
+struct SourceFormat {
+    quint32 pixelFormat;
+    int width;
+    int height;
+    int bytesPerLine;
+};
+
+// acquire()로 받은 프레임 (release() 전까지 유효)
+struct SourceFrame {
+    const uchar *data;
+    size_t size;
+    quint32 sequence;
+    qint64 timestampUs;     // CLOCK_MONOTONIC 기준 (us)
+};
+
+// 실제 V4L2 장치 대신 V4L2Camera에 프레임을 공급하는 백엔드
+// pollFd()가 읽기 가능해지면 캡처 스레드가 acquire()/release()를 호출한다.
+// 실제 장치 경로(mmap, EXPBUF, 오래된 버퍼 폐기)는 V4L2Camera 내부에 그대로 둔다.
+class CameraSource
+{
+public:
+    virtual ~CameraSource() {}
+
+    virtual bool open() = 0;
+    virtual void close() = 0;
+    virtual bool isOpen() const = 0;
+    virtual bool start() = 0;
+    virtual void stop() = 0;
+
+    virtual int pollFd() const = 0;
+    virtual SourceFormat format() const = 0;
+    virtual bool acquire(SourceFrame &frame) = 0;
+    virtual void release() {}
+
+    virtual QString description() const = 0;
+
+    // COLORBINGO_CAMERA_SOURCE 환경 변수로 백엔드 생성 (미설정이면 NULL = 실제 장치)
+    //   replay:<파일>        녹화 파일을 기록된 타임스탬프 간격으로 반복 재생
+    //   replay-fast:<파일>   녹화 파일을 대기 없이 최대 속도로 재생 (벤치마크용)
+    //   synthetic:<패턴>[:fps]  solid / gradient / noise 패턴 생성 (640x480 YUYV)
+    static CameraSource *createFromEnvironment();
+};
+
+// timerfd로 프레임 시점을 만드는 공급원 공통 부분
+class TimedSource : public CameraSource
+{
+public:
+    TimedSource();
+    ~TimedSource();
+
+    bool open() override;
+    void close() override;
+    bool isOpen() const override { return timerFd != -1; }
+    int pollFd() const override { return timerFd; }
+
+protected:
+    // 다음 프레임을 절대 시각(CLOCK_MONOTONIC, us)에 예약 (0이면 즉시)
+    bool scheduleAt(qint64 monotonicUs);
+    // 주기 타이머 설정 (0이면 해제)
+    bool schedulePeriodic(qint64 intervalUs);
+    // 만료 횟수 소비 (아직 만료되지 않았으면 0)
+    quint64 consumeExpirations();
+    static qint64 monotonicNowUs();
+
+    virtual bool openSource() { return true; }
+    virtual void closeSource() {}
+
+private:
+    int timerFd;
+};
+
+// 녹화 파일 재생
+class ReplaySource : public TimedSource
+{
+public:
+    ReplaySource(const QString &path, bool realtime);
+
+    bool start() override;
+    void stop() override;
+    SourceFormat format() const override { return sourceFormat; }
+    bool acquire(SourceFrame &frame) override;
+    void release() override;
+    QString description() const override;
+
+protected:
+    bool openSource() override;
+    void closeSource() override;
+
+private:
+    bool readNextFrame();
+    bool rewind();
+
+    QString filePath;
+    bool realtime;
+    QFile file;
+    SourceFormat sourceFormat;
+    QByteArray frameData;
+    quint32 frameSequence;
+    qint64 frameTimestampUs;    // 녹화 당시 타임스탬프
+    qint64 firstTimestampUs;    // 현재 반복 구간의 첫 프레임 타임스탬프
+    qint64 playbackStartUs;     // 현재 반복 구간의 재생 시작 시각
+    bool haveFrame;
+};
+
+// 절차적 테스트 패턴 생성
+class SyntheticSource : public TimedSource
+{
+public:
+    enum Pattern { SOLID, GRADIENT, NOISE };
+
+    SyntheticSource(Pattern pattern, int fps);
+
+    bool start() override;
+    void stop() override;
+    SourceFormat format() const override { return sourceFormat; }
+    bool acquire(SourceFrame &frame) override;
+    QString description() const override;
+
+    static bool parsePattern(const QString &name, Pattern &pattern);
+
+private:
+    void generate();
+    void fillSolid(int r, int g, int b);
+
+    Pattern pattern;
+    int fps;
+    SourceFormat sourceFormat;
+    QByteArray frameData;
+    quint32 sequence;
+    int lastSolidIndex;
+};
+
+// 캡처한 원시 프레임을 재생 가능한 파일로 기록 (COLORBINGO_CAMERA_RECORD=<파일>)
+class CameraRecorder
+{
+public:
+    explicit CameraRecorder(const QString &path);
+    ~CameraRecorder();
+
+    // 캡처 스레드에서 호출
+    void write(const RawFrame &frame);
+    void flush();
+    quint32 frameCount() const { return framesWritten; }
+
+    static CameraRecorder *createFromEnvironment();
+
+    // 파일 형식: 파일 헤더(FILE_MAGIC 8바이트) 뒤에 [RecordHeader + 데이터]가 반복
+    static const char FILE_MAGIC[8];
+    static const quint32 FRAME_MAGIC = 0x4d415246; // "FRAM"
+    struct RecordHeader {
+        quint32 magic;
+        quint32 pixelFormat;
+        quint32 width;
+        quint32 height;
+        quint32 bytesPerLine;
+        quint32 sequence;
+        qint64 timestampUs;
+        quint32 size;
+        quint32 reserved;
+    };
+
+private:
+    QFile file;
+    bool failed;
+    quint32 framesWritten;
+};
+
+#endif // CAMERASOURCE_H
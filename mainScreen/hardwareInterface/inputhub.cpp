@@ -0,0 +1,396 @@
+#include "hardwareInterface/inputhub.h"
+#include "utils/frametrace.h"
+#include <QDebug>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+
+namespace {
+// 한 번의 read로 가져오는 최대 이벤트 수 (가속도 센서 SYN_REPORT 여러 개 분량)
+const int READ_BATCH = 64;
+const int MAX_EPOLL_EVENTS = 8;
+
+// epoll data.u64: 장치 id는 1부터, 0은 종료용 eventfd
+const quint64 WAKE_ID = 0;
+
+qint64 realtimeUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (qint64)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+}
+
+InputHub* InputHub::instance = nullptr;
+
+InputHub* InputHub::getInstance()
+{
+    if (instance == nullptr) {
+        instance = new InputHub();
+    }
+    return instance;
+}
+
+InputHub::InputHub() :
+    nextId(1),
+    openDevices(0),
+    epollFd(-1),
+    wakeFd(-1),
+    threadRunning(false),
+    stopRequested(false),
+    wakeups(0),
+    events(0),
+    droppedReports(0),
+    lastLatencyUs(0),
+    maxLatencyUs(0)
+{
+}
+
+InputHub::~InputHub()
+{
+    stopThread();
+
+    QMutexLocker locker(&mutex);
+    for (QMap<int, Device>::iterator it = devices.begin(); it != devices.end(); ++it) {
+        closeDevice(it.value());
+    }
+    devices.clear();
+}
+
+int InputHub::addKeyDevice(const QString &path, KeyCallback onKey, DisconnectCallback onDisconnect)
+{
+    Device device;
+    device.kind = DEVICE_KEY;
+    device.path = path;
+    device.onKey = onKey;
+    device.onDisconnect = onDisconnect;
+    return addDevice(device);
+}
+
+int InputHub::addAbsDevice(const QString &path, AbsCallback onAbs, DisconnectCallback onDisconnect)
+{
+    Device device;
+    device.kind = DEVICE_ABS;
+    device.path = path;
+    device.onAbs = onAbs;
+    device.onDisconnect = onDisconnect;
+    return addDevice(device);
+}
+
+int InputHub::addDevice(Device &device)
+{
+    device.fd = open(device.path.toLocal8Bit().constData(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (device.fd == -1) {
+        qDebug() << "InputHub: Cannot open device" << device.path << "- Error:" << strerror(errno);
+        return -1;
+    }
+
+    // 이벤트 시각을 CLOCK_MONOTONIC으로 (커널 3.4 이전이면 CLOCK_REALTIME을 변환해서 사용)
+    int clockId = CLOCK_MONOTONIC;
+    device.clockMonotonic = ioctl(device.fd, EVIOCSCLOCKID, &clockId) == 0;
+
+    device.abs.x = 0;
+    device.abs.y = 0;
+    device.abs.z = 0;
+    device.abs.timestampUs = 0;
+    device.absChanged = false;
+    device.dropping = false;
+    if (device.kind == DEVICE_ABS) {
+        // 첫 이벤트 전에도 현재 자세를 알 수 있도록 축 값을 미리 읽음
+        syncAbs(device);
+    }
+
+    if (!threadRunning && !startThread()) {
+        close(device.fd);
+        return -1;
+    }
+
+    QMutexLocker locker(&mutex);
+    int id = nextId++;
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u64 = id;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, device.fd, &ev) == -1) {
+        qDebug() << "InputHub: epoll_ctl error for" << device.path << ":" << strerror(errno);
+        close(device.fd);
+        return -1;
+    }
+
+    devices.insert(id, device);
+    openDevices++;
+    qDebug() << "InputHub: Device" << id << "reading from" << device.path
+             << (device.kind == DEVICE_KEY ? "(keys)" : "(abs)");
+    return id;
+}
+
+void InputHub::removeDevice(int id)
+{
+    bool last = false;
+    {
+        // 허브 스레드가 디스패치 중이면 잠금을 얻을 때까지 기다리므로 반환 후에는 콜백이 없음
+        QMutexLocker locker(&mutex);
+        QMap<int, Device>::iterator it = devices.find(id);
+        if (it == devices.end())
+            return;
+        closeDevice(it.value());
+        devices.erase(it);
+        last = devices.isEmpty();
+    }
+
+    if (last) {
+        stopThread();
+    }
+}
+
+bool InputHub::isActive(int id) const
+{
+    QMutexLocker locker(&mutex);
+    QMap<int, Device>::const_iterator it = devices.constFind(id);
+    return it != devices.constEnd() && it.value().fd != -1;
+}
+
+InputHub::Stats InputHub::getStats() const
+{
+    Stats stats;
+    {
+        QMutexLocker locker(&mutex);
+        stats.devices = openDevices;
+    }
+    stats.wakeups = wakeups.load(std::memory_order_relaxed);
+    stats.events = events.load(std::memory_order_relaxed);
+    stats.droppedReports = droppedReports.load(std::memory_order_relaxed);
+    stats.lastLatencyUs = lastLatencyUs.load(std::memory_order_relaxed);
+    stats.maxLatencyUs = maxLatencyUs.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// 잠금을 잡은 상태에서 호출
+void InputHub::closeDevice(Device &device)
+{
+    if (device.fd == -1)
+        return;
+
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, device.fd, NULL);
+    close(device.fd);
+    device.fd = -1;
+    openDevices--;
+}
+
+void InputHub::syncAbs(Device &device)
+{
+    struct input_absinfo info;
+    if (ioctl(device.fd, EVIOCGABS(ABS_X), &info) == 0) device.abs.x = info.value;
+    if (ioctl(device.fd, EVIOCGABS(ABS_Y), &info) == 0) device.abs.y = info.value;
+    if (ioctl(device.fd, EVIOCGABS(ABS_Z), &info) == 0) device.abs.z = info.value;
+}
+
+qint64 InputHub::eventTimeUs(const Device &device, const input_event &ev) const
+{
+#ifdef input_event_sec
+    qint64 timestampUs = (qint64)ev.input_event_sec * 1000000 + ev.input_event_usec;
+#else
+    qint64 timestampUs = (qint64)ev.time.tv_sec * 1000000 + ev.time.tv_usec;
+#endif
+    if (device.clockMonotonic)
+        return timestampUs;
+
+    // CLOCK_REALTIME 시각을 현재 두 시계의 차이만큼 옮김
+    return timestampUs - (realtimeUs() - FrameTrace::nowUs());
+}
+
+void InputHub::recordLatency(qint64 timestampUs)
+{
+    qint64 latency = FrameTrace::nowUs() - timestampUs;
+    lastLatencyUs.store(latency, std::memory_order_relaxed);
+    if (latency > maxLatencyUs.load(std::memory_order_relaxed))
+        maxLatencyUs.store(latency, std::memory_order_relaxed);
+}
+
+void InputHub::dispatch(Device &device, const input_event &ev)
+{
+    if (ev.type == EV_SYN) {
+        if (ev.code == SYN_DROPPED) {
+            // 커널 버퍼가 넘쳐 이벤트가 빠짐: 다음 SYN_REPORT까지 버리고 축 값은 장치에서 다시 읽음
+            droppedReports.fetch_add(1, std::memory_order_relaxed);
+            device.dropping = true;
+            device.absChanged = false;
+            return;
+        }
+        if (ev.code != SYN_REPORT)
+            return;
+
+        if (device.dropping) {
+            device.dropping = false;
+            if (device.kind == DEVICE_ABS) {
+                syncAbs(device);
+                device.absChanged = true;
+            }
+        }
+
+        if (device.kind == DEVICE_ABS && device.absChanged) {
+            device.absChanged = false;
+            device.abs.timestampUs = eventTimeUs(device, ev);
+            recordLatency(device.abs.timestampUs);
+            if (device.onAbs)
+                device.onAbs(device.abs);
+        }
+        return;
+    }
+
+    if (device.dropping)
+        return;
+
+    if (device.kind == DEVICE_KEY && ev.type == EV_KEY) {
+        KeyEvent key;
+        key.code = ev.code;
+        key.value = ev.value;
+        key.timestampUs = eventTimeUs(device, ev);
+        recordLatency(key.timestampUs);
+        if (device.onKey)
+            device.onKey(key);
+    } else if (device.kind == DEVICE_ABS && ev.type == EV_ABS) {
+        switch (ev.code) {
+        case ABS_X:
+            device.abs.x = ev.value;
+            device.absChanged = true;
+            break;
+        case ABS_Y:
+            device.abs.y = ev.value;
+            device.absChanged = true;
+            break;
+        case ABS_Z:
+            device.abs.z = ev.value;
+            device.absChanged = true;
+            break;
+        }
+    }
+}
+
+// 잠금을 잡은 상태에서 호출: 쌓인 이벤트를 모두 읽어 디스패치
+void InputHub::readDevice(Device &device)
+{
+    input_event buffer[READ_BATCH];
+
+    while (device.fd != -1) {
+        ssize_t readBytes = read(device.fd, buffer, sizeof(buffer));
+        if (readBytes > 0) {
+            int count = readBytes / sizeof(input_event);
+            events.fetch_add(count, std::memory_order_relaxed);
+            for (int i = 0; i < count; i++) {
+                dispatch(device, buffer[i]);
+            }
+            if (readBytes < (ssize_t)sizeof(buffer))
+                return;
+            continue;
+        }
+
+        if (readBytes == -1 && errno == EINTR)
+            continue;
+        if (readBytes == -1 && errno == EAGAIN)
+            return;
+
+        // ENODEV 등: 장치가 분리됨
+        qDebug() << "InputHub: Error reading" << device.path << ":"
+                 << (readBytes == 0 ? "end of file" : strerror(errno));
+        closeDevice(device);
+        if (device.onDisconnect)
+            device.onDisconnect();
+        return;
+    }
+}
+
+bool InputHub::startThread()
+{
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd == -1 || wakeFd == -1) {
+        qDebug() << "InputHub: epoll/eventfd creation error:" << strerror(errno);
+        stopThread();
+        return false;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u64 = WAKE_ID;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev);
+
+    stopRequested = false;
+    if (pthread_create(&thread, NULL, threadFunc, this) != 0) {
+        qDebug() << "InputHub: Failed to create input thread";
+        stopThread();
+        return false;
+    }
+    threadRunning = true;
+    return true;
+}
+
+void InputHub::stopThread()
+{
+    if (threadRunning) {
+        stopRequested = true;
+        uint64_t one = 1;
+        if (write(wakeFd, &one, sizeof(one)) == -1) {
+            qDebug() << "InputHub: eventfd write error:" << strerror(errno);
+        }
+        pthread_join(thread, NULL);
+        threadRunning = false;
+
+        Stats stats = getStats();
+        qDebug() << "InputHub: stopped - wakeups" << stats.wakeups << "events" << stats.events
+                 << "dropped reports" << stats.droppedReports << "latency last"
+                 << stats.lastLatencyUs << "us max" << stats.maxLatencyUs << "us";
+    }
+
+    if (epollFd != -1) {
+        close(epollFd);
+        epollFd = -1;
+    }
+    if (wakeFd != -1) {
+        close(wakeFd);
+        wakeFd = -1;
+    }
+}
+
+void* InputHub::threadFunc(void *arg)
+{
+    static_cast<InputHub*>(arg)->run();
+    return NULL;
+}
+
+void InputHub::run()
+{
+    struct epoll_event ready[MAX_EPOLL_EVENTS];
+
+    // 타임아웃 없이 이벤트(또는 종료 신호)가 올 때까지 잠듦
+    while (!stopRequested.load(std::memory_order_acquire)) {
+        int r = epoll_wait(epollFd, ready, MAX_EPOLL_EVENTS, -1);
+        if (r == -1) {
+            if (errno == EINTR)
+                continue;
+            qDebug() << "InputHub: epoll_wait error:" << strerror(errno);
+            return;
+        }
+        wakeups.fetch_add(1, std::memory_order_relaxed);
+
+        QMutexLocker locker(&mutex);
+        for (int i = 0; i < r; i++) {
+            if (ready[i].data.u64 == WAKE_ID)
+                return;
+
+            // 같은 배치에서 먼저 해제된 장치는 건너뜀
+            QMap<int, Device>::iterator it = devices.find((int)ready[i].data.u64);
+            if (it == devices.end() || it.value().fd == -1)
+                continue;
+
+            readDevice(it.value());
+        }
+    }
+}
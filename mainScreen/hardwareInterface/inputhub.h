@@ -0,0 +1,128 @@
+#ifndef INPUTHUB_H
+#define INPUTHUB_H
+
+#include <QString>
+#include <QMap>
+#include <QMutex>
+#include <linux/input.h>
+#include <pthread.h>
+#include <atomic>
+#include <functional>
+
+// 단일 evdev 입력 이벤트 허브
+// 스레드 하나가 등록된 모든 /dev/input/event* fd를 epoll로 기다렸다가 이벤트가 올 때만 깨어나
+// 장치 종류별 콜백으로 전달한다. 장치마다 폴링 스레드를 두지 않으므로 유휴 CPU가 0이고,
+// 버튼 누름은 sleep 주기를 기다리지 않고 바로 전달된다.
+//
+// 이벤트 시각은 input_event.time (커널이 이벤트를 받은 시각)을 쓰며, 가능하면 EVIOCSCLOCKID로
+// CLOCK_MONOTONIC 기준으로 맞춰 FrameTrace::nowUs, V4L2 타임스탬프와 바로 비교할 수 있다.
+//
+// 등록/해제는 GUI 스레드에서 한다. 콜백은 허브 스레드에서 호출되므로 GUI 객체에는
+// 큐드 시그널/invokeMethod로 넘기고, 콜백 안에서 허브 함수를 부르면 안 된다 (장치 테이블 잠금을 잡은 채로 호출됨).
+class InputHub
+{
+public:
+    // EV_KEY 이벤트 (value: 1 누름, 0 뗌, 2 자동 반복)
+    struct KeyEvent {
+        int code;
+        int value;
+        qint64 timestampUs;
+    };
+
+    // EV_ABS X/Y/Z 축 값 (SYN_REPORT 한 번에 한 샘플)
+    struct AbsEvent {
+        int x;
+        int y;
+        int z;
+        qint64 timestampUs;
+    };
+
+    struct Stats {
+        int devices;                // 현재 열려 있는 장치 수
+        quint64 wakeups;            // epoll_wait에서 깨어난 횟수
+        quint64 events;             // 읽은 input_event 수
+        quint64 droppedReports;     // SYN_DROPPED (커널 버퍼 넘침) 횟수
+        qint64 lastLatencyUs;       // 이벤트 시각부터 콜백 호출까지
+        qint64 maxLatencyUs;
+    };
+
+    typedef std::function<void(const KeyEvent &)> KeyCallback;
+    typedef std::function<void(const AbsEvent &)> AbsCallback;
+    typedef std::function<void()> DisconnectCallback;
+
+    // 싱글톤 인스턴스 가져오기
+    static InputHub* getInstance();
+
+    // 장치를 열어 등록하고 id 반환 (실패하면 -1). 첫 장치가 등록되면 허브 스레드 시작.
+    // 같은 장치를 여러 번 등록해도 되며 각각 자기 fd로 모든 이벤트를 받는다.
+    // onDisconnect는 읽기 오류(장치 분리)로 허브가 장치를 닫을 때 한 번 호출된다.
+    int addKeyDevice(const QString &path, KeyCallback onKey,
+                     DisconnectCallback onDisconnect = DisconnectCallback());
+    int addAbsDevice(const QString &path, AbsCallback onAbs,
+                     DisconnectCallback onDisconnect = DisconnectCallback());
+
+    // 등록 해제. 반환 후에는 콜백이 다시 호출되지 않는다 (진행 중인 호출은 끝날 때까지 대기).
+    // 마지막 장치가 빠지면 허브 스레드도 멈춘다.
+    void removeDevice(int id);
+
+    // 장치가 열려 있는지 (분리되어 허브가 닫았으면 false)
+    bool isActive(int id) const;
+
+    Stats getStats() const;
+
+private:
+    InputHub();
+    ~InputHub();
+
+    enum DeviceKind {
+        DEVICE_KEY,
+        DEVICE_ABS
+    };
+
+    struct Device {
+        DeviceKind kind;
+        QString path;
+        int fd;
+        KeyCallback onKey;
+        AbsCallback onAbs;
+        DisconnectCallback onDisconnect;
+        AbsEvent abs;               // ABS 장치: SYN_REPORT까지 모으는 현재 축 값
+        bool absChanged;
+        bool dropping;              // SYN_DROPPED 이후 다음 SYN_REPORT까지 이벤트 버림
+        bool clockMonotonic;        // EVIOCSCLOCKID 성공 여부 (아니면 CLOCK_REALTIME 시각)
+    };
+
+    int addDevice(Device &device);
+    void closeDevice(Device &device);
+    void syncAbs(Device &device);
+    void readDevice(Device &device);
+    void dispatch(Device &device, const input_event &ev);
+    qint64 eventTimeUs(const Device &device, const input_event &ev) const;
+    void recordLatency(qint64 timestampUs);
+
+    bool startThread();
+    void stopThread();
+    static void* threadFunc(void *arg);
+    void run();
+
+    mutable QMutex mutex;               // 장치 테이블 (허브 스레드는 디스패치하는 동안 잡고 있음)
+    QMap<int, Device> devices;
+    int nextId;
+    int openDevices;
+
+    int epollFd;
+    int wakeFd;                         // 종료 시 epoll_wait를 깨우는 eventfd
+    pthread_t thread;
+    bool threadRunning;
+    std::atomic<bool> stopRequested;
+
+    std::atomic<quint64> wakeups;
+    std::atomic<quint64> events;
+    std::atomic<quint64> droppedReports;
+    std::atomic<qint64> lastLatencyUs;
+    std::atomic<qint64> maxLatencyUs;
+
+    static InputHub *instance;
+};
+
+#endif // INPUTHUB_H
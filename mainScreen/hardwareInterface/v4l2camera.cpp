@@ -8,8 +8,14 @@
 #include <sys/types.h>
 #include <sys/mman.h>
 #include <sys/ioctl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <poll.h>
 #include "hardwareInterface/v4l2camera.h"
-#include <QElapsedTimer>
+#include "hardwareInterface/camerasource.h"
+#include "utils/framedecoder.h"
+#include "utils/yuvconverter.h"
+#include "utils/frametrace.h"
 
 #define CLEAR(x) memset(&(x), 0, sizeof(x))
 
@@ -19,14 +25,118 @@ V4L2Camera::V4L2Camera(QObject *parent) :
     buffers(NULL),
     n_buffers(0),
     isCapturing(false),
+    backIndex(0),
+    frontIndex(1),
+    middleState(2),
+    openThreadRunning(false),
+    opening(false),
+    asyncOpenOk(false),
     stopThread(false),
-    devicePath("/dev/video4")  // 디바이스 경로를 기본값으로 초기화
+    epollFd(-1),
+    wakeFd(-1),
+    devicePath("/dev/video4"),  // 디바이스 경로를 기본값으로 초기화
+    source(CameraSource::createFromEnvironment()),
+    recorder(CameraRecorder::createFromEnvironment()),
+    trace(FrameTrace::getInstance()),
+    frameRate(45),
+    preferredWidth(640),
+    preferredHeight(480),
+    preferredPixelFormat(0),
+    decoder(NULL),
+    colorLutLoaded(false),
+    dmaBufExportEnabled(false),
+    staleFrameCount(0),
+    notifyPending(false),
+    publishedFrames(0),
+    deliveredFrames(0),
+    coalescedFrames(0),
+    overwrittenFrames(0),
+    driverDroppedFrames(0),
+    lastSequence(0),
+    haveLastSequence(false),
+    streamGeneration(0),
+    stallTimeoutMs(2000),
+    lastTimestampUs(0),
+    lastProgressUs(0),
+    recoveryLevel(RECOVERY_NONE),
+    deviceLost(false),
+    disconnectNotified(false),
+    stallsDetected(0),
+    requeueRecoveries(0),
+    restreamRecoveries(0),
+    reopenRecoveries(0),
+    roiRadiusPercent(0),
+    previewDownscale(1),
+    conversionEnabled(true),
+    stabilizerRadius(0)
 {
 }
 
 V4L2Camera::~V4L2Camera()
 {
     closeCamera();
+    delete source;
+    delete recorder;
+}
+
+int V4L2Camera::getfd() const
+{
+    if (source)
+        return source->isOpen() ? source->pollFd() : -1;
+    return fd;
+}
+
+void V4L2Camera::setSource(CameraSource *newSource)
+{
+    closeCamera();
+    delete source;
+    source = newSource;
+}
+
+void V4L2Camera::setRecordingPath(const QString &path)
+{
+    // 캡처 스레드가 recorder를 사용하므로 멈춘 상태에서만 교체
+    bool wasCapturing = isCapturing;
+    if (wasCapturing)
+        stopCapturing();
+
+    delete recorder;
+    recorder = path.isEmpty() ? NULL : new CameraRecorder(path);
+
+    if (wasCapturing)
+        startCapturing();
+}
+
+bool V4L2Camera::openSource()
+{
+    if (source->isOpen())
+        return true;
+
+    if (!source->open()) {
+        qDebug() << "Cannot open camera source" << source->description();
+        return false;
+    }
+
+    SourceFormat sf = source->format();
+    CLEAR(fmt);
+    fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    fmt.fmt.pix.pixelformat = sf.pixelFormat;
+    fmt.fmt.pix.width = sf.width;
+    fmt.fmt.pix.height = sf.height;
+    fmt.fmt.pix.bytesperline = sf.bytesPerLine;
+
+    decoder = FrameDecoder::find(sf.pixelFormat);
+    qDebug() << "Camera source:" << source->description()
+             << FrameDecoder::fourccToString(sf.pixelFormat) << sf.width << "x" << sf.height;
+    // 대체 공급원은 장치 이름이 없으므로 COLORBINGO_CAMERA_LUT만 적용
+    loadColorLut(QString());
+
+    if (!decoder) {
+        qDebug() << "Unsupported pixel format in camera source";
+        source->close();
+        return false;
+    }
+    return true;
 }
 
 // 기본 디바이스 경로를 사용하는 openCamera 구현
@@ -39,6 +149,12 @@ bool V4L2Camera::openCamera(const QString &deviceName)
 {
     struct stat st;
 
+    // 대체 공급원이 설정되어 있으면 장치 대신 사용
+    if (source) {
+        devicePath = deviceName;
+        return openSource();
+    }
+
     if (fd != -1) {
         qDebug() << "Camera already open, closing first.";
         closeCamera();
@@ -70,10 +186,18 @@ bool V4L2Camera::openCamera(const QString &deviceName)
 
 void V4L2Camera::closeCamera()
 {
+    // 진행 중인 비동기 열기가 있으면 끝날 때까지 기다린 뒤 닫음
+    joinOpenThread();
+
     if (isCapturing) {
         stopCapturing();
     }
 
+    if (source) {
+        source->close();
+        return;
+    }
+
     if (fd != -1) {
         uninitDevice();
         close(fd);
@@ -81,10 +205,26 @@ void V4L2Camera::closeCamera()
     }
 }
 
+void V4L2Camera::loadColorLut(const QString &cardName)
+{
+    // 같은 카메라 객체는 같은 장치를 계속 사용하므로 처음 한 번만 찾음
+    // (재열기 복구는 캡처 스레드에서 일어나므로 그때 LUT를 바꾸지 않음)
+    if (colorLutLoaded)
+        return;
+    colorLutLoaded = true;
+
+    QString path = ColorLut::pathForCamera(cardName);
+    if (!path.isEmpty()) {
+        correction.loadLut(path);
+    }
+}
+
 void V4L2Camera::initDevice()
 {
     struct v4l2_capability cap;
 
+    decoder = NULL;
+
     if (xioctl(fd, VIDIOC_QUERYCAP, &cap) == -1) {
         if (EINVAL == errno) {
             qDebug() << "Device is not a V4L2 device";
@@ -105,21 +245,43 @@ void V4L2Camera::initDevice()
         return;
     }
 
+    loadColorLut(QString::fromLatin1((const char *)cap.card));
+
+    // 지원 포맷/해상도/프레임 간격을 열거해 가장 저렴한 포맷 선택
+    FormatCandidate best;
+    if (!negotiateFormat(best)) {
+        // 열거를 지원하지 않는 드라이버: 기존 기본값 사용
+        best.pixelFormat = V4L2_PIX_FMT_YUYV;
+        best.width = preferredWidth;
+        best.height = preferredHeight;
+        best.maxFps = 0;
+        best.cpuCost = 0;
+    }
+
     // Set video format
     CLEAR(fmt);
     fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    fmt.fmt.pix.width = 640;
-    fmt.fmt.pix.height = 480;
-    fmt.fmt.pix.pixelformat = V4L2_PIX_FMT_YUYV;
+    fmt.fmt.pix.width = best.width;
+    fmt.fmt.pix.height = best.height;
+    fmt.fmt.pix.pixelformat = best.pixelFormat;
     fmt.fmt.pix.field = V4L2_FIELD_INTERLACED;
 
-    qDebug() << "fmt.fmt.pix.width:" << fmt.fmt.pix.width;
-    qDebug() << "fmt.fmt.pix.height:" << fmt.fmt.pix.height;
-
     if (xioctl(fd, VIDIOC_S_FMT, &fmt) == -1) {
         qDebug() << "VIDIOC_S_FMT error:" << strerror(errno);
         return;
     }
+
+    // 드라이버가 요청과 다른 포맷/해상도를 돌려줄 수 있으므로 실제 결과를 기준으로 디코더 선택
+    decoder = FrameDecoder::find(fmt.fmt.pix.pixelformat);
+    qDebug() << "Camera format:" << FrameDecoder::fourccToString(fmt.fmt.pix.pixelformat)
+             << fmt.fmt.pix.width << "x" << fmt.fmt.pix.height
+             << "bytesperline:" << fmt.fmt.pix.bytesperline;
+
+    if (!decoder) {
+        qDebug() << "Unsupported pixel format returned by driver:"
+                 << FrameDecoder::fourccToString(fmt.fmt.pix.pixelformat);
+        return;
+    }
     
     // Set frame rate (FPS improvement)
     struct v4l2_streamparm streamparm;
@@ -131,9 +293,9 @@ void V4L2Camera::initDevice()
         qDebug() << "VIDIOC_G_PARM error:" << strerror(errno);
     } 
     else if (streamparm.parm.capture.capability & V4L2_CAP_TIMEPERFRAME) {
-        // Set frame rate to 45fps (time interval = 1second/fps)
+        // 프레임 레이트 제한은 드라이버에 맡김 (time interval = 1second/fps)
         streamparm.parm.capture.timeperframe.numerator = 1;
-        streamparm.parm.capture.timeperframe.denominator = 45;
+        streamparm.parm.capture.timeperframe.denominator = frameRate;
         
         if (xioctl(fd, VIDIOC_S_PARM, &streamparm) == -1) {
             qDebug() << "VIDIOC_S_PARM error:" << strerror(errno);
@@ -146,6 +308,151 @@ void V4L2Camera::initDevice()
     initMMAP();
 }
 
+bool V4L2Camera::negotiateFormat(FormatCandidate &best)
+{
+    bool found = false;
+    struct v4l2_fmtdesc desc;
+
+    CLEAR(desc);
+    desc.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+
+    for (desc.index = 0; xioctl(fd, VIDIOC_ENUM_FMT, &desc) == 0; desc.index++) {
+        const FrameDecoder::Entry *entry = FrameDecoder::find(desc.pixelformat);
+        if (!entry) {
+            qDebug() << "Skipping camera format without decoder:" << FrameDecoder::fourccToString(desc.pixelformat);
+            continue;
+        }
+
+        FormatCandidate candidate;
+        candidate.pixelFormat = desc.pixelformat;
+        candidate.cpuCost = entry->cpuCost;
+        if (!pickFrameSize(desc.pixelformat, candidate.width, candidate.height)) {
+            candidate.width = preferredWidth;
+            candidate.height = preferredHeight;
+        }
+        candidate.maxFps = queryMaxFps(desc.pixelformat, candidate.width, candidate.height);
+
+        qDebug() << "Camera format candidate:" << entry->name << candidate.width << "x" << candidate.height
+                 << "max fps:" << candidate.maxFps;
+
+        if (!found || isBetterCandidate(candidate, best)) {
+            best = candidate;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+int V4L2Camera::sizeRank(int width, int height) const
+{
+    // 0: 목표 해상도와 일치, 1: 목표보다 큼 (축소 필요), 2: 목표보다 작음
+    if (width == preferredWidth && height == preferredHeight)
+        return 0;
+    if (width >= preferredWidth && height >= preferredHeight)
+        return 1;
+    return 2;
+}
+
+bool V4L2Camera::isBetterCandidate(const FormatCandidate &a, const FormatCandidate &b) const
+{
+    // 1. 사용자가 지정한 포맷
+    if (preferredPixelFormat) {
+        bool aPreferred = (a.pixelFormat == preferredPixelFormat);
+        bool bPreferred = (b.pixelFormat == preferredPixelFormat);
+        if (aPreferred != bPreferred)
+            return aPreferred;
+    }
+
+    // 2. 목표 해상도에 가까운 것
+    int aSize = sizeRank(a.width, a.height);
+    int bSize = sizeRank(b.width, b.height);
+    if (aSize != bSize)
+        return aSize < bSize;
+
+    // 3. 목표 fps를 낼 수 있는 것 (USB 대역폭 때문에 비압축 포맷은 fps가 떨어질 수 있음)
+    bool aFast = (a.maxFps == 0 || a.maxFps >= frameRate);
+    bool bFast = (b.maxFps == 0 || b.maxFps >= frameRate);
+    if (aFast != bFast)
+        return aFast;
+    if (!aFast && a.maxFps != b.maxFps)
+        return a.maxFps > b.maxFps;
+
+    // 4. 변환 비용이 낮은 것
+    if (a.cpuCost != b.cpuCost)
+        return a.cpuCost < b.cpuCost;
+
+    // 5. 픽셀 수가 적은 것
+    return a.width * a.height < b.width * b.height;
+}
+
+bool V4L2Camera::pickFrameSize(quint32 pixelFormat, int &width, int &height)
+{
+    struct v4l2_frmsizeenum size;
+    bool found = false;
+    int bestRank = 3;
+    qint64 bestArea = 0;
+
+    CLEAR(size);
+    size.pixel_format = pixelFormat;
+
+    for (size.index = 0; xioctl(fd, VIDIOC_ENUM_FRAMESIZES, &size) == 0; size.index++) {
+        if (size.type != V4L2_FRMSIZE_TYPE_DISCRETE) {
+            // 연속/단계 범위: 목표 해상도를 범위와 단계에 맞춰 조정
+            const struct v4l2_frmsize_stepwise &sw = size.stepwise;
+            int stepW = sw.step_width ? sw.step_width : 1;
+            int stepH = sw.step_height ? sw.step_height : 1;
+            int w = qBound((int)sw.min_width, preferredWidth, (int)sw.max_width);
+            int h = qBound((int)sw.min_height, preferredHeight, (int)sw.max_height);
+            width = sw.min_width + (w - sw.min_width) / stepW * stepW;
+            height = sw.min_height + (h - sw.min_height) / stepH * stepH;
+            return true;
+        }
+
+        int w = size.discrete.width;
+        int h = size.discrete.height;
+        int rank = sizeRank(w, h);
+        qint64 area = (qint64)w * h;
+
+        // 같은 순위라면 목표보다 큰 경우 가장 작은 것, 작은 경우 가장 큰 것
+        bool better = !found || rank < bestRank
+                || (rank == bestRank && (rank == 1 ? area < bestArea : area > bestArea));
+        if (better) {
+            width = w;
+            height = h;
+            bestRank = rank;
+            bestArea = area;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+int V4L2Camera::queryMaxFps(quint32 pixelFormat, int width, int height)
+{
+    struct v4l2_frmivalenum ival;
+    int maxFps = 0;
+
+    CLEAR(ival);
+    ival.pixel_format = pixelFormat;
+    ival.width = width;
+    ival.height = height;
+
+    for (ival.index = 0; xioctl(fd, VIDIOC_ENUM_FRAMEINTERVALS, &ival) == 0; ival.index++) {
+        // 최소 프레임 간격 = 최대 fps
+        const struct v4l2_fract &f = (ival.type == V4L2_FRMIVAL_TYPE_DISCRETE)
+                ? ival.discrete : ival.stepwise.min;
+        if (f.numerator > 0) {
+            maxFps = qMax(maxFps, (int)(f.denominator / f.numerator));
+        }
+        if (ival.type != V4L2_FRMIVAL_TYPE_DISCRETE)
+            break;
+    }
+
+    return maxFps;
+}
+
 void V4L2Camera::initMMAP()
 {
     struct v4l2_requestbuffers req;
@@ -195,11 +502,39 @@ void V4L2Camera::initMMAP()
               PROT_READ | PROT_WRITE, MAP_SHARED,
               fd, buf.m.offset);
 
+        buffers[n_buffers].dmabufFd = -1;
+
         if (buffers[n_buffers].start == MAP_FAILED) {
             qDebug() << "mmap error:" << strerror(errno);
             return;
         }
     }
+
+    if (dmaBufExportEnabled) {
+        exportDmaBufs();
+    }
+}
+
+void V4L2Camera::exportDmaBufs()
+{
+    for (unsigned int i = 0; i < n_buffers; ++i) {
+        struct v4l2_exportbuffer expbuf;
+
+        CLEAR(expbuf);
+        expbuf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        expbuf.index = i;
+        expbuf.flags = O_RDONLY | O_CLOEXEC;
+
+        if (xioctl(fd, VIDIOC_EXPBUF, &expbuf) == -1) {
+            // 지원하지 않는 드라이버면 mmap 경로만 사용
+            qDebug() << "VIDIOC_EXPBUF error:" << strerror(errno) << "- DMABUF export disabled";
+            return;
+        }
+
+        buffers[i].dmabufFd = expbuf.fd;
+    }
+
+    qDebug() << "Exported" << n_buffers << "capture buffers as DMABUF";
 }
 
 void V4L2Camera::uninitDevice()
@@ -207,10 +542,14 @@ void V4L2Camera::uninitDevice()
     unsigned int i;
 
     for (i = 0; i < n_buffers; ++i) {
+        if (buffers[i].dmabufFd != -1) {
+            close(buffers[i].dmabufFd);
+        }
         if (munmap(buffers[i].start, buffers[i].length) == -1) {
             qDebug() << "munmap error";
         }
     }
+    n_buffers = 0;
 
     free(buffers);
     buffers = NULL;
@@ -221,13 +560,62 @@ bool V4L2Camera::startCapturing()
     if (isCapturing)
         return true;
         
-    if (fd == -1) {
+    if (getfd() == -1) {
         // 장치가 닫혀있으면 다시 열기 시도
         if (!openCamera()) {
             return false;
         }
     }
 
+    if (source) {
+        if (!source->start()) {
+            qDebug() << "Failed to start camera source" << source->description();
+            return false;
+        }
+    } else if (!startStreaming()) {
+        return false;
+    }
+
+    // 프레임 버퍼를 현재 해상도로 미리 할당
+    resetFrameBuffers();
+
+    // 장치(또는 공급원) fd와 종료용 eventfd를 epoll에 등록
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd == -1 || wakeFd == -1) {
+        qDebug() << "epoll/eventfd creation error:" << strerror(errno);
+        closeEventFds();
+        stopStreaming();
+        return false;
+    }
+
+    struct epoll_event ev;
+    CLEAR(ev);
+    ev.events = EPOLLIN;
+    ev.data.fd = getfd();
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, ev.data.fd, &ev);
+    ev.data.fd = wakeFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev);
+
+    // Start capture thread
+    haveLastSequence = false;
+    stabilizer.reset();
+    notifyPending = false;
+    stopThread = false;
+    isCapturing = true;
+    if (pthread_create(&captureThread, NULL, captureThreadFunc, this) != 0) {
+        qDebug() << "Failed to create capture thread";
+        isCapturing = false;
+        closeEventFds();
+        stopStreaming();
+        return false;
+    }
+
+    return true;
+}
+
+bool V4L2Camera::startStreaming()
+{
     unsigned int i;
     enum v4l2_buf_type type;
 
@@ -251,40 +639,129 @@ bool V4L2Camera::startCapturing()
         return false;
     }
 
-    // Create a new image with the right dimensions
-    currentFrame = QImage(fmt.fmt.pix.width, fmt.fmt.pix.height, QImage::Format_RGB888);
-    currentFrame.fill(Qt::black);
+    return true;
+}
 
-    // Start capture thread
-    stopThread = false;
-    isCapturing = true;
-    if (pthread_create(&captureThread, NULL, captureThreadFunc, this) != 0) {
-        qDebug() << "Failed to create capture thread";
-        isCapturing = false;
-        return false;
+void V4L2Camera::stopStreaming()
+{
+    if (source) {
+        source->stop();
+        return;
     }
 
-    return true;
+    // 감시기의 재열기가 실패해 장치가 닫힌 상태
+    if (fd == -1)
+        return;
+
+    enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (xioctl(fd, VIDIOC_STREAMOFF, &type) == -1) {
+        qDebug() << "VIDIOC_STREAMOFF error:" << strerror(errno);
+    }
+}
+
+void V4L2Camera::closeEventFds()
+{
+    if (epollFd != -1) {
+        close(epollFd);
+        epollFd = -1;
+    }
+    if (wakeFd != -1) {
+        close(wakeFd);
+        wakeFd = -1;
+    }
 }
 
 void V4L2Camera::stopCapturing()
 {
+    joinOpenThread();
+
     if (!isCapturing)
         return;
 
-    // Signal thread to stop and wait for it
+    // Signal thread to stop and wait for it (eventfd로 epoll_wait를 즉시 깨움)
     stopThread = true;
+    uint64_t one = 1;
+    if (write(wakeFd, &one, sizeof(one)) == -1) {
+        qDebug() << "eventfd write error:" << strerror(errno);
+    }
     pthread_join(captureThread, NULL);
+    closeEventFds();
 
     // Stop streaming
-    enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    if (xioctl(fd, VIDIOC_STREAMOFF, &type) == -1) {
-        qDebug() << "VIDIOC_STREAMOFF error:" << strerror(errno);
+    stopStreaming();
+
+    if (recorder) {
+        recorder->flush();
     }
 
+    PipelineStats stats = getPipelineStats();
+    qDebug() << "Camera pipeline: published" << stats.publishedFrames
+             << "delivered" << stats.deliveredFrames
+             << "coalesced" << stats.coalescedFrames
+             << "overwritten" << stats.overwrittenFrames
+             << "stale" << stats.staleDriverFrames
+             << "driver dropped" << stats.driverDroppedFrames
+             << "stalls" << stats.stallsDetected;
+
     isCapturing = false;
 }
 
+void V4L2Camera::startCapturingAsync()
+{
+    if (isOpening())
+        return;
+
+    if (isCapturing) {
+        asyncOpenOk = true;
+        opening = true;
+        QMetaObject::invokeMethod(this, "finishAsyncOpen", Qt::QueuedConnection);
+        return;
+    }
+
+    joinOpenThread();
+
+    // UVC 장치는 QUERYCAP/S_FMT/REQBUFS/STREAMON 응답에 수백 ms가 걸리기도 하므로 GUI 스레드 밖에서 수행
+    opening = true;
+    asyncOpenOk = false;
+    if (pthread_create(&openThread, NULL, openThreadFunc, this) != 0) {
+        qDebug() << "Failed to create camera open thread";
+        QMetaObject::invokeMethod(this, "finishAsyncOpen", Qt::QueuedConnection);
+        return;
+    }
+    openThreadRunning = true;
+}
+
+void* V4L2Camera::openThreadFunc(void *arg)
+{
+    V4L2Camera *camera = static_cast<V4L2Camera*>(arg);
+    camera->asyncOpenOk = camera->startCapturing();
+    QMetaObject::invokeMethod(camera, "finishAsyncOpen", Qt::QueuedConnection);
+    return NULL;
+}
+
+void V4L2Camera::joinOpenThread()
+{
+    if (openThreadRunning) {
+        pthread_join(openThread, NULL);
+        openThreadRunning = false;
+    }
+    // 결과를 받기 전에 stop/close가 호출되면 대기 중인 cameraReady는 보내지 않음
+    opening = false;
+}
+
+void V4L2Camera::finishAsyncOpen()
+{
+    if (!isOpening())
+        return;
+
+    joinOpenThread();
+    opening = false;
+
+    bool ok = asyncOpenOk && isCapturing;
+    qDebug() << "Camera async open" << (ok ? "completed" : "failed");
+    emit cameraReady(ok);
+}
+
 void* V4L2Camera::captureThreadFunc(void *arg)
 {
     V4L2Camera *camera = static_cast<V4L2Camera*>(arg);
@@ -292,33 +769,249 @@ void* V4L2Camera::captureThreadFunc(void *arg)
     return NULL;
 }
 
+void V4L2Camera::notifyFrame()
+{
+    // 이미 알림이 대기 중이면 새 알림을 쌓지 않음 (GUI가 처리할 때 최신 프레임을 가져감)
+    if (notifyPending.exchange(true, std::memory_order_acq_rel)) {
+        coalescedFrames.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    QMetaObject::invokeMethod(this, "deliverFrameNotification", Qt::QueuedConnection);
+}
+
+void V4L2Camera::deliverFrameNotification()
+{
+    // 처리 도중 게시된 프레임이 새 알림을 보낼 수 있도록 먼저 해제
+    notifyPending.store(false, std::memory_order_release);
+    emit newFrameAvailable();
+}
+
+PipelineStats V4L2Camera::getPipelineStats() const
+{
+    PipelineStats stats;
+    stats.publishedFrames = publishedFrames.load(std::memory_order_relaxed);
+    stats.deliveredFrames = deliveredFrames.load(std::memory_order_relaxed);
+    stats.coalescedFrames = coalescedFrames.load(std::memory_order_relaxed);
+    stats.overwrittenFrames = overwrittenFrames.load(std::memory_order_relaxed);
+    stats.staleDriverFrames = staleFrameCount.load(std::memory_order_relaxed);
+    stats.driverDroppedFrames = driverDroppedFrames.load(std::memory_order_relaxed);
+    stats.stallsDetected = stallsDetected.load(std::memory_order_relaxed);
+    stats.requeueRecoveries = requeueRecoveries.load(std::memory_order_relaxed);
+    stats.restreamRecoveries = restreamRecoveries.load(std::memory_order_relaxed);
+    stats.reopenRecoveries = reopenRecoveries.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool V4L2Camera::noteFrame(quint32 sequence, qint64 timestampUs)
+{
+    // 같은 시퀀스/타임스탬프가 반복되면 드라이버가 멈춘 것으로 보고 진행으로 치지 않음
+    bool progressed = !haveLastSequence || sequence != lastSequence || timestampUs > lastTimestampUs;
+
+    // 새 스트림: 시작, STREAMOFF/ON 또는 재열기, 녹화 반복 재생에서 시퀀스 번호가 다시 시작됨
+    if (!haveLastSequence || sequence < lastSequence) {
+        streamGeneration++;
+    }
+
+    if (haveLastSequence) {
+        // 드라이버 시퀀스 번호가 건너뛰면 드라이버/센서 단에서 잃어버린 프레임
+        if (sequence > lastSequence + 1) {
+            driverDroppedFrames.fetch_add(sequence - lastSequence - 1, std::memory_order_relaxed);
+        }
+
+        // 감시기가 개입하기 전에 스스로 풀린 정지도 기록
+        if (progressed && recoveryLevel == RECOVERY_NONE && stallTimeoutMs > 0 &&
+            timestampUs - lastTimestampUs > (qint64)stallTimeoutMs * 1000) {
+            stallsDetected.fetch_add(1, std::memory_order_relaxed);
+            qDebug() << "Camera frame gap:" << (timestampUs - lastTimestampUs) / 1000 << "ms";
+        }
+    }
+
+    lastSequence = sequence;
+    lastTimestampUs = timestampUs;
+    haveLastSequence = true;
+
+    if (!progressed)
+        return false;
+
+    lastProgressUs = FrameTrace::nowUs();
+
+    if (recoveryLevel != RECOVERY_NONE) {
+        switch (recoveryLevel) {
+        case RECOVERY_REQUEUE:
+            requeueRecoveries.fetch_add(1, std::memory_order_relaxed);
+            break;
+        case RECOVERY_RESTREAM:
+            restreamRecoveries.fetch_add(1, std::memory_order_relaxed);
+            break;
+        default:
+            reopenRecoveries.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+        qDebug() << "Camera recovered at watchdog level" << recoveryLevel;
+        recoveryLevel = RECOVERY_NONE;
+
+        if (disconnectNotified) {
+            disconnectNotified = false;
+            emit deviceRecovered();
+        }
+    }
+    return true;
+}
+
+void V4L2Camera::runWatchdog(bool fdFailing)
+{
+    if (stallTimeoutMs <= 0)
+        return;
+
+    qint64 now = FrameTrace::nowUs();
+    bool stalled = now - lastProgressUs >= (qint64)stallTimeoutMs * 1000;
+    // fd 오류나 장치 분리는 정지 시간을 기다리지 않고 바로 대응
+    bool urgent = (fdFailing || deviceLost) && recoveryLevel == RECOVERY_NONE;
+    if (!stalled && !urgent)
+        return;
+
+    if (recoveryLevel == RECOVERY_NONE) {
+        stallsDetected.fetch_add(1, std::memory_order_relaxed);
+        qDebug() << "Camera stalled after sequence" << lastSequence
+                 << (deviceLost ? "(device lost)" : fdFailing ? "(fd error)" : "");
+    }
+
+    // 이전 단계로 복구되지 않았으면 한 단계씩 올림 (장치가 사라졌으면 바로 재열기)
+    if (deviceLost || recoveryLevel >= RECOVERY_RESTREAM) {
+        recoveryLevel = RECOVERY_REOPEN;
+    } else {
+        recoveryLevel = (RecoveryLevel)(recoveryLevel + 1);
+    }
+
+    bool ok;
+    switch (recoveryLevel) {
+    case RECOVERY_REQUEUE:
+        ok = requeueBuffers();
+        break;
+    case RECOVERY_RESTREAM:
+        ok = restartStreaming();
+        break;
+    default:
+        if (!disconnectNotified) {
+            disconnectNotified = true;
+            emit deviceDisconnected();
+        }
+        ok = reopenDevice();
+        if (ok)
+            deviceLost = false;
+        break;
+    }
+    qDebug() << "Camera watchdog level" << recoveryLevel << (ok ? "applied" : "failed");
+
+    // 복구 결과는 다음 한 주기 동안 프레임이 들어오는지로 판정
+    lastProgressUs = now;
+}
+
+bool V4L2Camera::requeueBuffers()
+{
+    // 큐에도 완료 목록에도 없는(드라이버가 잃어버린) 버퍼만 다시 큐잉
+    int requeued = 0;
+    for (unsigned int i = 0; i < n_buffers; ++i) {
+        struct v4l2_buffer buf;
+
+        CLEAR(buf);
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index = i;
+
+        if (xioctl(fd, VIDIOC_QUERYBUF, &buf) == -1) {
+            qDebug() << "VIDIOC_QUERYBUF error:" << strerror(errno);
+            return false;
+        }
+
+        if (buf.flags & (V4L2_BUF_FLAG_QUEUED | V4L2_BUF_FLAG_DONE))
+            continue;
+
+        if (xioctl(fd, VIDIOC_QBUF, &buf) == -1) {
+            qDebug() << "VIDIOC_QBUF error:" << strerror(errno);
+            return false;
+        }
+        requeued++;
+    }
+
+    qDebug() << "Requeued" << requeued << "of" << n_buffers << "capture buffers";
+    return true;
+}
+
+bool V4L2Camera::restartStreaming()
+{
+    // 버퍼 매핑은 그대로 두고 스트림만 재시작 (STREAMOFF가 모든 버퍼를 회수함)
+    stopStreaming();
+    return startStreaming();
+}
+
+bool V4L2Camera::reopenDevice()
+{
+    // 캡처 스레드에서 장치를 닫고 다시 열어 포맷 협상과 mmap부터 새로 수행
+    if (fd != -1) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, NULL);
+        stopStreaming();
+        uninitDevice();
+        close(fd);
+        fd = -1;
+    }
+
+    int newFd = open(devicePath.toLocal8Bit().constData(), O_RDWR | O_NONBLOCK, 0);
+    if (newFd == -1) {
+        qDebug() << "Cannot reopen" << devicePath << ":" << strerror(errno);
+        return false;
+    }
+
+    fd = newFd;
+    initDevice();
+
+    if (!decoder || n_buffers == 0 || !startStreaming()) {
+        uninitDevice();
+        close(fd);
+        fd = -1;
+        return false;
+    }
+
+    struct epoll_event ev;
+    CLEAR(ev);
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+
+    // 해상도가 바뀌었으면 processImage가 back 버퍼를 새 크기로 다시 할당함
+    return true;
+}
+
+bool V4L2Camera::waitForWake(int timeoutMs)
+{
+    struct pollfd pfd;
+    pfd.fd = wakeFd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    return poll(&pfd, 1, timeoutMs) > 0;
+}
+
 void V4L2Camera::captureThreadLoop()
 {
-    fd_set fds;
-    struct timeval tv;
-    int r;
+    struct epoll_event events[2];
     int errorCount = 0;  // Track consecutive errors
-    
-    // 프레임 처리 빈도 제한을 위한 변수
-    QElapsedTimer frameTimer;
-    frameTimer.start();
-    const int MIN_FRAME_INTERVAL_MS = 33; // 약 30 FPS로 제한 (1000/30 = 33.3ms)
 
-    while (!stopThread) {
-        FD_ZERO(&fds);
-        FD_SET(fd, &fds);
+    lastProgressUs = FrameTrace::nowUs();
+    recoveryLevel = RECOVERY_NONE;
+    deviceLost = false;
+    disconnectNotified = false;
 
-        // Timeout
-        tv.tv_sec = 1;
-        tv.tv_usec = 0;
-
-        r = select(fd + 1, &fds, NULL, NULL, &tv);
+    // 프레임 간격 제한은 드라이버(VIDIOC_S_PARM)와 오래된 버퍼 폐기로 처리하므로
+    // 여기서는 이벤트를 기다리되, 정지 감시를 위해 주기적으로 깨어난다
+    while (!stopThread) {
+        int r = epoll_wait(epollFd, events, 2, WATCHDOG_TICK_MS);
 
         if (r == -1) {
             if (errno == EINTR)
                 continue;
-            qDebug() << "select error:" << strerror(errno);
-            
+            qDebug() << "epoll_wait error:" << strerror(errno);
+
             // Error detection and handling
             errorCount++;
             if (errorCount > 3) {  // More than 3 consecutive errors
@@ -326,168 +1019,417 @@ void V4L2Camera::captureThreadLoop()
                 qDebug() << "Device connection lost detected";
                 break;
             }
-            
+
             continue;
         }
 
-        errorCount = 0;  // Reset counter if no errors
+        bool frameReady = false;
+        bool fdError = false;
+        for (int i = 0; i < r; i++) {
+            if (events[i].data.fd == wakeFd) {
+                // stopCapturing에서 보낸 종료 신호
+                return;
+            }
 
-        if (r == 0) {
-            // Timeout, no data available
-            continue;
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                fdError = true;
+            } else if (events[i].events & EPOLLIN) {
+                frameReady = true;
+            }
         }
-        
-        // 이전 프레임 처리 후 최소 시간이 경과했는지 확인
-        if (frameTimer.elapsed() < MIN_FRAME_INTERVAL_MS) {
-            // 너무 빠른 프레임 처리는 CPU 부하를 줄이기 위해 건너뜀
-            // 다음 이벤트가 발생할 때까지 대기하면서 스레드 슬립
-            QThread::msleep(5); // 아주 짧게 쉬어 CPU 사용 줄임
+
+        if (fdError) {
+            errorCount++;
+            qDebug() << "Camera fd reported error/hangup";
+            if (source && errorCount > 3) {
+                emit deviceDisconnected();
+                qDebug() << "Device connection lost detected";
+                return;
+            }
+            // 레벨 트리거 오류(큐에 버퍼가 없을 때 등)로 바쁜 루프가 되지 않도록 잠시 대기
+            if (waitForWake(WATCHDOG_TICK_MS))
+                return;
+        }
+
+        if (frameReady) {
+            // 버퍼를 꺼냈으면 장치는 살아 있음 (변환을 건너뛰거나 디코딩이 실패해도 오류 누적 초기화)
+            bool dequeued = false;
+            if (readFrame(dequeued)) {
+                notifyFrame();
+            }
+            if (dequeued) {
+                errorCount = 0;
+            }
+        }
+
+        // 실제 장치는 감시기가 정지/오류를 단계적으로 복구 (UI 스레드는 관여하지 않음)
+        if (!source) {
+            bool fdFailing = errorCount > 3;
+            if (fdFailing)
+                errorCount = 0;
+            runWatchdog(fdFailing);
+        }
+    }
+}
+
+void V4L2Camera::handleDequeueError(int error)
+{
+    switch (error) {
+    case ENODEV:  // Device not found error
+        // 감시기가 장치 재열기로 복구
+        qDebug() << "Camera device error: " << strerror(error);
+        deviceLost = true;
+        break;
+    case EIO:
+        // Could ignore EIO, see spec (일시적 오류, 계속되면 감시기가 처리)
+        // fall through
+    default:
+        qDebug() << "VIDIOC_DQBUF error:" << strerror(error);
+        break;
+    }
+}
+
+bool V4L2Camera::dequeueLatest(struct v4l2_buffer &latest)
+{
+    bool haveFrame = false;
+
+    // 큐에 쌓인 버퍼를 모두 꺼내 가장 최신 것만 남기고 나머지는 즉시 반환
+    for (;;) {
+        struct v4l2_buffer buf;
+
+        CLEAR(buf);
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+
+        if (xioctl(fd, VIDIOC_DQBUF, &buf) == -1) {
+            if (errno == EAGAIN)
+                return haveFrame;
+
+            // 오류는 기록만 하고 (ENODEV면 감시기가 이 프레임 처리 뒤에 재열기),
+            // 이미 꺼낸 정상 버퍼가 있으면 버리지 않고 그 프레임으로 꺼내기를 멈춤
+            handleDequeueError(errno);
+            return haveFrame;
+        }
+
+        if (buf.index >= n_buffers) {
+            qDebug() << "Buffer index out of range";
             continue;
         }
 
-        if (readFrame()) {
-            emit newFrameAvailable();
-            frameTimer.restart(); // 타이머 재시작
+        noteFrame(buf.sequence, (qint64)buf.timestamp.tv_sec * 1000000 + buf.timestamp.tv_usec);
+
+        if (haveFrame) {
+            // 이전에 꺼낸 버퍼는 오래된 프레임이므로 처리 없이 드라이버에 반환
+            if (xioctl(fd, VIDIOC_QBUF, &latest) == -1) {
+                qDebug() << "VIDIOC_QBUF error:" << strerror(errno);
+            }
+            staleFrameCount.fetch_add(1, std::memory_order_relaxed);
         }
+
+        latest = buf;
+        haveFrame = true;
     }
 }
 
-bool V4L2Camera::readFrame()
+bool V4L2Camera::readFrame(bool &dequeued)
 {
+    dequeued = false;
+    if (source) {
+        return readSourceFrame(dequeued);
+    }
+
     struct v4l2_buffer buf;
 
     CLEAR(buf);
-    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    buf.memory = V4L2_MEMORY_MMAP;
+    if (!dequeueLatest(buf)) {
+        return false;
+    }
+    dequeued = true;
 
-    if (xioctl(fd, VIDIOC_DQBUF, &buf) == -1) {
-        switch (errno) {
-        case EAGAIN:
-            return false;
-        case EIO:
-            // Could ignore EIO, see spec
-            // fall through
-        case ENODEV:  // Device not found error
-            qDebug() << "Camera device error: " << strerror(errno);
-            emit deviceDisconnected();
-            return false;
-        default:
-            qDebug() << "VIDIOC_DQBUF error:" << strerror(errno);
-            return false;
+    qint64 timestampUs = (qint64)buf.timestamp.tv_sec * 1000000 + buf.timestamp.tv_usec;
+
+    if (trace->isEnabled()) {
+        // 드라이버 타임스탬프가 CLOCK_MONOTONIC일 때만 같은 축에서 비교 가능
+        if ((buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) == V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC) {
+            trace->recordAt(streamGeneration, buf.sequence, FrameTrace::STAGE_DRIVER, timestampUs);
         }
+        trace->record(streamGeneration, buf.sequence, FrameTrace::STAGE_DEQUEUE);
     }
 
-    if (buf.index >= n_buffers) {
-        qDebug() << "Buffer index out of range";
-        return false;
+    // 복사 없이 드라이버 버퍼를 넘겨받을 소비자가 있으면 먼저 전달
+    if (rawFrameHandler || recorder) {
+        RawFrame raw;
+        raw.data = buffers[buf.index].start;
+        raw.bytesUsed = buf.bytesused;
+        raw.dmabufFd = buffers[buf.index].dmabufFd;
+        raw.index = buf.index;
+        raw.sequence = buf.sequence;
+        raw.timestampUs = timestampUs;
+        raw.pixelFormat = fmt.fmt.pix.pixelformat;
+        raw.width = fmt.fmt.pix.width;
+        raw.height = fmt.fmt.pix.height;
+        raw.bytesPerLine = fmt.fmt.pix.bytesperline;
+        deliverRawFrame(raw);
     }
 
-    processImage(buffers[buf.index].start, 0);
+    // 구독자가 없으면 변환 없이 버퍼만 반환
+    bool published = conversionEnabled.load(std::memory_order_relaxed) &&
+            processImage(buffers[buf.index].start, buf.bytesused, buf.sequence, timestampUs);
 
     if (xioctl(fd, VIDIOC_QBUF, &buf) == -1) {
         qDebug() << "VIDIOC_QBUF error:" << strerror(errno);
         return false;
     }
 
-    return true;
+    return published;
 }
 
-void V4L2Camera::processImage(const void *p, int /* size */)
+bool V4L2Camera::readSourceFrame(bool &dequeued)
 {
-    frameMutex.lock();
-    yuv422ToRgb888(p, currentFrame);
-    frameMutex.unlock();
+    SourceFrame frame;
+    if (!source->acquire(frame)) {
+        return false;
+    }
+    dequeued = true;
+
+    noteFrame(frame.sequence, frame.timestampUs);
+
+    if (trace->isEnabled()) {
+        trace->recordAt(streamGeneration, frame.sequence, FrameTrace::STAGE_DRIVER, frame.timestampUs);
+        trace->record(streamGeneration, frame.sequence, FrameTrace::STAGE_DEQUEUE);
+    }
+
+    if (rawFrameHandler || recorder) {
+        RawFrame raw;
+        raw.data = frame.data;
+        raw.bytesUsed = frame.size;
+        raw.dmabufFd = -1;
+        raw.index = 0;
+        raw.sequence = frame.sequence;
+        raw.timestampUs = frame.timestampUs;
+        raw.pixelFormat = fmt.fmt.pix.pixelformat;
+        raw.width = fmt.fmt.pix.width;
+        raw.height = fmt.fmt.pix.height;
+        raw.bytesPerLine = fmt.fmt.pix.bytesperline;
+        deliverRawFrame(raw);
+    }
+
+    bool published = conversionEnabled.load(std::memory_order_relaxed) &&
+            processImage(frame.data, frame.size, frame.sequence, frame.timestampUs);
+    source->release();
+    return published;
 }
 
-void V4L2Camera::yuv422ToRgb888(const void *yuv, QImage &rgbImage)
+void V4L2Camera::deliverRawFrame(const RawFrame &raw)
 {
-    // 이미지 크기 가져오기
+    if (recorder) {
+        recorder->write(raw);
+    }
+    if (rawFrameHandler) {
+        rawFrameHandler(raw);
+    }
+}
+
+void V4L2Camera::resetFrameBuffers()
+{
+    // 캡처 스레드가 멈춘 상태에서만 호출
+    for (int i = 0; i < FRAME_BUFFER_COUNT; i++) {
+        frameBuffers[i] = QImage(fmt.fmt.pix.width, fmt.fmt.pix.height, QImage::Format_RGB888);
+        frameBuffers[i].fill(Qt::black);
+        memset(&frameStats[i], 0, sizeof(frameStats[i]));
+    }
+    backIndex = 0;
+    frontIndex = 1;
+    middleState.store(2, std::memory_order_release);
+}
+
+bool V4L2Camera::processImage(const void *p, int size, quint32 sequence, qint64 timestampUs)
+{
+    if (!decoder)
+        return false;
+
+    const uchar *src = static_cast<const uchar *>(p);
     int width = fmt.fmt.pix.width;
     int height = fmt.fmt.pix.height;
-    
-    // YUV 데이터를 RGB로 변환
-    unsigned char *pp = (unsigned char *)yuv;
-    
-    // 더 빠른 방식으로 변환을 위한 사전 계산된 테이블 사용
-    // 이 테이블들은 정적으로 선언하면 매번 재계산하지 않아도 됨
-    static int table_Y[256];
-    static int table_Cb_blue[256];
-    static int table_Cb_green[256];
-    static int table_Cr_green[256];
-    static int table_Cr_red[256];
-    static bool tables_initialized = false;
-    
-    if (!tables_initialized) {
-        // 테이블 초기화 (한번만 수행)
-        for (int i = 0; i < 256; i++) {
-            table_Y[i] = qBound(0, (int)(i * 1.2), 255); // 밝기 향상 20%
-            
-            int Cb_blue = (int)(1.7790 * (i - 128));
-            int Cb_green = (int)(0.3455 * (i - 128));
-            int Cr_green = (int)(0.7169 * (i - 128));
-            int Cr_red = (int)(1.4075 * (i - 128));
-            
-            table_Cb_blue[i] = Cb_blue;
-            table_Cb_green[i] = -Cb_green;
-            table_Cr_green[i] = -Cr_green;
-            table_Cr_red[i] = Cr_red;
-        }
-        tables_initialized = true;
+    bool yuyv = (fmt.fmt.pix.pixelformat == V4L2_PIX_FMT_YUYV);
+
+    // 축소 미리보기는 YUYV에서 변환과 동시에 수행 (다른 포맷은 원본 해상도 유지)
+    int factor = previewDownscale.load(std::memory_order_relaxed);
+    if (!yuyv || (factor != 2 && factor != 4))
+        factor = 1;
+    int outWidth = width / factor;
+    int outHeight = height / factor;
+
+    QImage &back = frameBuffers[backIndex];
+
+    // 소비자가 아직 이 버퍼의 이전 프레임을 들고 있으면 덮어쓰지 않고 새로 할당
+    // (정상 상태에서는 소비자가 최신 프레임 하나만 유지하므로 발생하지 않음)
+    if (!back.isDetached() || back.width() != outWidth || back.height() != outHeight) {
+        back = QImage(outWidth, outHeight, QImage::Format_RGB888);
     }
-    
-    #pragma omp parallel for  // OpenMP 병렬화 (시스템 지원 시)
-    for (int i = 0; i < height; i++) {
-        // 각 열에 대해 루프 최적화를 위해 포인터 사용
-        unsigned char *pY0, *pU, *pY1, *pV;
-        int rowOffset = i * width * 2;  // YUV422의 각 픽셀은 2바이트 사용
-        
-        // 한 행씩 처리
-        for (int j = 0; j < width / 2; j++) {
-            int pixelOffset = rowOffset + j * 4;  // 2개 픽셀마다 4바이트 (Y0 U Y1 V)
-            
-            pY0 = pp + pixelOffset;
-            pU = pY0 + 1;
-            pY1 = pY0 + 2;
-            pV = pY0 + 3;
-            
-            // 밝기 값 가져오기 (이미 테이블에서 밝기 보정 적용됨)
-            int Y0 = table_Y[*pY0];
-            int Y1 = table_Y[*pY1];
-            int U = *pU;
-            int V = *pV;
-            
-            // RGB 값 계산
-            int R0 = Y0 + table_Cr_red[V];
-            int G0 = Y0 + table_Cb_green[U] + table_Cr_green[V];
-            int B0 = Y0 + table_Cb_blue[U];
-            
-            int R1 = Y1 + table_Cr_red[V];
-            int G1 = Y1 + table_Cb_green[U] + table_Cr_green[V];
-            int B1 = Y1 + table_Cb_blue[U];
-            
-            // 색상 보정: 붉은기 약간 증가
-            R0 = qBound(0, (int)(R0), 255);   // 빨간색 25% 증가
-            G0 = qBound(0, (int)(G0), 255);   // 녹색 15% 감소
-            B0 = qBound(0, (int)(B0), 255);   // 파란색 15% 감소
-            
-            R1 = qBound(0, (int)(R1), 255);   // 빨간색 25% 증가
-            G1 = qBound(0, (int)(G1), 255);   // 녹색 15% 감소
-            B1 = qBound(0, (int)(B1), 255);   // 파란색 15% 감소
-            
-            // 픽셀 설정
-            rgbImage.setPixel(j * 2, i, qRgb(R0, G0, B0));
-            rgbImage.setPixel(j * 2 + 1, i, qRgb(R1, G1, B1));
-        }
-    }
-}
-
-QImage V4L2Camera::getCurrentFrame()
-{
-    QImage result;
-    frameMutex.lock();
-    result = currentFrame.copy();
-    frameMutex.unlock();
-    return result;
+
+    if (factor > 1) {
+        int bytesPerLine = fmt.fmt.pix.bytesperline ? fmt.fmt.pix.bytesperline : width * 2;
+        if (bytesPerLine < width * 2 || size < bytesPerLine * height)
+            return false;
+        YuvConverter::yuyvToRgb888Subsampled(src, bytesPerLine, width, height, factor, back, &correction);
+    } else {
+        // 협상된 포맷의 디코더로 scanLine()에 직접 변환
+        FrameDecoder::Layout layout;
+        layout.pixelFormat = fmt.fmt.pix.pixelformat;
+        layout.width = width;
+        layout.height = height;
+        layout.bytesPerLine = fmt.fmt.pix.bytesperline;
+        layout.correction = &correction;
+
+        if (!decoder->decode(src, size, layout, back)) {
+            // 손상된 프레임(MJPEG 등)은 게시하지 않음
+            return false;
+        }
+    }
+
+    trace->record(streamGeneration, sequence, FrameTrace::STAGE_CONVERT);
+
+    // 화이트 밸런스: 보정된 프레임의 격자 점으로 게인을 갱신해 다음 프레임 변환부터 적용
+    if (whiteBalance.update(back)) {
+        correction.setGains(whiteBalance.redGain(), WhiteBalance::UNITY_GAIN, whiteBalance.blueGain());
+    }
+
+    FrameStats &stats = frameStats[backIndex];
+    stats.sourceWidth = width;
+    stats.sourceHeight = height;
+    stats.sequence = sequence;
+    stats.stream = streamGeneration;
+    stats.timestampUs = timestampUs;
+    stats.roiValid = sampleCircle(yuyv ? src : NULL, back, stats);
+    updateColorStats(stats);
+
+    // 자동 매칭: 원 평균을 열린 칸 전체와 비교 (확정 시 GUI 스레드로 큐잉)
+    if (stats.roiValid && autoMatcher.isActive()) {
+        int matched = autoMatcher.process(stats.avgRed, stats.avgGreen, stats.avgBlue);
+        if (matched >= 0) {
+            emit autoMatchFound(matched, QColor(stats.avgRed, stats.avgGreen, stats.avgBlue));
+        }
+    }
+
+    // 변환이 끝난 back 버퍼를 middle로 게시하고, 이전 middle을 다음 back으로 사용
+    int prev = middleState.exchange(backIndex | FRAME_FRESH_BIT, std::memory_order_acq_rel);
+    backIndex = prev & FRAME_INDEX_MASK;
+    trace->record(streamGeneration, sequence, FrameTrace::STAGE_PUBLISH);
+
+    publishedFrames.fetch_add(1, std::memory_order_relaxed);
+    if (prev & FRAME_FRESH_BIT) {
+        // 이전 게시 프레임을 GUI가 가져가지 못한 채 교체됨
+        overwrittenFrames.fetch_add(1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+void V4L2Camera::updateColorStats(FrameStats &stats)
+{
+    // 원 크기가 바뀌었거나 평균이 없으면 이전 누적은 다른 영역의 값이므로 버림
+    if (!stats.roiValid || stats.radiusPercent != stabilizerRadius) {
+        stabilizer.reset();
+        stabilizerRadius = stats.radiusPercent;
+    }
+    if (stats.roiValid) {
+        stabilizer.update(stats.avgRed, stats.avgGreen, stats.avgBlue);
+    }
+
+    if (stabilizer.isValid()) {
+        stats.smoothRed = stabilizer.red();
+        stats.smoothGreen = stabilizer.green();
+        stats.smoothBlue = stabilizer.blue();
+    } else {
+        stats.smoothRed = stats.avgRed;
+        stats.smoothGreen = stats.avgGreen;
+        stats.smoothBlue = stats.avgBlue;
+    }
+    stats.colorDeviation = stabilizer.deviation();
+    stats.colorStable = stabilizer.isStable();
+}
+
+bool V4L2Camera::sampleCircle(const uchar *src, const QImage &rgb, FrameStats &stats)
+{
+    int percent = roiRadiusPercent.load(std::memory_order_relaxed);
+    stats.radiusPercent = percent;
+    stats.avgRed = stats.avgGreen = stats.avgBlue = 0;
+    stats.pixelCount = 0;
+    if (percent <= 0)
+        return false;
+
+    int width = stats.sourceWidth;
+    int height = stats.sourceHeight;
+
+    // 위젯의 safeRadius / safeX / safeY 계산과 동일
+    int radius = qMin((width * percent) / 100, qMin(width / 2, height / 2));
+    if (radius <= 0)
+        return false;
+    int centerX = qBound(radius, width / 2, width - radius);
+    int centerY = qBound(radius, height / 2, height - radius);
+
+    qint64 sum[3] = { 0, 0, 0 };
+    int count = 0;
+
+    if (src) {
+        // YUYV 버퍼에서 원 내부만 직접 변환 (축소 여부와 무관하게 원본 해상도 기준)
+        int bytesPerLine = fmt.fmt.pix.bytesperline ? fmt.fmt.pix.bytesperline : width * 2;
+        count = YuvConverter::yuyvCircleSum(src, bytesPerLine, width, height, centerX, centerY, radius, sum,
+                                            &correction);
+    } else {
+        // 그 외 포맷은 이미 변환된 원본 해상도 RGB 이미지에서 행 구간 단위로 합산
+        int r2 = radius * radius;
+        for (int dy = -radius; dy < radius; dy++) {
+            int rem = r2 - dy * dy;
+            int span = 0;
+            while ((span + 1) * (span + 1) <= rem) span++;
+
+            int x0 = centerX - span;
+            int x1 = qMin(centerX + span, centerX + radius - 1);
+            const uchar *line = rgb.constScanLine(centerY + dy) + x0 * 3;
+            for (int x = x0; x <= x1; x++) {
+                sum[0] += line[0];
+                sum[1] += line[1];
+                sum[2] += line[2];
+                line += 3;
+            }
+            count += x1 - x0 + 1;
+        }
+    }
+
+    if (count <= 0)
+        return false;
+
+    stats.avgRed = (int)(sum[0] / count);
+    stats.avgGreen = (int)(sum[1] / count);
+    stats.avgBlue = (int)(sum[2] / count);
+    stats.pixelCount = count;
+    return true;
+}
+
+QImage V4L2Camera::getCurrentFrame(FrameStats *stats)
+{
+    // 작업 스레드가 프레임 버퍼를 할당하는 중
+    if (isOpening()) {
+        if (stats) {
+            memset(stats, 0, sizeof(*stats));
+        }
+        return QImage();
+    }
+
+    // 새로 게시된 프레임이 있으면 front와 교환 (잠금 없음)
+    if (middleState.load(std::memory_order_acquire) & FRAME_FRESH_BIT) {
+        int prev = middleState.exchange(frontIndex, std::memory_order_acq_rel);
+        frontIndex = prev & FRAME_INDEX_MASK;
+        deliveredFrames.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (stats) {
+        *stats = frameStats[frontIndex];
+    }
+
+    // QImage 암시적 공유로 깊은 복사 없이 핸들만 반환
+    return frameBuffers[frontIndex];
 }
 
 int V4L2Camera::xioctl(int fh, int request, void *arg)
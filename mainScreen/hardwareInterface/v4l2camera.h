@@ -3,9 +3,70 @@
 
 #include <QObject>
 #include <QImage>
-#include <QMutex>
 #include <linux/videodev2.h>
 #include <pthread.h>
+#include <atomic>
+#include <functional>
+#include "utils/framedecoder.h"
+#include "utils/automatcher.h"
+#include "utils/colorstabilizer.h"
+#include "utils/colorcorrection.h"
+#include "utils/whitebalance.h"
+
+class CameraSource;
+class CameraRecorder;
+class FrameTrace;
+
+// 드라이버 버퍼를 복사 없이 전달하기 위한 원시 프레임 정보
+// (핸들러 호출 동안에만 유효하며, 반환 후 버퍼는 드라이버에 다시 큐잉된다)
+struct RawFrame {
+    const void *data;       // mmap된 버퍼 주소
+    size_t bytesUsed;       // 유효 데이터 크기
+    int dmabufFd;           // VIDIOC_EXPBUF로 내보낸 DMABUF fd (비활성 시 -1)
+    unsigned int index;     // 드라이버 버퍼 인덱스
+    quint32 sequence;       // 드라이버 프레임 시퀀스 번호
+    qint64 timestampUs;     // 드라이버 타임스탬프 (CLOCK_MONOTONIC, us)
+    quint32 pixelFormat;    // V4L2_PIX_FMT_*
+    int width;
+    int height;
+    int bytesPerLine;
+};
+
+typedef std::function<void(const RawFrame &)> RawFrameHandler;
+
+// 캡처 스레드에서 프레임과 함께 계산해 게시하는 통계
+struct FrameStats {
+    bool roiValid;          // 샘플링 원 평균이 계산되었는지
+    int radiusPercent;      // 계산에 사용한 샘플링 원 반지름 (%)
+    int avgRed;             // 샘플링 원 내부 평균 RGB
+    int avgGreen;
+    int avgBlue;
+    int pixelCount;         // 평균에 포함된 픽셀 수
+    int smoothRed;          // 프레임 간 지수 이동 평균 RGB (캡처에 사용)
+    int smoothGreen;
+    int smoothBlue;
+    float colorDeviation;   // 최근 프레임 원 평균의 표준편차 (RGB 단위, ColorStabilizer)
+    bool colorStable;       // 평균 색이 흔들리지 않고 안정됨
+    int sourceWidth;        // 축소 전 캡처 해상도
+    int sourceHeight;
+    quint32 sequence;       // 드라이버 프레임 시퀀스 번호
+    quint32 stream;         // 스트림 세대 (시퀀스 번호가 다시 시작될 때마다 증가, FrameTrace 키)
+    qint64 timestampUs;     // 드라이버 타임스탬프 (us)
+};
+
+// 프레임 전달 경로의 누적 통계 (getPipelineStats)
+struct PipelineStats {
+    quint64 publishedFrames;        // 캡처 스레드가 게시한 프레임
+    quint64 deliveredFrames;        // GUI 스레드가 실제로 가져간 새 프레임
+    quint64 coalescedFrames;        // 알림이 이미 대기 중이라 하나로 합쳐진 프레임
+    quint64 overwrittenFrames;      // GUI가 가져가기 전에 더 새 프레임으로 덮어쓰인 프레임
+    quint64 staleDriverFrames;      // 최신 프레임만 처리하려고 버린 드라이버 버퍼
+    quint64 driverDroppedFrames;    // 드라이버 시퀀스 번호 공백으로 추정한 손실 프레임
+    quint64 stallsDetected;         // 감시기가 감지한 정지 (타임스탬프 공백 포함)
+    quint64 requeueRecoveries;      // 버퍼 재큐잉으로 복구
+    quint64 restreamRecoveries;     // STREAMOFF/STREAMON으로 복구
+    quint64 reopenRecoveries;       // 장치 재열기로 복구
+};
 
 class V4L2Camera : public QObject
 {
@@ -20,41 +81,203 @@ public:
     void closeCamera();
     bool startCapturing();
     void stopCapturing();
-    QImage getCurrentFrame();
-    bool isCameraCapturing() const { return isCapturing; }
-    int getfd() const { return fd; }
+    // 장치 열기, 포맷 협상, mmap, STREAMON을 작업 스레드에서 수행하고 완료되면 cameraReady 발생
+    // (진행 중에 다시 호출하면 같은 결과를 기다리고, 이미 캡처 중이면 바로 cameraReady(true))
+    void startCapturingAsync();
+    bool isOpening() const { return opening.load(std::memory_order_acquire); }
+    // 가장 최근 프레임의 공유 핸들 반환 (복사/잠금 없음, 읽기 전용으로 사용할 것)
+    // 소비자는 카메라 객체가 속한 스레드(GUI 스레드) 하나뿐이라고 가정한다
+    // stats가 주어지면 같은 프레임의 통계를 함께 반환
+    QImage getCurrentFrame(FrameStats *stats = NULL);
+    bool isCameraCapturing() const { return isCapturing && !isOpening(); }
+    int getfd() const;
+
+    // 실제 장치 대신 사용할 프레임 공급원 (소유권 이전, NULL이면 실제 장치)
+    // 기본값은 COLORBINGO_CAMERA_SOURCE 환경 변수로 결정된다 (camerasource.h 참고)
+    void setSource(CameraSource *newSource);
+    // 캡처한 원시 프레임을 재생 가능한 파일로 기록 (빈 경로면 중지, 기본값은 COLORBINGO_CAMERA_RECORD)
+    void setRecordingPath(const QString &path);
+
+    // 드라이버에 요청할 프레임 레이트 (openCamera 전에 설정)
+    void setFrameRate(int fps) { frameRate = fps; }
+    // 목표 해상도와 우선 픽셀 포맷 (0이면 변환 비용 기준 자동 선택, openCamera 전에 설정)
+    void setResolution(int width, int height) { preferredWidth = width; preferredHeight = height; }
+    void setPreferredPixelFormat(quint32 pixelFormat) { preferredPixelFormat = pixelFormat; }
+    // ROI 모드: 화면 중앙 샘플링 원(반지름 = 너비의 radiusPercent %)의 평균을 캡처 스레드에서 계산
+    // 0이면 비활성 (캡처 중에도 변경 가능)
+    void setSamplingCircle(int radiusPercent) { roiRadiusPercent.store(radiusPercent, std::memory_order_relaxed); }
+    // 게시 프레임을 1/factor 해상도 미리보기로 변환 (1, 2, 4; YUYV에서만 적용, 캡처 중에도 변경 가능)
+    void setPreviewDownscale(int factor) { previewDownscale.store(factor, std::memory_order_relaxed); }
+    // false면 캡처 스레드가 버퍼를 디큐/재큐잉만 하고 RGB 변환과 newFrameAvailable을 생략
+    // (스트리밍과 정지 감시는 유지, 캡처 중에도 변경 가능)
+    void setConversionEnabled(bool enabled) { conversionEnabled.store(enabled, std::memory_order_relaxed); }
+    // 연속 자동 매칭: 목표 칸을 설정하면 캡처 스레드가 매 프레임 원 평균을 비교하고
+    // 확정되면 autoMatchFound 발생 (ROI 모드가 켜져 있어야 함)
+    AutoMatcher *getAutoMatcher() { return &autoMatcher; }
+    // 소프트웨어 화이트 밸런스 게인 고정 (빙고판 생성 시 잠가서 판 색과 캡처 색이 같은 보정을 거치게 함)
+    void setWhiteBalanceLocked(bool locked) { whiteBalance.setLocked(locked); }
+    bool isWhiteBalanceLocked() const { return whiteBalance.isLocked(); }
+    // 화이트 밸런스 게인을 1.0으로 되돌림 (캡처 스레드가 다음 프레임에서 반영)
+    void resetWhiteBalance() { whiteBalance.requestReset(); }
+    // 협상된 캡처 포맷 (V4L2_PIX_FMT_*)
+    quint32 getPixelFormat() const { return fmt.fmt.pix.pixelformat; }
+    // VIDIOC_EXPBUF로 버퍼를 DMABUF fd로 내보낼지 여부 (openCamera 전에 설정)
+    void setDmaBufExportEnabled(bool enabled) { dmaBufExportEnabled = enabled; }
+    // 캡처 스레드에서 디큐된 버퍼를 복사 없이 받을 핸들러 (startCapturing 전에 설정)
+    void setRawFrameHandler(RawFrameHandler handler) { rawFrameHandler = handler; }
+    // 최신 프레임만 처리하기 위해 버린 오래된 드라이버 버퍼 수
+    quint64 getStaleFrameCount() const { return staleFrameCount.load(std::memory_order_relaxed); }
+    // 게시/전달/합쳐짐/손실 프레임 통계
+    PipelineStats getPipelineStats() const;
+    // 이 시간 동안 새 프레임이 없으면 정지로 보고 복구 (ms, 0이면 감시 비활성, startCapturing 전에 설정)
+    void setStallTimeout(int ms) { stallTimeoutMs = ms; }
 
 signals:
+    // startCapturingAsync 완료 (ok면 캡처 중)
+    void cameraReady(bool ok);
+    // 최신 프레임이 준비됨 (동시에 대기 중인 알림은 최대 1개, GUI 스레드에서 발생)
     void newFrameAvailable();
+    // 장치가 응답하지 않아 재열기 단계에 들어감 (캡처 스레드가 계속 재연결을 시도)
     void deviceDisconnected();
+    // deviceDisconnected 이후 프레임이 다시 들어옴
+    void deviceRecovered();
+    // 자동 매칭이 칸을 확정함 (index는 AutoMatcher::setTargets 순서, color는 확정 프레임의 원 평균)
+    void autoMatchFound(int index, const QColor &color);
+
+private slots:
+    void deliverFrameNotification();
+    void finishAsyncOpen();
 
 private:
+    // 포맷 협상 후보 (ENUM_FMT / ENUM_FRAMESIZES / ENUM_FRAMEINTERVALS 결과)
+    struct FormatCandidate {
+        quint32 pixelFormat;
+        int width;
+        int height;
+        int maxFps;         // 해당 해상도의 최대 fps (알 수 없으면 0)
+        int cpuCost;
+    };
+
     void initDevice();
+    bool startStreaming();
+    void stopStreaming();
+    bool negotiateFormat(FormatCandidate &best);
+    bool pickFrameSize(quint32 pixelFormat, int &width, int &height);
+    int queryMaxFps(quint32 pixelFormat, int width, int height);
+    bool isBetterCandidate(const FormatCandidate &a, const FormatCandidate &b) const;
+    int sizeRank(int width, int height) const;
     void uninitDevice();
     void initMMAP();
-    bool readFrame();
-    void processImage(const void *p, int size);
+    bool readFrame(bool &dequeued);
+    bool openSource();
+    void loadColorLut(const QString &cardName);
+    bool readSourceFrame(bool &dequeued);
+    void deliverRawFrame(const RawFrame &raw);
+    bool processImage(const void *p, int size, quint32 sequence, qint64 timestampUs);
+    bool sampleCircle(const uchar *src, const QImage &rgb, FrameStats &stats);
+    void updateColorStats(FrameStats &stats);
+    bool dequeueLatest(struct v4l2_buffer &latest);
+    void handleDequeueError(int error);
+    bool noteFrame(quint32 sequence, qint64 timestampUs);
+    void runWatchdog(bool fdFailing);
+    bool requeueBuffers();
+    bool restartStreaming();
+    bool reopenDevice();
+    bool waitForWake(int timeoutMs);
+    void notifyFrame();
+    void exportDmaBufs();
+    void closeEventFds();
     int xioctl(int fh, int request, void *arg);
-    void yuv422ToRgb888(const void *yuv, QImage &rgbImage);
+    void resetFrameBuffers();
 
+    static void *openThreadFunc(void *arg);
+    void joinOpenThread();
     static void *captureThreadFunc(void *arg);
     void captureThreadLoop();
 
     struct Buffer {
         void *start;
         size_t length;
+        int dmabufFd;       // VIDIOC_EXPBUF 결과 (미사용 시 -1)
     };
 
     int fd;
     struct v4l2_format fmt;
     struct Buffer *buffers;
     unsigned int n_buffers;
-    bool isCapturing;
-    QImage currentFrame;
-    QMutex frameMutex;
+    std::atomic<bool> isCapturing;   // 비동기 열기 중에는 작업 스레드가 설정
+
+    // 트리플 버퍼: 캡처 스레드는 back에 쓰고 middle과 원자적으로 교환하여 게시,
+    // 소비자는 새 프레임이 있으면 front와 middle을 교환한 뒤 front를 공유한다
+    static const int FRAME_BUFFER_COUNT = 3;
+    static const int FRAME_INDEX_MASK = 0x3;
+    static const int FRAME_FRESH_BIT = 0x4;
+    QImage frameBuffers[FRAME_BUFFER_COUNT];
+    FrameStats frameStats[FRAME_BUFFER_COUNT];  // 각 버퍼와 함께 교환되는 통계
+    int backIndex;                   // 캡처 스레드 전용
+    int frontIndex;                  // 소비자 스레드 전용
+    std::atomic<int> middleState;    // middle 버퍼 인덱스 | FRAME_FRESH_BIT
+    pthread_t openThread;            // startCapturingAsync 작업 스레드
+    bool openThreadRunning;          // join 전인 작업 스레드가 있음 (GUI 스레드 전용)
+    std::atomic<bool> opening;       // 비동기 열기가 끝나 GUI가 결과를 받을 때까지 true
+    std::atomic<bool> asyncOpenOk;
     pthread_t captureThread;
-    bool stopThread;
+    std::atomic<bool> stopThread;
+    int epollFd;                     // 장치 fd + 종료용 eventfd 대기
+    int wakeFd;                      // stopCapturing에서 캡처 스레드를 깨우는 eventfd
     QString devicePath;
+
+    CameraSource *source;            // NULL이면 실제 V4L2 장치 사용
+    CameraRecorder *recorder;        // NULL이면 기록하지 않음
+    FrameTrace *trace;               // 단계별 타임스탬프 기록 (비활성이면 기록 생략)
+
+    int frameRate;
+    int preferredWidth;
+    int preferredHeight;
+    quint32 preferredPixelFormat;
+    const FrameDecoder::Entry *decoder;  // 드라이버가 확정한 포맷의 디코더 (미지원이면 NULL)
+    ColorCorrection correction;      // 화이트 밸런스 게인 + 카메라 모델별 LUT (캡처 스레드에서 사용)
+    bool colorLutLoaded;             // LUT 검색을 이미 했음 (재열기 복구 때 다시 읽지 않음)
+    WhiteBalance whiteBalance;       // 게인 추정 (update는 캡처 스레드, 잠금은 GUI 스레드)
+    bool dmaBufExportEnabled;
+    RawFrameHandler rawFrameHandler;
+    std::atomic<quint64> staleFrameCount;
+
+    // 알림 합치기: 대기 중인 알림이 있으면 새로 보내지 않고 GUI가 최신 프레임을 가져가게 함
+    std::atomic<bool> notifyPending;
+    std::atomic<quint64> publishedFrames;
+    std::atomic<quint64> deliveredFrames;
+    std::atomic<quint64> coalescedFrames;
+    std::atomic<quint64> overwrittenFrames;
+    std::atomic<quint64> driverDroppedFrames;
+    quint32 lastSequence;            // 캡처 스레드 전용
+    bool haveLastSequence;
+    quint32 streamGeneration;        // 스트림 시작/재시작/재생 반복으로 시퀀스가 되돌아갈 때마다 증가 (캡처 스레드 전용)
+
+    // 정지 감시기: 시퀀스/타임스탬프가 멈추면 재큐잉 → 스트림 재시작 → 장치 재열기 순으로 복구
+    enum RecoveryLevel {
+        RECOVERY_NONE = 0,
+        RECOVERY_REQUEUE,
+        RECOVERY_RESTREAM,
+        RECOVERY_REOPEN
+    };
+    static const int WATCHDOG_TICK_MS = 250;   // 프레임이 없을 때 감시기 판정 주기
+    int stallTimeoutMs;
+    qint64 lastTimestampUs;          // 이하 캡처 스레드 전용
+    qint64 lastProgressUs;           // 마지막으로 진행이 확인된 시각 (CLOCK_MONOTONIC)
+    RecoveryLevel recoveryLevel;
+    bool deviceLost;                 // DQBUF가 ENODEV를 반환함
+    bool disconnectNotified;         // deviceDisconnected를 보냈음
+    std::atomic<quint64> stallsDetected;
+    std::atomic<quint64> requeueRecoveries;
+    std::atomic<quint64> restreamRecoveries;
+    std::atomic<quint64> reopenRecoveries;
+    std::atomic<int> roiRadiusPercent;
+    std::atomic<int> previewDownscale;
+    std::atomic<bool> conversionEnabled;
+    AutoMatcher autoMatcher;
+    ColorStabilizer stabilizer;      // 캡처 스레드 전용
+    int stabilizerRadius;            // stabilizer가 누적 중인 원 크기 (캡처 스레드 전용)
 };
 
 #endif // V4L2CAMERA_H 
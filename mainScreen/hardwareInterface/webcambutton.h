@@ -2,43 +2,10 @@
 #define WEBCAMBUTTON_H
 
 #include <QObject>
-#include <QFile>
-#include <QSocketNotifier>
-#include <QThread>
-#include <QMutex>
-#include <linux/input.h>
 #include <QDebug>
+#include "hardwareInterface/inputhub.h"
 
-// 버튼 이벤트 읽기를 담당할 스레드 클래스
-class ButtonReaderThread : public QThread
-{
-    Q_OBJECT
-    
-public:
-    ButtonReaderThread(QObject *parent = nullptr);
-    ~ButtonReaderThread();
-    
-    // 스레드 시작 전 초기화
-    bool initialize();
-    void stopReading();
-
-signals:
-    // 버튼 누름 이벤트 발생 시 신호
-    void buttonPressed(int keyCode);
-
-protected:
-    // 스레드 실행 함수
-    void run() override;
-    
-private:
-    // 웹캠 버튼 디바이스 파일 경로 찾기
-    QString findWebcamButtonDevice();
-    
-    QString devicePath;
-    bool stopRequested;
-    QMutex mutex;
-};
-
+// 웹캠 물리 버튼 (InputHub 스레드가 버튼 장치를 epoll로 기다려 누르는 즉시 전달)
 class WebcamButton : public QObject
 {
     Q_OBJECT
@@ -54,15 +21,17 @@ public:
     bool isInitialized() const;
 
 signals:
-    // 특정 목적 버튼이 눌렸을 때의 신호
+    // 특정 목적 버튼이 눌렸을 때의 신호 (InputHub 스레드에서 발생하므로 큐드 연결로 받을 것)
     void captureButtonPressed();
 
-private slots:
-    // 버튼 누름 이벤트 처리
-    void handleButtonPressed(int keyCode);
-
 private:
-    ButtonReaderThread *readerThread;  // 버튼 읽기 스레드
+    // 버튼 누름 이벤트 처리 (InputHub 스레드)
+    void handleKeyEvent(const InputHub::KeyEvent &event);
+    // 웹캠 버튼 디바이스 파일 경로 찾기
+    QString findWebcamButtonDevice();
+    void release();
+
+    int deviceId;                      // InputHub 장치 id (-1이면 미등록)
     QString deviceFilePath;            // 장치 파일 경로
     bool initialized;                 // 초기화 상태
 };
@@ -1,8 +1,20 @@
 #include "mainwindow.h"
+#include "utils/replaybenchmark.h"
 #include <QApplication>
+#include <stdlib.h>
+#include <string.h>
 
 int main(int argc, char *argv[])
 {
+    // 화면 없이 녹화 파일로 캡처 파이프라인만 측정: --replay-benchmark <파일> [프레임 수]
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--replay-benchmark") == 0) {
+            QCoreApplication app(argc, argv);
+            int frames = (i + 2 < argc) ? atoi(argv[i + 2]) : 0;
+            return runReplayBenchmark(QString::fromLocal8Bit(argv[i + 1]), frames);
+        }
+    }
+
     QApplication a(argc, argv);
     MainWindow w;
     w.show();
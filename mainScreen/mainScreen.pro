@@ -20,6 +20,15 @@ LIBS += -L/home/user/work/alsa/install/lib -lasound
 LIBS += -lpthread
 RESOURCES += resources/resources.qrc
 
+# YUYV 변환 NEON 커널: 32비트 ARM 빌드에서만 명시적으로 NEON 활성화 (aarch64는 기본 지원)
+equals(QT_ARCH, arm): QMAKE_CXXFLAGS += -mfpu=neon-vfpv4
+
+# MJPEG 디코딩에 libjpeg-turbo 사용 (qmake CONFIG+=turbojpeg), 없으면 Qt JPEG 플러그인으로 대체
+turbojpeg {
+    DEFINES += HAVE_TURBOJPEG
+    LIBS += -lturbojpeg
+}
+
 SOURCES += main.cpp\
     mainwindow.cpp \
     ui/widgets/bingowidget.cpp \
@@ -27,11 +36,35 @@ SOURCES += main.cpp\
     ui/widgets/multigamewidget.cpp \
     hardwareInterface/webcambutton.cpp \
     hardwareInterface/v4l2camera.cpp \
+    hardwareInterface/camerasource.cpp \
+    hardwareInterface/cameraservice.cpp \
     hardwareInterface/accelerometer.cpp \
+    hardwareInterface/inputhub.cpp \
     p2pnetwork.cpp \
     matchingwidget.cpp \
     hardwareInterface/SoundManager.cpp \
-    utils/pixelartgenerator.cpp
+    hardwareInterface/audioengine.cpp \
+    utils/pixelartgenerator.cpp \
+    utils/yuvconverter.cpp \
+    utils/framedecoder.cpp \
+    utils/summedareatable.cpp \
+    utils/frametrace.cpp \
+    utils/replaybenchmark.cpp \
+    utils/previewrenderer.cpp \
+    utils/colormatcher.cpp \
+    utils/automatcher.cpp \
+    utils/colorstabilizer.cpp \
+    utils/paletteextractor.cpp \
+    utils/colorlut.cpp \
+    utils/colorcorrection.cpp \
+    utils/whitebalance.cpp \
+    utils/soundbank.cpp \
+    utils/audiomixer.cpp \
+    utils/imaadpcm.cpp \
+    ui/widgets/frametracehud.cpp \
+    ui/widgets/colorswatchlabel.cpp \
+    ui/widgets/colorhandleslider.cpp \
+    ui/widgets/cameraview.cpp
 
 
 HEADERS  += mainwindow.h \
@@ -39,12 +72,37 @@ HEADERS  += mainwindow.h \
     ui/widgets/bingopreparationwidget.h \
     ui/widgets/multigamewidget.h \
     hardwareInterface/v4l2camera.h \
+    hardwareInterface/camerasource.h \
+    hardwareInterface/cameraservice.h \
     hardwareInterface/webcambutton.h \
     hardwareInterface/accelerometer.h \
+    hardwareInterface/inputhub.h \
     matchingwidget.h \
     p2pnetwork.h \
     hardwareInterface/SoundManager.h \
-    utils/pixelartgenerator.h
+    hardwareInterface/audioengine.h \
+    utils/pixelartgenerator.h \
+    utils/yuvconverter.h \
+    utils/framedecoder.h \
+    utils/summedareatable.h \
+    utils/frametrace.h \
+    utils/replaybenchmark.h \
+    utils/previewrenderer.h \
+    utils/colormatcher.h \
+    utils/automatcher.h \
+    utils/colorstabilizer.h \
+    utils/paletteextractor.h \
+    utils/colorlut.h \
+    utils/colorcorrection.h \
+    utils/whitebalance.h \
+    utils/soundbank.h \
+    utils/spscqueue.h \
+    utils/audiomixer.h \
+    utils/imaadpcm.h \
+    ui/widgets/frametracehud.h \
+    ui/widgets/colorswatchlabel.h \
+    ui/widgets/colorhandleslider.h \
+    ui/widgets/cameraview.h
 
 FORMS += mainwindow.ui
 
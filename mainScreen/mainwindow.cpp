@@ -2,6 +2,7 @@
 #include "ui_mainwindow.h"
 #include "hardwareInterface/SoundManager.h"
 #include "ui/widgets/bingopreparationwidget.h"
+#include "hardwareInterface/cameraservice.h"
 #include "background.h"  // 내장된 배경 리소스 포함
 #include <QDebug>
 #include <QThread>
@@ -268,28 +269,7 @@ void MainWindow::showBingoScreen()
 {
     qDebug() << "DEBUG: Single Game button clicked";
     
-    // 현재 멀티게임 위젯이 활성화되어 있다면 카메라 리소스 해제
-//    if (multiGameWidget && stackedWidget->currentWidget() == multiGameWidget) {
-//        qDebug() << "DEBUG: Ensuring MultiGameWidget camera is stopped";
-        
-//        // 카메라 리소스 완전 해제를 위한 명시적 처리 (임시 대기)
-//        QThread::msleep(500);
-//    }
-    
-    // 기존 bingoWidget이 있고 카메라가 실행 중이라면 리소스 해제
-//    if (bingoWidget && bingoWidget->isCameraCapturing()) {
-    if ((bingoWidget && bingoWidget->isCameraCapturing()) || (multiGameWidget && multiGameWidget->isCameraCapturing())) {
-        qDebug() << "DEBUG: Ensuring BingoWidget camera is stopped";
-        V4L2Camera* camera = bingoWidget->getCamera();
-        if (camera) {
-            camera->stopCapturing();
-            camera->closeCamera();
-            qDebug() << "DEBUG: BingoWidget camera explicitly stopped";
-        }
-        
-        // Wait time for complete camera resource release
-        QThread::msleep(500);
-    }
+    // 게임 화면은 숨겨질 때(hideEvent) 공유 카메라 구독만 해제하므로 장치를 닫거나 기다릴 필요 없음
     
     // 기존 colorCaptureWidget이 없으면 생성
     if (!colorCaptureWidget) {
@@ -364,28 +344,7 @@ void MainWindow::showMultiGameScreen()
 {
     qDebug() << "DEBUG: Show Multi Game Screen";
 
-    // 현재 멀티게임 위젯이 활성화되어 있다면 카메라 리소스 해제
-//    if (multiGameWidget && stackedWidget->currentWidget() == multiGameWidget) {
-//        qDebug() << "DEBUG: Ensuring MultiGameWidget camera is stopped";
-
-//        // 카메라 리소스 완전 해제를 위한 명시적 처리 (임시 대기)
-//        QThread::msleep(500);
-//    }
-
-    // 기존 multiGameWidget이 있고 카메라가 실행 중이라면 리소스 해제
-//    if (multiGameWidget && multiGameWidget->isCameraCapturing()) {
-    if ((bingoWidget && bingoWidget->isCameraCapturing()) || (multiGameWidget && multiGameWidget->isCameraCapturing())) {
-        qDebug() << "DEBUG: Ensuring BingoWidget camera is stopped";
-        V4L2Camera* camera = multiGameWidget->getCamera();
-        if (camera) {
-            camera->stopCapturing();
-            camera->closeCamera();
-            qDebug() << "DEBUG: BingoWidget camera explicitly stopped";
-        }
-
-        // Wait time for complete camera resource release
-        QThread::msleep(500);
-    }
+    // 게임 화면은 숨겨질 때(hideEvent) 공유 카메라 구독만 해제하므로 장치를 닫거나 기다릴 필요 없음
 
     // 기존 colorCaptureWidget이 없으면 생성
     if (!colorCaptureWidget) {
@@ -416,14 +375,10 @@ void MainWindow::onCreateBingoRequested(const QList<QColor> &colors)
 {
     qDebug() << "DEBUG: Create Bingo requested with" << colors.size() << "colors";
     
-    // Release camera resources - fully close
+    // 준비 화면의 카메라 구독 해제 (장치는 계속 스트리밍하므로 대기 불필요)
     if (colorCaptureWidget) {
         qDebug() << "DEBUG: Stopping camera before creating BingoWidget";
         colorCaptureWidget->stopCameraCapture();
-        
-        // Wait time for camera resource release
-        qDebug() << "DEBUG: Waiting for camera resources to be fully released";
-        QThread::msleep(1500); // Wait 1.5 seconds
     }
     
     // Safely clean up existing bingoWidget if present
@@ -504,14 +459,10 @@ void MainWindow::checkIfBothPlayersReady() {
         // ✅ 중복 실행 방지 플래그 설정
         isMultiGameStarted = true;
 
-        // Release camera resources - fully close
+        // 준비 화면의 카메라 구독 해제 (장치는 계속 스트리밍하므로 대기 불필요)
         if (colorCaptureWidget) {
             qDebug() << "DEBUG: Stopping camera before creating MultiGameWidget";
             colorCaptureWidget->stopCameraCapture();
-
-            // Wait time for camera resource release
-            qDebug() << "DEBUG: Waiting for camera resources to be fully released";
-            QThread::msleep(1500); // Wait 1.5 seconds
         }
 
         // Safely clean up existing bingoWidget if present
@@ -553,31 +504,10 @@ void MainWindow::showMainMenu()
     
     network->disconnectFromPeer();
 
-    // Ensure widget camera resources are released
+    // 카메라 구독 해제 (게임 화면은 hideEvent에서 해제, 공유 장치는 계속 열어 둠)
     if (colorCaptureWidget && stackedWidget->currentWidget() == colorCaptureWidget) {
         qDebug() << "DEBUG: Stopping BingoPreparationWidget camera before returning to main menu";
         colorCaptureWidget->stopCameraCapture();
-        QThread::msleep(500);
-    }
-    
-    if (bingoWidget && bingoWidget->isCameraCapturing()) {
-        qDebug() << "DEBUG: Stopping BingoWidget camera before returning to main menu";
-        V4L2Camera* camera = bingoWidget->getCamera();
-        if (camera) {
-            camera->stopCapturing();
-            camera->closeCamera();
-        }
-        QThread::msleep(500);
-    }
-    
-    if (multiGameWidget && multiGameWidget->isCameraCapturing()) {
-        qDebug() << "DEBUG: Stopping MultiGameWidget camera before returning to main menu";
-        V4L2Camera* camera = multiGameWidget->getCamera();
-        if (camera) {
-            camera->stopCapturing();
-            camera->closeCamera();
-        }
-        QThread::msleep(500);
     }
     
     // ✅ P2P 네트워크 연결 해제 (매칭 중단)
@@ -782,6 +712,7 @@ MainWindow::~MainWindow()
 
     // Clean up sound resources
     SoundManager::getInstance()->cleanup();
+    CameraService::getInstance()->cleanup();
     
     qDebug() << "DEBUG: MainWindow destructor completed";
 }
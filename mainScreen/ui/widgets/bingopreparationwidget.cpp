@@ -1,4 +1,6 @@
 #include "ui/widgets/bingopreparationwidget.h"
+#include "utils/colormatcher.h"
+#include "hardwareInterface/cameraservice.h"
 #include <QDebug>
 #include <QMessageBox>
 #include <QPainter>
@@ -14,6 +16,7 @@ BingoPreparationWidget::BingoPreparationWidget(QWidget *parent) :
     buttonPanel(nullptr),
     camera(nullptr),
     isCapturing(false),
+    previewRenderer(PreviewRenderer::BILINEAR),
     gameMode(GameMode::SINGLE)  // 기본값으로 SINGLE 모드 설정
 {
     qDebug() << "DEBUG: BingoPreparationWidget constructor starting";
@@ -26,7 +29,7 @@ BingoPreparationWidget::BingoPreparationWidget(QWidget *parent) :
     setLayout(nullptr);
     
     // 카메라 뷰 생성 (전체 화면)
-    cameraView = new QLabel(this);
+    cameraView = new CameraView(this);
     cameraView->setAlignment(Qt::AlignCenter);
     cameraView->setFrameShape(QFrame::NoFrame);
     cameraView->setText("Camera connecting...");
@@ -87,22 +90,14 @@ BingoPreparationWidget::BingoPreparationWidget(QWidget *parent) :
     connect(createBingoButton, &QPushButton::clicked, this, &BingoPreparationWidget::onCreateBingoClicked);
     connect(backButton, &QPushButton::clicked, this, &BingoPreparationWidget::onBackButtonClicked);
     
-    // 카메라 초기화
-    camera = new V4L2Camera(this);
-    
-    // 카메라 신호 연결
-    connect(camera, &V4L2Camera::newFrameAvailable, this, &BingoPreparationWidget::updateCameraFrame);
-    connect(camera, &V4L2Camera::deviceDisconnected, this, &BingoPreparationWidget::handleCameraDisconnect);
+    // 공유 카메라 (신호 연결은 구독 시 startCamera에서 수행)
+    camera = CameraService::getInstance()->getCamera();
     
     // 초기 사이즈 설정
     resize(parent->size());
     
-    // 카메라 열기는 필요하지만 시작은 showEvent에서 수행
-    if (!camera->openCamera()) {
-        QMessageBox::critical(this, "Error", "Failed to open camera device");
-    } else {
-        qDebug() << "Camera opened successfully";
-    }
+    // 장치는 작업 스레드에서 미리 열고 구독(시작)은 showEvent에서 수행
+    CameraService::getInstance()->warmUp();
     
     qDebug() << "DEBUG: BingoPreparationWidget constructor completed";
 }
@@ -146,25 +141,26 @@ void BingoPreparationWidget::startCamera()
         return;
     }
     
-    // 카메라가 닫혀있으면 다시 열기
-    if (camera->getfd() == -1) {
-        qDebug() << "Camera is closed, reopening";
-        if (!camera->openCamera()) {
-            qDebug() << "Failed to reopen camera";
-            return;
-        }
-        // 카메라 열기 후 약간의 지연
-        QThread::msleep(100);
-    }
-    
-    // 카메라 캡처 시작
-    if (camera->startCapturing()) {
+    // 공유 카메라 구독 (장치가 이미 스트리밍 중이면 즉시 완료)
+    if (CameraService::getInstance()->subscribe(this)) {
+        // 9칸 색상 추출에 원본 해상도 프레임을 사용 (ROI 계산은 불필요)
+        camera->setPreviewDownscale(1);
+        camera->setSamplingCircle(0);
+        // 판을 고르는 동안은 화이트 밸런스가 현재 조명에 맞춰 움직이도록 잠금 해제
+        camera->setWhiteBalanceLocked(false);
+        connect(camera, &V4L2Camera::newFrameAvailable, this, &BingoPreparationWidget::updateCameraFrame, Qt::UniqueConnection);
+        connect(camera, &V4L2Camera::deviceDisconnected, this, &BingoPreparationWidget::handleCameraDisconnect, Qt::UniqueConnection);
+        connect(camera, &V4L2Camera::deviceRecovered, this, &BingoPreparationWidget::handleCameraRecovered, Qt::UniqueConnection);
+        connect(camera, &V4L2Camera::cameraReady, this, &BingoPreparationWidget::handleCameraReady, Qt::UniqueConnection);
         isCapturing = true;
         qDebug() << "Camera capture started successfully";
         
-        // 카메라 뷰 초기화
+        // 카메라 뷰 초기화 (장치가 아직 열리는 중이면 자리 표시)
         if (cameraView) {
             cameraView->clear();
+            if (!CameraService::getInstance()->isReady()) {
+                cameraView->setText("Starting camera...");
+            }
         }
     } else {
         qDebug() << "Failed to start camera capture";
@@ -175,34 +171,24 @@ void BingoPreparationWidget::stopCameraCapture()
 {
     qDebug() << "DEBUG: Stopping camera capture";
     
-    if (camera) {
-        camera->stopCapturing();
-        isCapturing = false;
-        qDebug() << "DEBUG: Camera capture stopped";
-        
-        // 확실한 리소스 해제를 위해 카메라도 닫기
-        camera->closeCamera();
-        qDebug() << "DEBUG: Camera closed completely";
-        
-        // 지연 추가
-        QThread::msleep(100);
-    }
+    // 구독만 해제 (장치는 공유 서비스가 계속 열어 둠)
+    CameraService::getInstance()->unsubscribe(this);
+    isCapturing = false;
+    qDebug() << "DEBUG: Camera capture stopped";
 }
 
 void BingoPreparationWidget::updateCameraFrame() 
 {
     if (!camera || !cameraView) return;
     
-    QImage frame = camera->getCurrentFrame();
+    const QImage frame = camera->getCurrentFrame(); // 공유 핸들 (복사 없음)
     if (!frame.isNull()) {
         // 카메라 프레임 크기를 라벨 크기에 맞게 조정 (비율 유지하지 않고 꽉 채움)
-        QPixmap pixmap = QPixmap::fromImage(frame).scaled(
-            cameraView->width(),
-            cameraView->height(),
-            Qt::IgnoreAspectRatio,
-            Qt::SmoothTransformation);
+        // SmoothTransformation 대신 미리 계산한 테이블로 쌍선형 스케일 (버퍼 재사용)
+        const QImage &preview = previewRenderer.render(frame, cameraView->size());
         
-        cameraView->setPixmap(pixmap);
+        // 렌더러 출력 버퍼를 그대로 그림 (QPixmap 변환 없음)
+        cameraView->showFrame(&preview);
     }
 }
 
@@ -228,38 +214,36 @@ void BingoPreparationWidget::resizeEvent(QResizeEvent* event)
     updateCameraFrame();
 }
 
-void BingoPreparationWidget::handleCameraDisconnect()
+void BingoPreparationWidget::handleCameraReady(bool ok)
 {
-    static bool isTransitioning = false;
-    
-    // 이미 전환 중이면 무시
-    if (isTransitioning) {
-        qDebug() << "DEBUG: Screen transition already in progress, ignoring";
+    if (ok) {
+        qDebug() << "Camera opened successfully";
         return;
     }
-    
-    isTransitioning = true;
-    
-    qDebug() << "DEBUG: Camera disconnected";
-    
+
+    stopCameraCapture();
     if (cameraView) {
-        cameraView->setText("Camera disconnected");
+        cameraView->setText("Camera connection failed");
     }
-    
-    isCapturing = false;
-    
-    // 메인 화면으로 돌아가는 대화상자 표시
-    QMessageBox::warning(this, "Camera Error", 
-                         "Camera has been disconnected. Returning to main screen.");
-    
-    qDebug() << "DEBUG: Emitting backToMainRequested signal from handleCameraDisconnect";
-    // 메인 화면으로 돌아가기
-    emit backToMainRequested();
-    
-    // 전환 상태 재설정 (딜레이 후 리셋)
-    QTimer::singleShot(500, []() { 
-        isTransitioning = false; 
-    });
+    QMessageBox::critical(this, "Error", "Failed to open camera device");
+}
+
+void BingoPreparationWidget::handleCameraDisconnect()
+{
+    // 캡처 스레드의 감시기가 장치를 계속 다시 열고 있으므로 구독을 유지하고 화면에 표시만 함
+    if (cameraView) {
+        cameraView->setText("Camera disconnected - reconnecting...");
+    }
+    qDebug() << "Camera disconnected, waiting for watchdog recovery";
+}
+
+void BingoPreparationWidget::handleCameraRecovered()
+{
+    // 재연결 메시지를 지우고 다음 프레임이 카메라 뷰를 다시 채움
+    if (cameraView) {
+        cameraView->clear();
+    }
+    qDebug() << "Camera recovered";
 }
 
 void BingoPreparationWidget::onCreateBingoClicked() 
@@ -320,95 +304,47 @@ BingoPreparationWidget::~BingoPreparationWidget()
     qDebug() << "DEBUG: BingoPreparationWidget destructor called";
     stopCameraCapture();
     
-    // 카메라 객체 정리
-    if (camera) {
-        camera->closeCamera();
-        // camera는 QObject 상속이므로 자동으로 제거됨
-    }
-    
     qDebug() << "DEBUG: BingoPreparationWidget destructor completed";
 }
 
 QList<QColor> BingoPreparationWidget::captureColorsFromFrame()
 {
+    const int BOARD_COLORS = 9;
     QList<QColor> capturedColors;
     
-    // 카메라 프레임에서 색상 추출
-    QImage frame = camera->getCurrentFrame();
+    // 판 색을 뽑은 프레임의 화이트 밸런스를 게임이 끝날 때까지 유지
+    // (게임 중 캡처한 색이 판 색과 같은 보정을 거치도록)
+    camera->setWhiteBalanceLocked(true);
+    
+    // 카메라 프레임 전체를 양자화해 서로 구분되는 색을 화면 비율이 큰 순서로 추출
+    const QImage frame = camera->getCurrentFrame(); // 공유 핸들 (복사 없음)
     if (!frame.isNull()) {
-        int width = frame.width();
-        int height = frame.height();
-        
-        // 정확히 9개의 색상을 카메라에서 추출
-        struct SamplePoint {
-            double xRatio, yRatio;
-            QString name;
-        };
-        
-        // 샘플링 지점 정의 - 9개 위치
-        SamplePoint samplePoints[] = {
-            {0.2, 0.2, "좌측 상단"},
-            {0.5, 0.2, "중앙 상단"},
-            {0.8, 0.2, "우측 상단"},
-            {0.2, 0.5, "좌측 중앙"},
-            {0.5, 0.5, "중앙"},
-            {0.8, 0.5, "우측 중앙"},
-            {0.2, 0.8, "좌측 하단"},
-            {0.5, 0.8, "중앙 하단"},
-            {0.8, 0.8, "우측 하단"}
-        };
-        
-        // 각 샘플링 지점에서 색상 추출
-        for (const auto &point : samplePoints) {
-            int centerX = width * point.xRatio;
-            int centerY = height * point.yRatio;
-            
-            // 해당 지점 주변 25x25 영역의 평균 색상 계산
-            long totalR = 0, totalG = 0, totalB = 0;
-            int count = 0;
-            
-            for (int sy = centerY - 12; sy <= centerY + 12; sy++) {
-                for (int sx = centerX - 12; sx <= centerX + 12; sx++) {
-                    if (sx >= 0 && sx < width && sy >= 0 && sy < height) {
-                        QColor pixelColor = frame.pixelColor(sx, sy);
-                        totalR += pixelColor.red();
-                        totalG += pixelColor.green();
-                        totalB += pixelColor.blue();
-                        count++;
-                    }
-                }
-            }
-            
-            if (count > 0) {
-                QColor avgColor(totalR / count, totalG / count, totalB / count);
-                capturedColors.append(avgColor);
-                qDebug() << "Captured color from" << point.name << ":" 
-                        << avgColor.red() << avgColor.green() << avgColor.blue();
-            } else {
-                // 추출 실패한 경우만 랜덤 색상 추가
-                QColor randomColor(
-                    QRandomGenerator::global()->bounded(256),
-                    QRandomGenerator::global()->bounded(256),
-                    QRandomGenerator::global()->bounded(256)
-                );
-                capturedColors.append(randomColor);
-                qDebug() << "Failed to capture from" << point.name << ", added random color:" 
-                        << randomColor.red() << randomColor.green() << randomColor.blue();
-            }
+        capturedColors = paletteExtractor.extract(frame, BOARD_COLORS);
+        for (int i = 0; i < capturedColors.size(); i++) {
+            const QColor &color = capturedColors.at(i);
+            qDebug() << "Captured palette color" << i + 1 << ":"
+                    << color.red() << color.green() << color.blue();
         }
     } else {
-        // 프레임 자체가 없는 경우 9개의 랜덤 색상 생성
         qDebug() << "No valid camera frame, generating 9 random colors";
-        for (int i = 0; i < 9; i++) {
-            QColor randomColor(
+    }
+    
+    // 화면에 구분되는 색이 부족한 만큼만 랜덤 색으로 채움 (기존 색과 구분되도록 재시도)
+    ColorMatcher *matcher = ColorMatcher::getInstance();
+    while (capturedColors.size() < BOARD_COLORS) {
+        QColor randomColor;
+        for (int attempt = 0; attempt < 8; ++attempt) {
+            randomColor = QColor(
                 QRandomGenerator::global()->bounded(256),
                 QRandomGenerator::global()->bounded(256),
                 QRandomGenerator::global()->bounded(256)
             );
-            capturedColors.append(randomColor);
-            qDebug() << "Added random color " << i+1 << ":" 
-                    << randomColor.red() << randomColor.green() << randomColor.blue();
+            if (matcher->minDistance(randomColor, capturedColors) >= ColorMatcher::MIN_CELL_DISTANCE)
+                break;
         }
+        capturedColors.append(randomColor);
+        qDebug() << "Added random color" << capturedColors.size() << ":" 
+                << randomColor.red() << randomColor.green() << randomColor.blue();
     }
     
     return capturedColors;  // 정확히 9개의 색상 반환
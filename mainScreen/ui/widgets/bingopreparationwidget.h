@@ -11,6 +11,9 @@
 #include <QMessageBox>
 #include <QTimer>
 #include "hardwareInterface/v4l2camera.h"
+#include "utils/previewrenderer.h"
+#include "utils/paletteextractor.h"
+#include "ui/widgets/cameraview.h"
 #include "p2pnetwork.h"
 
 // 게임 모드 열거형 추가
@@ -49,13 +52,17 @@ private slots:
     void onBackButtonClicked();
     void updateCameraFrame();
     void handleCameraDisconnect();
+    void handleCameraRecovered();
+    void handleCameraReady(bool ok);
     void onOpponentDisconnected();
 
 private:
-    QLabel *cameraView;
+    CameraView *cameraView;
     QWidget *buttonPanel;
     V4L2Camera *camera;
     bool isCapturing;
+    PreviewRenderer previewRenderer; // 전체 화면 미리보기 (쌍선형 스케일)
+    PaletteExtractor paletteExtractor; // 빙고판 색 추출 (버퍼 재사용)
     GameMode gameMode; // 현재 게임 모드 저장 변수 추가
 
     void startCamera();
@@ -1,4 +1,5 @@
 #include "bingowidget.h"
+#include "hardwareInterface/cameraservice.h"
 #include <QDebug>
 #include <QMessageBox>
 #include <QPainter>
@@ -14,14 +15,19 @@
 #include "hardwareInterface/accelerometer.h"
 #include <QSettings>
 #include "../../utils/pixelartgenerator.h"
+#include "../../utils/frametrace.h"
+#include "../../utils/colormatcher.h"
+#include "ui/widgets/frametracehud.h"
 
 BingoWidget::BingoWidget(QWidget *parent, const QList<QColor> &initialColors) : QWidget(parent),
     isCapturing(false),
+    boardFromCamera(initialColors.size() >= 9),
     showCircle(true),
     circleRadius(10),
     avgRed(0),
     avgGreen(0),
     avgBlue(0),
+    colorStable(false),
     showRgbValues(true),
     selectedCell(qMakePair(-1, -1)),
     bingoCount(0),
@@ -42,6 +48,7 @@ BingoWidget::BingoWidget(QWidget *parent, const QList<QColor> &initialColors) :
     camera = nullptr;
     circleValueLabel = nullptr;
     circleCheckBox = nullptr; // Initialize to nullptr even though we won't use it
+    autoMatchFrames = AutoMatcher::holdFramesFromEnvironment();
     
     // 메인 레이아웃 생성 (가로 분할)
     mainLayout = new QHBoxLayout(this);
@@ -166,27 +173,29 @@ BingoWidget::BingoWidget(QWidget *parent, const QList<QColor> &initialColors) :
     cameraVLayout->addStretch(1);
 
     // 1. RGB 값 표시 레이블 (맨 위에 배치)
-    cameraRgbValueLabel = new QLabel("R: 0  G: 0  B: 0");
+    cameraRgbValueLabel = new ColorSwatchLabel("R: 0  G: 0  B: 0");
     cameraRgbValueLabel->setFixedHeight(30);
     cameraRgbValueLabel->setFixedWidth(300); // Same width as camera
     cameraRgbValueLabel->setAlignment(Qt::AlignCenter);
     QFont rgbFont = cameraRgbValueLabel->font();
     rgbFont.setPointSize(12);
     cameraRgbValueLabel->setFont(rgbFont);
-    cameraRgbValueLabel->setAutoFillBackground(true); // 배경색 설정 활성화
-    
-    // 모서리가 둥근 스타일 적용
-    cameraRgbValueLabel->setStyleSheet("background-color: black; color: white; border-radius: 15px; padding: 3px;");
+
+    // 모서리가 둥근 검정 배경으로 시작 (색상은 프레임마다 setSwatchColor로 갱신)
+    cameraRgbValueLabel->setCornerRadius(15);
+    cameraRgbValueLabel->setSwatchColor(Qt::black);
     
     cameraVLayout->addWidget(cameraRgbValueLabel, 0, Qt::AlignCenter);
 
     // 2. 카메라 뷰 (중간에 배치)
-    cameraView = new QLabel(cameraArea);
+    cameraView = new CameraView(cameraArea);
     cameraView->setFixedSize(300, 300);
     cameraView->setAlignment(Qt::AlignCenter);
     cameraView->setText(""); // 문구 제거
     cameraView->setFrameShape(QFrame::Box);
     cameraVLayout->addWidget(cameraView, 0, Qt::AlignCenter);
+    // 파이프라인 지연 HUD (COLORBINGO_FRAME_HUD 설정 시에만)
+    FrameTraceHud::attachIfEnabled(cameraView);
 
     // 3. 원 크기 조절 슬라이더 (맨 아래에 배치)
     sliderWidget = new QWidget(cameraArea);
@@ -203,14 +212,17 @@ BingoWidget::BingoWidget(QWidget *parent, const QList<QColor> &initialColors) :
     circleLabel->setFont(sliderFont);
     circleSliderLayout->addWidget(circleLabel);
     
-    circleSlider = new QSlider(Qt::Horizontal);
+    circleSlider = new ColorHandleSlider(Qt::Horizontal);
     circleSlider->setRange(5, 50); // 최소 5px, 최대 50px
     circleSlider->setValue(circleRadius);
     circleSlider->setFixedWidth(150);
     circleSliderLayout->addWidget(circleSlider);
 
-    circleValueLabel = new QLabel(QString::number(circleRadius));
-    circleValueLabel->setFont(sliderFont);
+    circleValueLabel = new ColorSwatchLabel(QString::number(circleRadius));
+    QFont valueFont = sliderFont;
+    valueFont.setBold(true); // 색상 배경 위 숫자는 굵게
+    circleValueLabel->setFont(valueFont);
+    circleValueLabel->setCornerRadius(10);
     circleValueLabel->setFixedWidth(30);
     circleValueLabel->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
     circleSliderLayout->addWidget(circleValueLabel);
@@ -254,12 +266,8 @@ BingoWidget::BingoWidget(QWidget *parent, const QList<QColor> &initialColors) :
         generateRandomColors();
     }
     
-    // 카메라 초기화
-    camera = new V4L2Camera(this);
-    
-    // 카메라 신호 연결
-    connect(camera, &V4L2Camera::newFrameAvailable, this, &BingoWidget::updateCameraFrame);
-    connect(camera, &V4L2Camera::deviceDisconnected, this, &BingoWidget::handleCameraDisconnect);
+    // 공유 카메라 (설정과 신호 연결은 구독 시 startCamera에서 수행)
+    camera = CameraService::getInstance()->getCamera();
     
     // 위젯 컨트롤 신호 연결 - remove RGB checkbox connection
     connect(circleSlider, &QSlider::valueChanged, this, &BingoWidget::onCircleSliderValueChanged);
@@ -267,15 +275,8 @@ BingoWidget::BingoWidget(QWidget *parent, const QList<QColor> &initialColors) :
     // 버튼 신호 연결
     connect(submitButton, &QPushButton::clicked, this, &BingoWidget::onSubmitButtonClicked);
     
-    // 카메라 재시작 타이머 설정 (유지)
-    cameraRestartTimer = new QTimer(this);
-    cameraRestartTimer->setInterval(30 * 60 * 1000); // 30분마다 재시작
-    connect(cameraRestartTimer, &QTimer::timeout, this, &BingoWidget::restartCamera);
-    
-    // 카메라 열기만 하고 자동 시작은 하지 않음
-    if (!camera->openCamera()) {
-        cameraView->setText("Camera connection failed");
-    }
+    // 장치는 작업 스레드에서 미리 열어 두고 자동 시작(구독)은 하지 않음
+    CameraService::getInstance()->warmUp();
 
     // 슬라이더 설정
     circleSlider->setMinimumHeight(30);
@@ -432,11 +433,6 @@ BingoWidget::BingoWidget(QWidget *parent, const QList<QColor> &initialColors) :
 
 BingoWidget::~BingoWidget() {
     // 물리 버튼 정리
-    if (cameraRestartTimer) {
-        cameraRestartTimer->stop();
-        delete cameraRestartTimer;
-    }
-    
     if (fadeXTimer) {
         fadeXTimer->stop();
         delete fadeXTimer;
@@ -459,10 +455,8 @@ BingoWidget::~BingoWidget() {
         delete checkboxDebounceTimer;
     }
     
-    if (camera) {
-        camera->stopCapturing();
-        camera->closeCamera();
-    }
+    // 공유 카메라 구독 해제 (장치는 서비스가 계속 열어 둠)
+    CameraService::getInstance()->unsubscribe(this);
     
     if (gameTimer) {
         gameTimer->stop();
@@ -616,7 +610,27 @@ void BingoWidget::startCamera() {
             return;
         }
         
-        if (camera->startCapturing()) {
+        // 공유 카메라 구독 (장치가 이미 스트리밍 중이면 즉시 완료)
+        if (CameraService::getInstance()->subscribe(this)) {
+            // ROI 모드: 원 평균은 캡처 스레드에서 YUYV로 직접 계산하고, 화면용 프레임은 절반 해상도로 받음
+            camera->setPreviewDownscale(2);
+            camera->setSamplingCircle(circleRadius);
+            // 게임 중에는 구독할 때마다 화이트 밸런스를 잠금 (화면을 채운 물체에 게인이 끌려가
+            // 맞추려는 색이 바뀌지 않도록): 카메라로 뽑은 판은 준비 화면에서 수렴해 잠근 게인,
+            // 랜덤 판은 기준이 될 게인이 없으므로 1.0
+            if (!boardFromCamera) {
+                camera->resetWhiteBalance();
+            }
+            camera->setWhiteBalanceLocked(true);
+            connect(camera, &V4L2Camera::newFrameAvailable, this, &BingoWidget::updateCameraFrame, Qt::UniqueConnection);
+            connect(camera, &V4L2Camera::deviceDisconnected, this, &BingoWidget::handleCameraDisconnect, Qt::UniqueConnection);
+            connect(camera, &V4L2Camera::deviceRecovered, this, &BingoWidget::handleCameraRecovered, Qt::UniqueConnection);
+            connect(camera, &V4L2Camera::cameraReady, this, &BingoWidget::handleCameraReady, Qt::UniqueConnection);
+            if (autoMatchFrames > 0) {
+                connect(camera, &V4L2Camera::autoMatchFound, this, &BingoWidget::handleAutoMatch, Qt::UniqueConnection);
+                updateAutoMatchTargets();
+            }
+
             // Reset camera view stylesheet
             if (cameraView) {
                 cameraView->setStyleSheet("");
@@ -624,11 +638,10 @@ void BingoWidget::startCamera() {
             }
             
             isCapturing = true;
-            
-            // Safety check: verify cameraRestartTimer
-            if (cameraRestartTimer) {
-                cameraRestartTimer->start();
-                qDebug() << "Camera restart timer started";
+
+            // 장치가 아직 열리는 중이면 자리 표시만 하고 cameraReady를 기다림
+            if (cameraView && !CameraService::getInstance()->isReady()) {
+                cameraView->setText("Starting camera...");
             }
             
             // 카메라가 켜졌으므로 슬라이더 위젯 표시
@@ -657,15 +670,9 @@ void BingoWidget::stopCamera() {
             return;
         }
         
-        camera->stopCapturing();
+        CameraService::getInstance()->unsubscribe(this);
         isCapturing = false;
         
-        // Safety check: verify cameraRestartTimer
-        if (cameraRestartTimer) {
-            cameraRestartTimer->stop();
-            qDebug() << "Camera restart timer stopped";
-        }
-        
         // 카메라가 꺼졌으므로 슬라이더 위젯 숨김
         if (sliderWidget) {
             sliderWidget->hide();
@@ -701,19 +708,29 @@ void BingoWidget::generateRandomColors() {
     const int hueStep = 360 / segments;
     
     // 각 영역에서 하나씩 색상 선택
+    ColorMatcher *matcher = ColorMatcher::getInstance();
     for (int i = 0; i < segments; ++i) {
         int baseHue = i * hueStep;
-        // 각 영역 내에서 랜덤한 hue 선택
-        int hue = baseHue + QRandomGenerator::global()->bounded(hueStep);
         
-        // 랜덤 채도 (40-255 범위로 설정하여 너무 회색에 가까운 색상 방지)
-        int saturation = QRandomGenerator::global()->bounded(40, 255);
-        
-        // 랜덤 명도 (140-255 범위로 설정하여 어두운 색상 방지)
-        int value = QRandomGenerator::global()->bounded(140, 255);
+        // 이미 고른 색과 지각적으로 너무 가까우면 같은 영역에서 다시 뽑음
+        QColor candidate;
+        for (int attempt = 0; attempt < 8; ++attempt) {
+            // 각 영역 내에서 랜덤한 hue 선택
+            int hue = baseHue + QRandomGenerator::global()->bounded(hueStep);
+            
+            // 랜덤 채도 (40-255 범위로 설정하여 너무 회색에 가까운 색상 방지)
+            int saturation = QRandomGenerator::global()->bounded(40, 255);
+            
+            // 랜덤 명도 (140-255 범위로 설정하여 어두운 색상 방지)
+            int value = QRandomGenerator::global()->bounded(140, 255);
+            
+            candidate = QColor::fromHsv(hue, saturation, value);
+            if (matcher->minDistance(candidate, colors) >= ColorMatcher::MIN_CELL_DISTANCE)
+                break;
+        }
         
         // HSV 색상 생성 후 목록에 추가
-        colors.append(QColor::fromHsv(hue, saturation, value));
+        colors.append(candidate);
     }
     
     // 색상 목록을 섞기 (셔플링)
@@ -790,26 +807,29 @@ QString BingoWidget::getCellColorName(int /* row */, int /* col */) {
 }
 
 int BingoWidget::colorDistance(const QColor &c1, const QColor &c2) {
-    // RGB 값 추출
-    int r1 = c1.red();
-    int g1 = c1.green();
-    int b1 = c1.blue();
-    
-    int r2 = c2.red();
-    int g2 = c2.green();
-    int b2 = c2.blue();
-    
-    // 단순 RGB 유클리드 거리 계산 (가중치 없음)
-    int rDiff = r1 - r2;
-    int gDiff = g1 - g2;
-    int bDiff = b1 - b2;
-    
-    // 유클리드 거리 계산: sqrt(rDiff² + gDiff² + bDiff²)
-    double distance = sqrt(rDiff*rDiff + gDiff*gDiff + bDiff*bDiff);
-    
-    // 0-100 스케일로 변환 (색상 범위 255를 고려하여 스케일링)
-    // sqrt(3 * 255²) = 약 441.67이 최대 거리
-    return static_cast<int>(distance * 100 / 441.67);
+    // CIELAB 기반 지각적 거리 (CIEDE2000, 0-100 스케일)
+    // RGB 유클리드 거리는 초록은 너무 쉽게, 파랑은 너무 어렵게 통과시켰음
+    return ColorMatcher::getInstance()->distance(c1, c2);
+}
+
+bool BingoWidget::matchesSelectedCell(const QColor &color, int row, int col, int threshold) {
+    QList<QColor> boardColors;
+    bool openCells[9];
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            boardColors.append(cellColors[r][c]);
+            openCells[r * 3 + c] = !bingoStatus[r][c];
+        }
+    }
+
+    int nearestCell = -1;
+    bool matched = ColorMatcher::getInstance()->matchesTarget(color, boardColors, openCells,
+                                                              row * 3 + col, threshold, &nearestCell);
+    if (nearestCell >= 0 && nearestCell != row * 3 + col) {
+        qDebug() << "Color is closer to open cell" << nearestCell / 3 << nearestCell % 3
+                 << (matched ? "(within margin, accepted)" : "(rejected)");
+    }
+    return matched;
 }
 
 bool BingoWidget::isColorBright(const QColor &color) {
@@ -874,13 +894,20 @@ void BingoWidget::updateCameraFrame() {
         return;
     }
     
+    // 다음 프레임부터 현재 원 크기로 샘플링
+    camera->setSamplingCircle(circleRadius);
+
     // Get new frame from camera
-    QImage frame = camera->getCurrentFrame();
+    FrameStats stats;
+    const QImage frame = camera->getCurrentFrame(&stats); // 공유 핸들 (복사 없음)
     
     if (frame.isNull()) {
         qDebug() << "Camera frame is null";
         return;
     }
+
+    FrameTrace *trace = FrameTrace::getInstance();
+    trace->record(stats.stream, stats.sequence, FrameTrace::STAGE_PICKUP);
     
     // 현재 프레임을 originalFrame에 저장
     originalFrame = frame;
@@ -911,42 +938,14 @@ void BingoWidget::updateCameraFrame() {
             // adjustedFrame = frame;
         // }
         
-        // Scale image to fit the QLabel while maintaining aspect ratio
-        QPixmap scaledPixmap = QPixmap::fromImage(frame).scaled(
+        // 스케일과 원 테두리 합성을 한 번의 패스로 처리 (버퍼 재사용, 프레임당 할당 없음)
+        // 원 색상은 기존과 같이 직전 프레임의 평균값 사용
+        const QImage &preview = previewRenderer.render(
+            frame,
             cameraView->size(),
-            Qt::IgnoreAspectRatio,
-            Qt::FastTransformation);
-        
-        // 미리보기 픽스맵 업데이트 (다음 슬라이더 변경시 사용)
-        previewPixmap = scaledPixmap.copy();
-        
-        // Create a copy of the pixmap for painting
-        QPixmap paintPixmap = scaledPixmap;
-        QPainter painter(&paintPixmap);
-        if (!painter.isActive()) {
-            qDebug() << "ERROR: Failed to create active painter";
-            cameraView->setPixmap(scaledPixmap);
-            return;
-        }
-        
-            painter.setRenderHint(QPainter::Antialiasing);
-            
-        // Calculate circle center coordinates
-        int centerX = paintPixmap.width() / 2;
-        int centerY = paintPixmap.height() / 2;
-        
-        // Calculate circle radius (percentage of image width)
-        int radius = (paintPixmap.width() * circleRadius) / 100;
-        
-        // Set pen color to match RGB values
-        QColor circleColor(avgRed, avgGreen, avgBlue);
-        QPen pen(circleColor);
-        pen.setWidth(5);
-        painter.setPen(pen);
-            
-        // Draw circle
-        painter.drawEllipse(QPoint(centerX, centerY), radius, radius);
-        painter.end();
+            circleRadius,
+            QColor(avgRed, avgGreen, avgBlue));
+        trace->record(stats.stream, stats.sequence, FrameTrace::STAGE_PAINT);
         
         // Calculate RGB average inside circle area
         // if (adjustedFrame.width() > 0 && adjustedFrame.height() > 0) {
@@ -957,66 +956,48 @@ void BingoWidget::updateCameraFrame() {
         //     calculateAverageRGB(adjustedFrame, adjustedFrame.width()/2, adjustedFrame.height()/2, safeRadius);
         // }
 
-        if (frame.width() > 0 && frame.height() > 0) {
+        // 캡처 스레드가 같은 원 크기로 계산한 평균이 있으면 그대로 사용
+        // (한 프레임 값 대신 프레임 간 평활 값을 사용해 흔들린 프레임 하나로 캡처가 틀어지지 않게 함)
+        if (stats.roiValid && stats.radiusPercent == circleRadius) {
+            avgRed = stats.smoothRed;
+            avgGreen = stats.smoothGreen;
+            avgBlue = stats.smoothBlue;
+            colorStable = stats.colorStable;
+        }
+        else if (frame.width() > 0 && frame.height() > 0) {
             // Calculate safe radius
             int safeRadius = qMin((frame.width() * circleRadius) / 100, 
                                qMin(frame.width()/2, frame.height()/2));
                                
             calculateAverageRGB(frame, frame.width()/2, frame.height()/2, safeRadius);
+            // 한 프레임만 본 값이라 안정 여부를 알 수 없음
+            colorStable = false;
         }
+        trace->record(stats.stream, stats.sequence, FrameTrace::STAGE_AVERAGE);
         
         // Update RGB values (always, no need for conditional check)
         if (cameraRgbValueLabel) {
-                cameraRgbValueLabel->setText(QString("R: %1  G: %2  B: %3").arg(avgRed).arg(avgGreen).arg(avgBlue));
-                
-            // 밝기에 따라 텍스트 색상 결정
-            QString textColor = (avgRed + avgGreen + avgBlue > 380) ? "black" : "white";
-            
-            // 스타일시트 설정 (둥근 모서리 유지)
-            cameraRgbValueLabel->setStyleSheet(QString("background-color: rgb(%1, %2, %3); color: %4; border-radius: 15px; padding: 3px;")
-                                             .arg(avgRed).arg(avgGreen).arg(avgBlue).arg(textColor));
-                                             
+            cameraRgbValueLabel->setText(QString("R: %1  G: %2  B: %3").arg(avgRed).arg(avgGreen).arg(avgBlue));
+
+            // 색상 표시 위젯은 직접 그리므로 스타일시트를 다시 파싱하지 않음 (같은 색이면 갱신 생략)
+            QColor avgColor(avgRed, avgGreen, avgBlue);
+            cameraRgbValueLabel->setSwatchColor(avgColor);
+            cameraRgbValueLabel->setIndicatorColor(stabilityColor());
+
             // Circle 슬라이더 값 라벨 색상도 함께 업데이트
             if (circleValueLabel) {
-                circleValueLabel->setStyleSheet(QString(
-                    "background-color: rgb(%1, %2, %3);"
-                    "color: %4;"
-                    "border-radius: 10px;"
-                    "padding: 3px 8px;"
-                    "min-width: 30px;"
-                    "font-weight: bold;"
-                ).arg(avgRed).arg(avgGreen).arg(avgBlue).arg(textColor));
+                circleValueLabel->setSwatchColor(avgColor);
             }
-            
+
             // 슬라이더 손잡이 색상 업데이트
             if (circleSlider) {
-                // 슬라이더 핸들 색상을 현재 RGB 값으로 설정
-                circleSlider->setStyleSheet(QString(
-                    "QSlider::groove:horizontal {"
-                    "    border: 1px solid #999999;"
-                    "    height: 8px;"
-                    "    background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #B1B1B1, stop:1 #c4c4c4);"
-                    "    margin: 2px 0;"
-                    "    border-radius: 4px;"
-                    "}"
-                    "QSlider::handle:horizontal {"
-                    "    background: rgb(%1, %2, %3);"
-                    "    border: 1px solid #5c5c5c;"
-                    "    width: 18px;"
-                    "    margin: -6px 0;"
-                    "    border-radius: 9px;"
-                    "}"
-                    "QSlider::handle:horizontal:hover {"
-                    "    background: rgb(%4, %5, %6);"
-                    "    border: 1px solid #333333;"
-                    "}"
-                ).arg(avgRed).arg(avgGreen).arg(avgBlue)
-                 .arg(qMin(avgRed + 20, 255)).arg(qMin(avgGreen + 20, 255)).arg(qMin(avgBlue + 20, 255)));
+                circleSlider->setHandleColor(avgColor);
             }
         }
         
-        // Display the final image with circle
-        cameraView->setPixmap(paintPixmap);
+        // Display the final image with circle (렌더러 출력 버퍼를 그대로 그림, QPixmap 변환 없음)
+        cameraView->showFrame(&preview);
+        trace->record(stats.stream, stats.sequence, FrameTrace::STAGE_DISPLAY);
     }
     catch (const std::exception& e) {
         qDebug() << "ERROR: Exception in updateCameraFrame: " << e.what();
@@ -1038,31 +1019,11 @@ void BingoWidget::calculateAverageRGB(const QImage &image, int centerX, int cent
     int safeX = qBound(radius, centerX, image.width() - radius);
     int safeY = qBound(radius, centerY, image.height() - radius);
     
-    // Initialize pixel sums and count
-    long totalR = 0, totalG = 0, totalB = 0;
-    int pixelCount = 0;
-    
-    // Check pixels inside the circle
-    for (int y = safeY - radius; y < safeY + radius; y++) {
-        for (int x = safeX - radius; x < safeX + radius; x++) {
-            // Check if point is inside circle (using circle equation)
-            int dx = x - safeX;
-            int dy = y - safeY;
-            int distSquared = dx*dx + dy*dy;
-            
-            if (distSquared <= radius*radius) {
-                // Safety check: verify point is within image boundaries
-                if (x >= 0 && x < image.width() && y >= 0 && y < image.height()) {
-                    QColor pixel(image.pixel(x, y));
-                    totalR += pixel.red();
-                    totalG += pixel.green();
-                    totalB += pixel.blue();
-                pixelCount++;
-                }
-            }
-        }
-    }
-    
+    // 원 하나만 조회하므로 누적합 테이블 없이 원의 행 구간만 직접 합산
+    qint64 total[3];
+    int pixelCount = SummedAreaTable::imageCircleSum(image, safeX, safeY, radius, total);
+    qint64 totalR = total[0], totalG = total[1], totalB = total[2];
+
     // Calculate averages
     if (pixelCount > 0) {
         avgRed = totalR / pixelCount;
@@ -1077,16 +1038,26 @@ void BingoWidget::calculateAverageRGB(const QImage &image, int centerX, int cent
 }
 
 void BingoWidget::handleCameraDisconnect() {
-    cameraView->setText("Camera disconnected");
-    qDebug() << "Camera disconnected";
-    
-    // 플래그 설정만 업데이트 (버튼 참조 제거)
-    isCapturing = false;
-    
-    // 선택된 셀이 있으면 선택 해제
-    if (selectedCell.first >= 0 && selectedCell.second >= 0) {
-        deselectCell();
+    // 캡처 스레드의 감시기가 장치를 계속 다시 열고 있으므로 캡처 상태는 유지
+    cameraView->setText("Camera disconnected - reconnecting...");
+    qDebug() << "Camera disconnected, waiting for watchdog recovery";
+}
+
+void BingoWidget::handleCameraReady(bool ok) {
+    if (ok) {
+        // 첫 프레임이 자리 표시를 대체함
+        qDebug() << "Camera ready";
+        return;
     }
+
+    qDebug() << "Failed to start camera capture";
+    stopCamera();
+    QMessageBox::critical(this, "Error", "Failed to start camera");
+}
+
+void BingoWidget::handleCameraRecovered() {
+    // 다음 프레임이 카메라 뷰를 다시 채움
+    qDebug() << "Camera recovered";
 }
 
 void BingoWidget::onCircleSliderValueChanged(int value) {
@@ -1094,26 +1065,6 @@ void BingoWidget::onCircleSliderValueChanged(int value) {
     // 단, 호환성을 위해 함수는 유지
 }
 
-void BingoWidget::restartCamera()
-{
-    if (isCapturing) {
-        qDebug() << "Performing periodic camera reinitialization...";
-        // Stop camera
-        camera->stopCapturing();
-        
-        // Wait briefly
-        QThread::msleep(500);
-        
-        // Restart camera
-        if (!camera->startCapturing()) {
-            QMessageBox::warning(this, "Warning", "Camera restart failed. Will try again later.");
-            return;
-        }
-        
-        qDebug() << "Camera reinitialization completed!";
-    }
-}
-
 void BingoWidget::onCaptureButtonClicked() {
     qDebug() << "BingoWidget::onCaptureButtonClicked called!";
     
@@ -1136,25 +1087,24 @@ void BingoWidget::onCaptureButtonClicked() {
     
     qDebug() << "Capture button clicked - Captured color: " << capturedColor.red() << "," << capturedColor.green() << "," << capturedColor.blue();
     qDebug() << "Fresh capture: " << (isFreshCapture ? "Yes" : "No");
+    if (!colorStable) {
+        qDebug() << "Captured while the sampled color was still settling";
+    }
     
     // 빙고 셀 색상과 비교
     QColor selectedColor = cellColors[row][col];
     int distance = colorDistance(selectedColor, capturedColor);
     
+    // 9칸 전체와 한 번에 비교: 다른 열린 칸에 확실히 더 가까우면 이 칸으로 인정하지 않음
+    bool matched = matchesSelectedCell(capturedColor, row, col, ColorMatcher::MATCH_THRESHOLD);
+    
     qDebug() << "Initial color comparison - Distance: " << distance;
     qDebug() << "Selected cell color: " << selectedColor.red() << "," << selectedColor.green() << "," << selectedColor.blue();
     
-    // 색상 유사도 임계값
-    const int THRESHOLD = 20;  // 10에서 20으로 증가하여 더 관대하게 허용
-    
     // 카메라 중지 - 색상 판단 후 중지하도록 위치 변경
     if (isCapturing) {
-        camera->stopCapturing();
+        CameraService::getInstance()->unsubscribe(this);
         isCapturing = false;
-        
-        if (cameraRestartTimer) {
-            cameraRestartTimer->stop();
-        }
     }
     
     // 가속도계 상태 확인
@@ -1167,7 +1117,7 @@ void BingoWidget::onCaptureButtonClicked() {
     }
     
     // 색상이 이미 유사하면 바로 성공 처리
-    if (distance <= THRESHOLD) {
+    if (matched) {
         qDebug() << "Immediate color match successful!";
         processColorMatch(capturedColor);
         
@@ -1319,7 +1269,7 @@ void BingoWidget::onSubmitButtonClicked() {
     qDebug() << "Tilt-adjusted color: " << tiltAdjustedColor.red() << "," << tiltAdjustedColor.green() << "," << tiltAdjustedColor.blue();
     
     // 색상이 유사하면 성공 처리
-    if (distance <= THRESHOLD) {
+    if (matchesSelectedCell(tiltAdjustedColor, row, col, THRESHOLD)) {
         qDebug() << "Tilt-adjusted color match successful!";
         
         // 틸트 조절된 색상으로 매칭 처리
@@ -1335,14 +1285,9 @@ void BingoWidget::onSubmitButtonClicked() {
         // 카메라 중지 - 물리 버튼 사용시 상태만 업데이트
         if (isCapturing) {
             // 카메라 캡처 중지
-            camera->stopCapturing();
+            CameraService::getInstance()->unsubscribe(this);
             isCapturing = false;
             
-            // 재시작 타이머 중지
-            if (cameraRestartTimer) {
-                cameraRestartTimer->stop();
-            }
-            
             // 카메라 뷰에 메시지 표시
             if (cameraView) {
                 cameraView->setText("Camera is off");
@@ -1454,7 +1399,7 @@ void BingoWidget::onSubmitButtonClicked() {
 }
 
 // 색상 매치 처리 함수 (기존 onCaptureButtonClicked 코드 일부 분리)
-void BingoWidget::processColorMatch(const QColor &colorToMatch) {
+void BingoWidget::processColorMatch(const QColor &colorToMatch, bool fromAutoMatch) {
     qDebug() << "processColorMatch: Function started, selectedCell:" << selectedCell.first << "," << selectedCell.second;
     
     if (selectedCell.first < 0) {
@@ -1499,16 +1444,15 @@ void BingoWidget::processColorMatch(const QColor &colorToMatch) {
     // 상태 메시지 업데이트
     statusMessageLabel->setText("Great job! Perfect color match!");
     
-    // 카메라 중지 - 물리 버튼 사용시 상태만 업데이트
-    if (isCapturing) {
-        // 카메라 캡처 중지
-        camera->stopCapturing();
-        isCapturing = false;
-        
-        // 재시작 타이머 중지
-        if (cameraRestartTimer) {
-            cameraRestartTimer->stop();
+    // 연속 자동 매칭은 카메라를 켜 둔 채 남은 칸으로 매처를 다시 설정
+    if (fromAutoMatch) {
+        if (isCapturing) {
+            updateAutoMatchTargets();
         }
+    } else if (isCapturing) {
+        // 카메라 중지 - 물리 버튼 사용시 상태만 업데이트
+        CameraService::getInstance()->unsubscribe(this);
+        isCapturing = false;
         
         // 카메라 뷰에 메시지 표시
         if (cameraView) {
@@ -1525,6 +1469,51 @@ void BingoWidget::processColorMatch(const QColor &colorToMatch) {
     capturedColor = QColor();
 }
 
+// 자동 매칭 목표: 모든 칸 색과 아직 맞추지 않은 칸 표시
+void BingoWidget::updateAutoMatchTargets() {
+    if (autoMatchFrames <= 0 || !camera)
+        return;
+    
+    QColor colors[9];
+    bool open[9];
+    for (int row = 0; row < 3; ++row) {
+        for (int col = 0; col < 3; ++col) {
+            colors[row * 3 + col] = cellColors[row][col];
+            open[row * 3 + col] = !bingoStatus[row][col];
+        }
+    }
+    
+    // 버튼 판정과 같은 임계값
+    camera->getAutoMatcher()->setTargets(colors, open, 9, ColorMatcher::MATCH_THRESHOLD, autoMatchFrames);
+}
+
+// 캡처 스레드의 자동 매칭이 한 칸을 연속 프레임 동안 맞춤
+void BingoWidget::handleAutoMatch(int index, const QColor &color) {
+    if (!isCapturing || index < 0 || index >= 9)
+        return;
+    
+    int row = index / 3;
+    int col = index % 3;
+    if (bingoStatus[row][col])
+        return;
+    
+    qDebug() << "Auto-match claimed cell" << row << col << "with color"
+             << color.red() << color.green() << color.blue();
+    
+    // 선택한 칸과 다른 칸이 맞으면 선택을 옮김
+    if (selectedCell.first >= 0 && selectedCell != qMakePair(row, col)
+        && !bingoStatus[selectedCell.first][selectedCell.second]) {
+        updateCellStyle(selectedCell.first, selectedCell.second);
+    }
+    selectedCell = qMakePair(row, col);
+    
+    if (submitButton) {
+        submitButton->hide();
+    }
+    
+    processColorMatch(color, true);
+}
+
 void BingoWidget::clearXMark() {
     // X 표시가 있는 셀이 있으면 원래대로 되돌리기
     for (int row = 0; row < 3; ++row) {
@@ -2113,13 +2102,20 @@ void BingoWidget::setCustomColors(const QList<QColor> &colors) {
     
     // 2개의 랜덤 색상 생성
     QList<QColor> randomColors;
+    // 보너스 칸 색은 카메라 색 및 서로와 구분되도록 고름
+    ColorMatcher *matcher = ColorMatcher::getInstance();
     for(int i = 0; i < 2; ++i) {
-        // 완전 랜덤 색상 생성 (HSV 모델 사용)
-        int hue = QRandomGenerator::global()->bounded(360); // 0-359 색조
-        int saturation = QRandomGenerator::global()->bounded(180, 255); // 선명한 색상을 위해 180-255 채도
-        int value = QRandomGenerator::global()->bounded(180, 255); // 밝은 색상을 위해 180-255 명도
-        
-        QColor randomColor = QColor::fromHsv(hue, saturation, value);
+        QColor randomColor;
+        for (int attempt = 0; attempt < 8; ++attempt) {
+            // 완전 랜덤 색상 생성 (HSV 모델 사용)
+            int hue = QRandomGenerator::global()->bounded(360); // 0-359 색조
+            int saturation = QRandomGenerator::global()->bounded(180, 255); // 선명한 색상을 위해 180-255 채도
+            int value = QRandomGenerator::global()->bounded(180, 255); // 밝은 색상을 위해 180-255 명도
+        
+            randomColor = QColor::fromHsv(hue, saturation, value);
+            if (matcher->minDistance(randomColor, mixedColors + randomColors) >= ColorMatcher::MIN_CELL_DISTANCE)
+                break;
+        }
         randomColors.append(randomColor);
     }
     
@@ -2365,29 +2361,40 @@ void BingoWidget::createCircleOverlay(int width, int height) {
     }
 }
 
+QColor BingoWidget::stabilityColor() const
+{
+    return colorStable ? QColor(76, 175, 80) : QColor(255, 160, 0);
+}
+
 // RGB 값 업데이트 함수 구현
 void BingoWidget::updateRgbValues() {
     if (!isCapturing || !showCircle || !showRgbValues)
         return;
         
     // 현재 프레임 가져오기
-    QImage frame = camera->getCurrentFrame();
+    FrameStats stats;
+    const QImage frame = camera->getCurrentFrame(&stats); // 공유 핸들 (복사 없음)
     if (frame.isNull())
         return;
         
     // 원 영역 내부 RGB 평균 계산
-    calculateAverageRGB(frame, frame.width()/2, frame.height()/2, 
-                       (frame.width() * circleRadius) / 100);
+    if (stats.roiValid && stats.radiusPercent == circleRadius) {
+        avgRed = stats.smoothRed;
+        avgGreen = stats.smoothGreen;
+        avgBlue = stats.smoothBlue;
+        colorStable = stats.colorStable;
+    } else {
+        calculateAverageRGB(frame, frame.width()/2, frame.height()/2, 
+                           (frame.width() * circleRadius) / 100);
+        colorStable = false;
+    }
                        
     // RGB 값 업데이트
     cameraRgbValueLabel->setText(QString("R: %1  G: %2  B: %3").arg(avgRed).arg(avgGreen).arg(avgBlue));
     
     // 배경색 설정 (평균 RGB 값)
-    QPalette palette = cameraRgbValueLabel->palette();
-    palette.setColor(QPalette::Window, QColor(avgRed, avgGreen, avgBlue));
-    palette.setColor(QPalette::WindowText, (avgRed + avgGreen + avgBlue > 380) ? Qt::black : Qt::white);
-    cameraRgbValueLabel->setPalette(palette);
-    cameraRgbValueLabel->setAutoFillBackground(true);
+    cameraRgbValueLabel->setSwatchColor(QColor(avgRed, avgGreen, avgBlue));
+    cameraRgbValueLabel->setIndicatorColor(stabilityColor());
 }
 
 void BingoWidget::showEvent(QShowEvent *event)
@@ -2401,10 +2408,9 @@ void BingoWidget::hideEvent(QHideEvent *event)
     QWidget::hideEvent(event);
     qDebug() << "DEBUG: BingoWidget hideEvent triggered";
 
-    // 카메라 중지 및 닫기
+    // 카메라 구독 해제
     if(camera) {
         stopCamera();
-        camera->closeCamera();
     }
     
     // 타이머 중지
@@ -2517,13 +2523,7 @@ void BingoWidget::updateTiltColorDisplay(const QColor &color) {
         // 카메라 RGB 값 레이블도 업데이트
         if (cameraRgbValueLabel) {
             cameraRgbValueLabel->setText(QString("R: %1  G: %2  B: %3").arg(color.red()).arg(color.green()).arg(color.blue()));
-            
-            // 밝기에 따라 텍스트 색상 결정
-            QString textColor = (color.red() + color.green() + color.blue() > 380) ? "black" : "white";
-        
-        // 스타일시트 설정 (둥근 모서리 유지)
-            cameraRgbValueLabel->setStyleSheet(QString("background-color: rgb(%1, %2, %3); color: %4; border-radius: 15px; padding: 3px;")
-                                             .arg(color.red()).arg(color.green()).arg(color.blue()).arg(textColor));
+            cameraRgbValueLabel->setSwatchColor(color);
         }
         
         // 카메라 뷰에 픽스맵 설정
@@ -2531,40 +2531,12 @@ void BingoWidget::updateTiltColorDisplay(const QColor &color) {
         
         // 슬라이더 핸들 색상도 업데이트
         if (circleSlider) {
-            // 슬라이더 핸들 색상을 현재 RGB 값으로 설정
-            circleSlider->setStyleSheet(QString(
-                "QSlider::groove:horizontal {"
-                "    border: 1px solid #999999;"
-                "    height: 8px;"
-                "    background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #B1B1B1, stop:1 #c4c4c4);"
-                "    margin: 2px 0;"
-                "    border-radius: 4px;"
-                "}"
-                "QSlider::handle:horizontal {"
-                "    background: rgb(%1, %2, %3);"
-                "    border: 1px solid #5c5c5c;"
-                "    width: 18px;"
-                "    margin: -6px 0;"
-                "    border-radius: 9px;"
-                "}"
-                "QSlider::handle:horizontal:hover {"
-                "    background: rgb(%4, %5, %6);"
-                "    border: 1px solid #333333;"
-                "}"
-            ).arg(color.red()).arg(color.green()).arg(color.blue())
-             .arg(qMin(color.red() + 20, 255)).arg(qMin(color.green() + 20, 255)).arg(qMin(color.blue() + 20, 255)));
+            circleSlider->setHandleColor(color);
         }
         
         // Circle 슬라이더 값 라벨 색상도 함께 업데이트
         if (circleValueLabel) {
-            circleValueLabel->setStyleSheet(QString(
-                "background-color: rgb(%1, %2, %3);"
-                "color: %4;"
-                "border-radius: 10px;"
-                "padding: 3px 8px;"
-                "min-width: 30px;"
-                "font-weight: bold;"
-            ).arg(color.red()).arg(color.green()).arg(color.blue()).arg(isBright ? "black" : "white"));
+            circleValueLabel->setSwatchColor(color);
         }
     }
 }
@@ -2606,52 +2578,13 @@ void BingoWidget::updateCirclePreview(int radius) {
         return;
     }
     
-    // 기존의 미리보기 픽스맵이 없거나 크기가 다르면 새로 생성
-    if (previewPixmap.isNull() || previewPixmap.width() != cameraView->width() || 
-        previewPixmap.height() != cameraView->height()) {
-        
-        // 원래 프레임으로부터 미리보기 픽스맵 생성 (최초 1회만 실행)
-        // QImage adjustedFrame;
-        // try {
-        //     adjustedFrame = adjustColorBalance(originalFrame);
-        //     if (adjustedFrame.isNull()) {
-        //         adjustedFrame = originalFrame;
-        //     }
-        // } catch (...) {
-            // adjustedFrame = originalFrame;
-        // }
-        
-        previewPixmap = QPixmap::fromImage(originalFrame).scaled(
-            cameraView->size(),
-            Qt::IgnoreAspectRatio,
-            Qt::FastTransformation);
-    }
-    
-    // 미리보기 픽스맵 복사본 생성 (원본 유지)
-    QPixmap tempPixmap = previewPixmap.copy();
-    
-    // 원 그리기
-    QPainter painter(&tempPixmap);
-    if (!painter.isActive()) {
-        return;
-    }
-    
-    painter.setRenderHint(QPainter::Antialiasing);
-    
-    // 원 중심과 반지름 계산
-    int centerX = tempPixmap.width() / 2;
-    int centerY = tempPixmap.height() / 2;
-    int drawRadius = (tempPixmap.width() * radius) / 100;
-    
-    // 현재 RGB 값으로 원 색상 설정
-    QPen pen(QColor(avgRed, avgGreen, avgBlue));
-    pen.setWidth(5);
-    painter.setPen(pen);
-    
-    // 원 그리기
-    painter.drawEllipse(QPoint(centerX, centerY), drawRadius, drawRadius);
-    painter.end();
-    
+    // 같은 프레임을 새 반지름으로 다시 그림 (스케일 테이블은 재사용, 원 마스크만 재구축)
+    const QImage &preview = previewRenderer.render(
+        originalFrame,
+        cameraView->size(),
+        radius,
+        QColor(avgRed, avgGreen, avgBlue));
+
     // 카메라 뷰에 미리보기 표시
-    cameraView->setPixmap(tempPixmap);
+    cameraView->showFrame(&preview);
 }
@@ -0,0 +1,52 @@
+#include "ui/widgets/cameraview.h"
+#include <QPainter>
+
+CameraView::CameraView(QWidget *parent) :
+    QLabel(parent),
+    frame(nullptr)
+{
+}
+
+void CameraView::showFrame(const QImage *image)
+{
+    // 문구("Starting camera..." 등)에서 프레임으로 넘어갈 때 한 번만 라벨 내용을 비움
+    if (!frame && image)
+        QLabel::clear();
+
+    frame = image;
+    update();
+}
+
+void CameraView::setText(const QString &text)
+{
+    frame = nullptr;
+    QLabel::setText(text);
+}
+
+void CameraView::setPixmap(const QPixmap &pixmap)
+{
+    frame = nullptr;
+    QLabel::setPixmap(pixmap);
+}
+
+void CameraView::clear()
+{
+    frame = nullptr;
+    QLabel::clear();
+}
+
+void CameraView::paintEvent(QPaintEvent *event)
+{
+    if (!frame || frame->isNull()) {
+        QLabel::paintEvent(event);
+        return;
+    }
+
+    // QLabel과 같은 순서: 테두리를 그린 뒤 내용 영역 가운데에 이미지
+    QPainter painter(this);
+    drawFrame(&painter);
+
+    QRect target(QPoint(0, 0), frame->size());
+    target.moveCenter(contentsRect().center());
+    painter.drawImage(target.topLeft(), *frame);
+}
@@ -0,0 +1,35 @@
+#ifndef CAMERAVIEW_H
+#define CAMERAVIEW_H
+
+#include <QLabel>
+#include <QImage>
+#include <QPixmap>
+
+// 카메라 미리보기 라벨
+// setPixmap(QPixmap::fromImage(...))는 매 프레임 QPixmap 할당과 변환을 하므로
+// 렌더러가 재사용하는 출력 이미지를 가리키기만 하고 paintEvent에서 바로 그린다.
+// 문구/픽스맵 표시는 기존 QLabel과 같고, setText/setPixmap/clear를 호출하면 프레임 표시를 끈다.
+// (QLabel의 함수를 가리는 것이므로 CameraView 포인터로 호출해야 한다)
+class CameraView : public QLabel
+{
+    Q_OBJECT
+
+public:
+    explicit CameraView(QWidget *parent = nullptr);
+
+    // image는 다음 showFrame/clear 호출까지 살아 있어야 함 (PreviewRenderer 출력 등)
+    void showFrame(const QImage *image);
+    bool isShowingFrame() const { return frame != nullptr; }
+
+    void setText(const QString &text);
+    void setPixmap(const QPixmap &pixmap);
+    void clear();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    const QImage *frame;
+};
+
+#endif // CAMERAVIEW_H
@@ -0,0 +1,60 @@
+#include "ui/widgets/colorhandleslider.h"
+#include <QPainter>
+#include <QStyle>
+#include <QLinearGradient>
+
+ColorHandleSlider::ColorHandleSlider(Qt::Orientation orientation, QWidget *parent) :
+    QSlider(orientation, parent)
+{
+    // 손잡이 hover 색을 위해 마우스 진입/이탈 시 다시 그림
+    setAttribute(Qt::WA_Hover);
+}
+
+void ColorHandleSlider::setHandleColor(const QColor &newColor)
+{
+    if (newColor == color)
+        return;
+
+    color = newColor;
+    // 손잡이 영역만 다시 그림
+    update(handleRect().adjusted(-1, -1, 1, 1));
+}
+
+QRect ColorHandleSlider::handleRect() const
+{
+    int span = width() - HANDLE_WIDTH;
+    int pos = QStyle::sliderPositionFromValue(minimum(), maximum(), value(), qMax(0, span), invertedAppearance());
+    return QRect(pos, (height() - HANDLE_HEIGHT) / 2, HANDLE_WIDTH, HANDLE_HEIGHT);
+}
+
+void ColorHandleSlider::paintEvent(QPaintEvent *event)
+{
+    // 첫 색이 정해지기 전이나 세로 슬라이더는 기본 스타일로 그림
+    if (!color.isValid() || orientation() != Qt::Horizontal) {
+        QSlider::paintEvent(event);
+        return;
+    }
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    // 홈: 회색 그라데이션, 1px 테두리
+    QRectF groove(0.5, (height() - GROOVE_HEIGHT) / 2.0 + 0.5, width() - 1.0, GROOVE_HEIGHT - 1.0);
+    QLinearGradient gradient(groove.topLeft(), groove.topRight());
+    gradient.setColorAt(0.0, QColor(0xb1, 0xb1, 0xb1));
+    gradient.setColorAt(1.0, QColor(0xc4, 0xc4, 0xc4));
+    painter.setPen(QColor(0x99, 0x99, 0x99));
+    painter.setBrush(gradient);
+    painter.drawRoundedRect(groove, 4, 4);
+
+    // 손잡이: 현재 색, hover 시 조금 밝게
+    bool hovered = underMouse() || isSliderDown();
+    QColor fill = color;
+    if (hovered) {
+        fill = QColor(qMin(color.red() + 20, 255), qMin(color.green() + 20, 255), qMin(color.blue() + 20, 255));
+    }
+    QRectF handle = QRectF(handleRect()).adjusted(0.5, 0.5, -0.5, -0.5);
+    painter.setPen(hovered ? QColor(0x33, 0x33, 0x33) : QColor(0x5c, 0x5c, 0x5c));
+    painter.setBrush(fill);
+    painter.drawRoundedRect(handle, HANDLE_WIDTH / 2.0, HANDLE_WIDTH / 2.0);
+}
@@ -0,0 +1,34 @@
+#ifndef COLORHANDLESLIDER_H
+#define COLORHANDLESLIDER_H
+
+#include <QSlider>
+#include <QColor>
+
+// 손잡이 색을 직접 그리는 가로 슬라이더
+// 기존 QSlider 스타일시트(회색 그라데이션 홈, 둥근 색상 손잡이)와 같은 모양을
+// paintEvent에서 그리므로 손잡이 색을 바꿀 때 스타일시트를 다시 파싱하지 않는다.
+class ColorHandleSlider : public QSlider
+{
+    Q_OBJECT
+
+public:
+    explicit ColorHandleSlider(Qt::Orientation orientation, QWidget *parent = nullptr);
+
+    // 같은 색이면 다시 그리지 않음 (유효하지 않은 색이면 기본 QSlider 모양)
+    void setHandleColor(const QColor &color);
+    QColor handleColor() const { return color; }
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    QRect handleRect() const;
+
+    static const int HANDLE_WIDTH = 18;
+    static const int HANDLE_HEIGHT = 20;
+    static const int GROOVE_HEIGHT = 8;
+
+    QColor color;
+};
+
+#endif // COLORHANDLESLIDER_H
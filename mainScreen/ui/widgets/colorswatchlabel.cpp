@@ -0,0 +1,73 @@
+#include "ui/widgets/colorswatchlabel.h"
+#include <QPainter>
+
+ColorSwatchLabel::ColorSwatchLabel(const QString &text, QWidget *parent) :
+    QLabel(text, parent),
+    radius(15)
+{
+}
+
+bool ColorSwatchLabel::isBright(const QColor &color)
+{
+    return color.red() + color.green() + color.blue() > 380;
+}
+
+void ColorSwatchLabel::setSwatchColor(const QColor &newColor)
+{
+    // 같은 색이면 다시 그리지 않음 (평균 색은 프레임 간에 자주 같다)
+    if (newColor == color)
+        return;
+
+    color = newColor;
+    update();
+}
+
+void ColorSwatchLabel::setCornerRadius(int newRadius)
+{
+    if (newRadius == radius)
+        return;
+
+    radius = newRadius;
+    update();
+}
+
+void ColorSwatchLabel::setIndicatorColor(const QColor &newColor)
+{
+    if (newColor == indicator)
+        return;
+
+    indicator = newColor;
+    update();
+}
+
+void ColorSwatchLabel::paintEvent(QPaintEvent *event)
+{
+    if (!color.isValid()) {
+        QLabel::paintEvent(event);
+        return;
+    }
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    // 라벨 크기보다 큰 반지름은 알약 모양으로 제한
+    qreal r = qMin<qreal>(radius, qMin(width(), height()) / 2.0);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(color);
+    painter.drawRoundedRect(QRectF(rect()), r, r);
+
+    if (indicator.isValid()) {
+        // 둥근 왼쪽 끝의 중심에 배경과 구분되는 테두리를 두른 점
+        qreal dot = height() / 4.0;
+        QPointF center(height() / 2.0, height() / 2.0);
+        painter.setPen(QPen(isBright(color) ? Qt::black : Qt::white, 1));
+        painter.setBrush(indicator);
+        painter.drawEllipse(center, dot / 2.0 + 1, dot / 2.0 + 1);
+    }
+
+    painter.setPen(isBright(color) ? Qt::black : Qt::white);
+    painter.setFont(font());
+    // 기존 스타일시트의 padding: 3px에 해당하는 여백
+    int inset = margin() + 3;
+    painter.drawText(contentsRect().adjusted(inset, inset, -inset, -inset), alignment(), text());
+}
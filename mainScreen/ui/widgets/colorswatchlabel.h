@@ -0,0 +1,40 @@
+#ifndef COLORSWATCHLABEL_H
+#define COLORSWATCHLABEL_H
+
+#include <QLabel>
+#include <QColor>
+
+// 배경색을 직접 그리는 둥근 색상 라벨
+// 매 프레임 setStyleSheet로 배경색을 바꾸면 CSS 파싱/폴리시/재배치가 일어나므로
+// 색상은 setter로 받아 자기 자신만 다시 그린다 (같은 색이면 아무것도 하지 않음).
+// 글자색은 배경 밝기에 따라 검정/흰색으로 자동 선택한다.
+class ColorSwatchLabel : public QLabel
+{
+    Q_OBJECT
+
+public:
+    explicit ColorSwatchLabel(const QString &text = QString(), QWidget *parent = nullptr);
+
+    // 유효하지 않은 색이면 일반 QLabel처럼 그림
+    void setSwatchColor(const QColor &color);
+    QColor swatchColor() const { return color; }
+
+    void setCornerRadius(int radius);
+    int cornerRadius() const { return radius; }
+
+    // 왼쪽 끝에 그리는 작은 상태 점 (유효하지 않은 색이면 그리지 않음)
+    void setIndicatorColor(const QColor &color);
+
+    // 기존 스타일과 같은 기준 (R + G + B > 380 이면 검정 글자)
+    static bool isBright(const QColor &color);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    QColor color;
+    QColor indicator;
+    int radius;
+};
+
+#endif // COLORSWATCHLABEL_H
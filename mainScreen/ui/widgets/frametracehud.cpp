@@ -0,0 +1,52 @@
+#include "ui/widgets/frametracehud.h"
+#include "utils/frametrace.h"
+
+FrameTraceHud::FrameTraceHud(QWidget *parent) :
+    QLabel(parent)
+{
+    setStyleSheet("QLabel { background-color: rgba(0, 0, 0, 160); color: #00ff66; "
+                  "font-family: monospace; font-size: 11px; padding: 4px; }");
+    setAlignment(Qt::AlignLeft | Qt::AlignTop);
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    move(4, 4);
+
+    // 0.5초마다 갱신 (HUD 자체가 GUI 스레드를 잡아먹지 않도록)
+    refreshTimer = new QTimer(this);
+    refreshTimer->setInterval(500);
+    connect(refreshTimer, &QTimer::timeout, this, &FrameTraceHud::refresh);
+    refreshTimer->start();
+
+    refresh();
+}
+
+FrameTraceHud *FrameTraceHud::attachIfEnabled(QWidget *parent)
+{
+    if (!FrameTrace::getInstance()->isHudEnabled())
+        return nullptr;
+
+    FrameTraceHud *hud = new FrameTraceHud(parent);
+    hud->raise();
+    hud->show();
+    return hud;
+}
+
+void FrameTraceHud::refresh()
+{
+    FrameTrace::StageStats stats[FrameTrace::STAGE_COUNT];
+    double fps = 0.0;
+    FrameTrace::getInstance()->computeStats(stats, fps);
+
+    QString text = QString("fps %1\n").arg(fps, 0, 'f', 1);
+    text += QString("%1 %2 %3\n").arg("stage", -8).arg("p50", 6).arg("p99", 6);
+    for (int stage = FrameTrace::STAGE_DEQUEUE; stage < FrameTrace::STAGE_COUNT; stage++) {
+        if (!stats[stage].samples)
+            continue;
+        text += QString("%1 %2 %3\n")
+                .arg(FrameTrace::stageName(stage), -8)
+                .arg(stats[stage].p50Ms, 6, 'f', 2)
+                .arg(stats[stage].p99Ms, 6, 'f', 2);
+    }
+
+    setText(text.trimmed());
+    adjustSize();
+}
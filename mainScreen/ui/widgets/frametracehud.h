@@ -0,0 +1,26 @@
+#ifndef FRAMETRACEHUD_H
+#define FRAMETRACEHUD_H
+
+#include <QLabel>
+#include <QTimer>
+
+// 카메라 화면 위에 겹쳐 표시하는 프레임 파이프라인 HUD
+// FrameTrace 통계(단계별 p50/p99, 게시 fps)를 주기적으로 갱신한다.
+class FrameTraceHud : public QLabel
+{
+    Q_OBJECT
+
+public:
+    explicit FrameTraceHud(QWidget *parent = nullptr);
+
+    // COLORBINGO_FRAME_HUD가 설정된 경우에만 parent 위에 HUD 생성 (아니면 nullptr)
+    static FrameTraceHud *attachIfEnabled(QWidget *parent);
+
+private slots:
+    void refresh();
+
+private:
+    QTimer *refreshTimer;
+};
+
+#endif // FRAMETRACEHUD_H
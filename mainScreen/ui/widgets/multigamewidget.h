@@ -26,6 +26,11 @@
 #include "hardwareInterface/webcambutton.h"
 #include "p2pnetwork.h"
 #include "../../utils/pixelartgenerator.h"
+#include "../../utils/summedareatable.h"
+#include "../../utils/previewrenderer.h"
+#include "ui/widgets/colorswatchlabel.h"
+#include "ui/widgets/colorhandleslider.h"
+#include "ui/widgets/cameraview.h"
 #include "hardwareInterface/accelerometer.h"
 #include <QSet>
 
@@ -51,6 +56,9 @@ signals:
 private slots:
     void updateCameraFrame();
     void handleCameraDisconnect();
+    void handleCameraRecovered();
+    void handleCameraReady(bool ok);
+    void handleAutoMatch(int index, const QColor &color);
     void onCircleSliderValueChanged(int value);
     void onCaptureButtonClicked();
     void clearXMark();
@@ -64,7 +72,6 @@ private slots:
     void stopGameTimer();
     void showFailMessage();
     void hideFailAndReset();
-    void restartCamera();
     void onBackButtonClicked();
     void updateRgbValues();
 
@@ -84,6 +91,8 @@ private:
     QColor getCellColor(int row, int col);
     QString getCellColorName(int row, int col);
     int colorDistance(const QColor &c1, const QColor &c2);
+    // 선택한 칸 판정 (임계값 + 다른 열린 칸과의 모호성 검사, ColorMatcher::matchesTarget)
+    bool matchesSelectedCell(const QColor &color, int row, int col, int threshold);
     bool isColorBright(const QColor &color);
     void updateBingoScore();
     void updateOpponentScore(int opponentScore);
@@ -96,6 +105,7 @@ private:
 
     // 원 내부 픽셀의 RGB 평균값 계산 함수
     void calculateAverageRGB(const QImage &image, int centerX, int centerY, int radius);
+    QColor stabilityColor() const;  // RGB 라벨 상태 점 색 (안정: 초록, 흔들림: 주황)
 
     // 가속도계 관련 함수 추가
     void initializeAccelerometer();
@@ -104,19 +114,23 @@ private:
     void updateTiltColorDisplay(const QColor &color);
 
     // 색상 매치 처리 함수
-    void processColorMatch(const QColor &colorToMatch);
+    void processColorMatch(const QColor &colorToMatch, bool fromAutoMatch = false);
+    void updateAutoMatchTargets();
 
     // 카메라 관련 상태 변수
     bool isCapturing;           // 카메라 캡처 중인지 여부
+    bool boardFromCamera;       // 판 색을 준비 화면에서 카메라로 뽑았는지 (아니면 랜덤 판)
 
     // 원 표시 관련 변수
     bool showCircle;            // 원 표시 여부
     int circleRadius;           // 원 반지름
+    int autoMatchFrames;        // 자동 매칭 유지 프레임 수 (0이면 버튼으로만 매칭)
 
     // RGB 평균값 관련 변수
     int avgRed;                 // 평균 R 값
     int avgGreen;               // 평균 G 값
     int avgBlue;                // 평균 B 값
+    bool colorStable;           // 캡처 스레드가 판정한 평균 색 안정 여부
     bool showRgbValues;         // RGB 값 표시 여부
 
     // 빙고 상태 변수
@@ -138,7 +152,7 @@ private:
     QLabel *opponentBingoScoreLabel;
 
     // 카메라 관련 위젯
-    QLabel *cameraView;
+    CameraView *cameraView;
     V4L2Camera *camera;
     QImage originalFrame;       // 카메라에서 캡처한 원본 프레임
 
@@ -147,18 +161,17 @@ private:
     QPushButton *captureButton;  // 캡처 및 중지 버튼으로 역할 변경
 
     // 원 표시 관련 위젯
-    QSlider *circleSlider;
+    ColorHandleSlider *circleSlider;
     QCheckBox *circleCheckBox;
-    QLabel *circleValueLabel;
+    ColorSwatchLabel *circleValueLabel;
 
     // RGB 값 표시 관련 위젯
     QCheckBox *rgbCheckBox;
-    QLabel *cameraRgbValueLabel;
+    ColorSwatchLabel *cameraRgbValueLabel;
 
     // 타이머
     QTimer *fadeXTimer;         // X 표시 사라지는 타이머
     QTimer *successTimer;       // 성공 메시지 타이머
-    QTimer *cameraRestartTimer; // 카메라 주기적 재시작 타이머
 
     // 성공 메시지 관련 멤버
     QLabel *successLabel;
@@ -199,7 +212,7 @@ private:
     QTimer* sliderUpdateTimer;  // 슬라이더 디바운싱용 타이머
     bool isSliderDragging;      // 슬라이더 드래그 중 여부
     int pendingCircleRadius;    // 대기 중인 원 반지름 값
-    QPixmap previewPixmap;      // 미리보기용 픽스맵
+    PreviewRenderer previewRenderer; // 카메라 미리보기 (스케일 + 원 테두리)
 
     // 체크박스 디바운싱 관련 변수
     QTimer* checkboxDebounceTimer;  // 체크박스 디바운싱용 타이머
@@ -238,7 +251,9 @@ private:
     // 원 미리보기 함수 추가
     void updateCirclePreview(int radius);
 
-    const int THRESHOLD = 8;
+    // 틸트 조절 후 제출 판정 임계값 (CIEDE2000, ColorMatcher::MATCH_THRESHOLD와 같은 모의 캡처로 맞춤:
+    // 같은 칸 통과율이 예전 RGB 거리 8은 70.5%, ΔE 9는 71.5%)
+    const int THRESHOLD = 9;
 
     // 보너스 색상 관련 변수 추가
     bool isBonusCell[3][3]; // 보너스 칸(완전 랜덤 색상) 여부 추적
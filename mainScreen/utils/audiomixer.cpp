@@ -0,0 +1,114 @@
+#include "audiomixer.h"
+#include <QDebug>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MIXER_HAVE_SSE2 1
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define MIXER_HAVE_NEON 1
+#if !defined(__aarch64__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+
+static inline qint16 saturate16(int value)
+{
+    return (qint16)qBound(-32768, value, 32767);
+}
+
+int AudioMixer::gainFromVolume(float volume)
+{
+    return qBound(0, (int)(volume * UNITY_GAIN + 0.5f), MAX_GAIN);
+}
+
+void AudioMixer::mixScalar(qint16 *dst, const qint16 *src, int count, int gain)
+{
+    for (int i = 0; i < count; i++) {
+        dst[i] = saturate16(dst[i] + saturate16((src[i] * gain) >> 12));
+    }
+}
+
+#ifdef MIXER_HAVE_SSE2
+// SSE2: 16x16 곱의 하위/상위 절반을 합쳐 32비트 곱을 만들고 packs로 포화, adds로 포화 덧셈
+static void mixSse2(qint16 *dst, const qint16 *src, int count, int gain)
+{
+    const __m128i g = _mm_set1_epi16((short)gain);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        __m128i lo = _mm_mullo_epi16(s, g);
+        __m128i hi = _mm_mulhi_epi16(s, g);
+        __m128i p0 = _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 12);
+        __m128i p1 = _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 12);
+        __m128i scaled = _mm_packs_epi32(p0, p1);
+
+        __m128i *out = reinterpret_cast<__m128i *>(dst + i);
+        _mm_storeu_si128(out, _mm_adds_epi16(_mm_loadu_si128(out), scaled));
+    }
+
+    for (; i < count; i++) {
+        dst[i] = saturate16(dst[i] + saturate16((src[i] * gain) >> 12));
+    }
+}
+#endif // MIXER_HAVE_SSE2
+
+#ifdef MIXER_HAVE_NEON
+// NEON: vmull로 32비트 곱, vqshrn으로 시프트와 포화를 한 번에, vqadd로 포화 덧셈
+static void mixNeon(qint16 *dst, const qint16 *src, int count, int gain)
+{
+    const int16x4_t g = vdup_n_s16((int16_t)gain);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t s = vld1q_s16(src + i);
+        int32x4_t p0 = vmull_s16(vget_low_s16(s), g);
+        int32x4_t p1 = vmull_s16(vget_high_s16(s), g);
+        int16x8_t scaled = vcombine_s16(vqshrn_n_s32(p0, 12), vqshrn_n_s32(p1, 12));
+
+        vst1q_s16(dst + i, vqaddq_s16(vld1q_s16(dst + i), scaled));
+    }
+
+    for (; i < count; i++) {
+        dst[i] = saturate16(dst[i] + saturate16((src[i] * gain) >> 12));
+    }
+}
+#endif // MIXER_HAVE_NEON
+
+AudioMixer::Kernel AudioMixer::selectKernel()
+{
+    Kernel k = { &AudioMixer::mixScalar, "scalar" };
+
+#ifdef MIXER_HAVE_SSE2
+    k.mix = &mixSse2;
+    k.name = "sse2";
+#endif
+
+#ifdef MIXER_HAVE_NEON
+#if defined(__aarch64__)
+    k.mix = &mixNeon;
+    k.name = "neon";
+#else
+    if (getauxval(AT_HWCAP) & HWCAP_NEON) {
+        k.mix = &mixNeon;
+        k.name = "neon";
+    }
+#endif
+#endif
+
+    qDebug() << "AudioMixer: using" << k.name << "kernel";
+    return k;
+}
+
+const AudioMixer::Kernel &AudioMixer::kernel()
+{
+    static const Kernel k = selectKernel();
+    return k;
+}
+
+const char *AudioMixer::kernelName()
+{
+    return kernel().name;
+}
@@ -0,0 +1,39 @@
+#ifndef AUDIOMIXER_H
+#define AUDIOMIXER_H
+
+#include <QtGlobal>
+
+// 오디오 엔진용 S16 믹싱 커널
+// 음성마다 게인(Q12)을 곱해 포화시킨 뒤 출력 버퍼에 포화 덧셈한다.
+// 8샘플 단위로 SSE2 / NEON을 사용하고 나머지는 스칼라, 세 경로의 결과는 비트 단위로 같다.
+class AudioMixer
+{
+public:
+    static const int UNITY_GAIN = 4096;     // Q12 (1.0)
+    static const int MAX_GAIN = 32767;      // 약 8.0
+
+    // dst[i] = sat16(dst[i] + sat16((src[i] * gain) >> 12)), count는 샘플 수 (프레임 * 채널)
+    typedef void (*MixKernel)(qint16 *dst, const qint16 *src, int count, int gain);
+
+    static void mix(qint16 *dst, const qint16 *src, int count, int gain)
+    {
+        kernel().mix(dst, src, count, gain);
+    }
+
+    // 실수 볼륨을 Q12 게인으로 (0 ~ MAX_GAIN)
+    static int gainFromVolume(float volume);
+
+    static const char *kernelName();
+
+private:
+    struct Kernel {
+        MixKernel mix;
+        const char *name;
+    };
+
+    static void mixScalar(qint16 *dst, const qint16 *src, int count, int gain);
+    static const Kernel &kernel();
+    static Kernel selectKernel();
+};
+
+#endif // AUDIOMIXER_H
@@ -0,0 +1,111 @@
+#include "automatcher.h"
+#include <QDebug>
+#include <QMutexLocker>
+
+AutoMatcher::AutoMatcher() :
+    pendingDirty(false),
+    active(false),
+    candidate(-1),
+    streak(0)
+{
+    pending.count = current.count = 0;
+    pending.threshold = current.threshold = 0;
+    pending.holdFrames = current.holdFrames = DEFAULT_HOLD_FRAMES;
+
+    // Lab 표를 GUI 스레드에서 먼저 만들어 둠 (캡처 스레드는 읽기만 함)
+    ColorMatcher::getInstance();
+}
+
+int AutoMatcher::holdFramesFromEnvironment()
+{
+    QByteArray value = qgetenv("COLORBINGO_AUTO_MATCH");
+    if (value.isEmpty() || value == "0")
+        return 0;
+
+    bool ok = false;
+    int frames = value.toInt(&ok);
+    return (ok && frames >= 2) ? frames : DEFAULT_HOLD_FRAMES;
+}
+
+void AutoMatcher::setTargets(const QColor *colors, const bool *open, int count, int threshold, int holdFrames)
+{
+    ColorMatcher *matcher = ColorMatcher::getInstance();
+    count = qBound(0, count, (int)MAX_TARGETS);
+
+    bool anyOpen = false;
+    {
+        QMutexLocker locker(&pendingMutex);
+        for (int i = 0; i < count; i++) {
+            pending.colors[i] = matcher->toLab(colors[i]);
+            pending.open[i] = open[i];
+            anyOpen = anyOpen || open[i];
+        }
+        pending.count = count;
+        pending.threshold = threshold;
+        pending.holdFrames = qMax(1, holdFrames);
+    }
+
+    pendingDirty.store(true, std::memory_order_release);
+    active.store(anyOpen, std::memory_order_relaxed);
+}
+
+void AutoMatcher::clear()
+{
+    {
+        QMutexLocker locker(&pendingMutex);
+        pending.count = 0;
+    }
+    pendingDirty.store(true, std::memory_order_release);
+    active.store(false, std::memory_order_relaxed);
+}
+
+void AutoMatcher::applyPending()
+{
+    QMutexLocker locker(&pendingMutex);
+    current = pending;
+    candidate = -1;
+    streak = 0;
+}
+
+int AutoMatcher::process(int r, int g, int b)
+{
+    if (pendingDirty.exchange(false, std::memory_order_acquire)) {
+        applyPending();
+    }
+    if (current.count <= 0)
+        return -1;
+
+    // 열린 칸 전체를 한 번에 점수화 (9칸 x CIEDE2000, 프레임당 수 us)
+    ColorMatcher *matcher = ColorMatcher::getInstance();
+    float scores[MAX_TARGETS];
+    LabColor sample = matcher->toLab(r, g, b);
+    matcher->scoreAll(sample, current.colors, current.count, scores);
+
+    // 가장 가까운 열린 칸을 그 칸을 골라 버튼으로 캡처한 것과 같은 기준으로 판정
+    int best = -1;
+    for (int i = 0; i < current.count; i++) {
+        if (current.open[i] && (best < 0 || scores[i] < scores[best]))
+            best = i;
+    }
+
+    if (best < 0 || !ColorMatcher::acceptsMatch(scores, current.open, current.count, best, current.threshold)) {
+        candidate = -1;
+        streak = 0;
+        return -1;
+    }
+
+    // 다른 칸으로 바뀌면 처음부터 다시 셈
+    if (best != candidate) {
+        candidate = best;
+        streak = 0;
+    }
+    if (++streak < current.holdFrames)
+        return -1;
+
+    // 확정: GUI가 결과를 반영해 목표를 다시 설정할 때까지 더 확정하지 않음
+    // (응답 전에 비슷한 다른 칸까지 연달아 확정되는 것을 막음)
+    current.count = 0;
+    candidate = -1;
+    streak = 0;
+    return best;
+}
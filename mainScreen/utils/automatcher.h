@@ -0,0 +1,62 @@
+#ifndef AUTOMATCHER_H
+#define AUTOMATCHER_H
+
+#include <QColor>
+#include <QMutex>
+#include <atomic>
+#include "utils/colormatcher.h"
+
+// 연속 자동 매칭: 캡처 스레드가 매 프레임 샘플링 원 평균을 열린 칸 전체와 비교하고,
+// 같은 칸이 holdFrames 프레임 연속으로 버튼 캡처와 같은 판정(ColorMatcher::acceptsMatch)을
+// 통과하면 그 칸을 확정한다.
+// 버튼 → 정지 → 기울이기 → 제출 과정 없이 색을 맞출 수 있게 하는 선택 모드.
+//
+// 목표 칸은 GUI 스레드가 setTargets()로 바꾸고, 캡처 스레드는 process()에서
+// 변경 플래그가 있을 때만 잠금을 잡아 복사하므로 평소 프레임 경로에는 잠금이 없다.
+//
+// COLORBINGO_AUTO_MATCH=1       자동 매칭 활성화 (기본 DEFAULT_HOLD_FRAMES 프레임 유지)
+// COLORBINGO_AUTO_MATCH=<N>     N 프레임 연속 유지 시 확정 (N >= 2)
+class AutoMatcher
+{
+public:
+    static const int MAX_TARGETS = 9;
+    static const int DEFAULT_HOLD_FRAMES = 5;
+
+    AutoMatcher();
+
+    // GUI 스레드: 목표 색과 열린(아직 맞추지 않은) 칸 지정, 연속 카운트는 초기화
+    // threshold는 게임 판정과 같은 0~100 거리 (ColorMatcher::distance 기준)
+    void setTargets(const QColor *colors, const bool *open, int count, int threshold, int holdFrames);
+    void clear();
+    bool isActive() const { return active.load(std::memory_order_relaxed); }
+
+    // 캡처 스레드: 이번 프레임 원 평균으로 점수 계산
+    // 확정된 칸 인덱스를 반환 (없으면 -1), 확정 후에는 setTargets()가 다시 호출될 때까지 멈춘다
+    int process(int r, int g, int b);
+
+    // 환경 변수로 정한 유지 프레임 수 (비활성이면 0)
+    static int holdFramesFromEnvironment();
+
+private:
+    struct TargetSet {
+        LabColor colors[MAX_TARGETS];
+        bool open[MAX_TARGETS];
+        int count;
+        int threshold;
+        int holdFrames;
+    };
+
+    void applyPending();
+
+    QMutex pendingMutex;
+    TargetSet pending;                  // GUI 스레드가 쓰고 캡처 스레드가 가져감
+    std::atomic<bool> pendingDirty;
+    std::atomic<bool> active;
+
+    // 이하 캡처 스레드 전용
+    TargetSet current;
+    int candidate;                      // 연속으로 임계값 이내였던 칸 (-1이면 없음)
+    int streak;
+};
+
+#endif // AUTOMATCHER_H
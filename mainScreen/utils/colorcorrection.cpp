@@ -0,0 +1,81 @@
+#include "colorcorrection.h"
+
+ColorCorrection::ColorCorrection() :
+    gainsActive(false)
+{
+    gains[0] = gains[1] = gains[2] = UNITY_GAIN;
+    rebuildCurves();
+}
+
+bool ColorCorrection::loadLut(const QString &path)
+{
+    if (!colorLut.loadCube(path))
+        return false;
+
+    colorLut.setInputCurves(gainsActive ? curves[0] : NULL,
+                            gainsActive ? curves[1] : NULL,
+                            gainsActive ? curves[2] : NULL);
+    return true;
+}
+
+void ColorCorrection::setGains(int red, int green, int blue)
+{
+    if (red == gains[0] && green == gains[1] && blue == gains[2])
+        return;
+
+    gains[0] = red;
+    gains[1] = green;
+    gains[2] = blue;
+    gainsActive = (red != UNITY_GAIN || green != UNITY_GAIN || blue != UNITY_GAIN);
+    rebuildCurves();
+
+    if (colorLut.isValid()) {
+        colorLut.setInputCurves(gainsActive ? curves[0] : NULL,
+                                gainsActive ? curves[1] : NULL,
+                                gainsActive ? curves[2] : NULL);
+    }
+}
+
+void ColorCorrection::rebuildCurves()
+{
+    for (int ch = 0; ch < 3; ch++) {
+        for (int v = 0; v < 256; v++) {
+            curves[ch][v] = (uchar)qMin(255, (v * gains[ch] + UNITY_GAIN / 2) / UNITY_GAIN);
+        }
+    }
+}
+
+void ColorCorrection::applyRow(uchar *rgb, int width) const
+{
+    // LUT 입력 곡선에 게인이 이미 들어 있음
+    if (colorLut.isValid()) {
+        colorLut.applyRow(rgb, width);
+        return;
+    }
+    if (!gainsActive)
+        return;
+
+    const uchar *red = curves[0];
+    const uchar *green = curves[1];
+    const uchar *blue = curves[2];
+    for (int x = 0; x < width; x++) {
+        rgb[0] = red[rgb[0]];
+        rgb[1] = green[rgb[1]];
+        rgb[2] = blue[rgb[2]];
+        rgb += 3;
+    }
+}
+
+void ColorCorrection::map(int &r, int &g, int &b) const
+{
+    if (colorLut.isValid()) {
+        colorLut.map(r, g, b);
+        return;
+    }
+    if (!gainsActive)
+        return;
+
+    r = curves[0][r & 0xff];
+    g = curves[1][g & 0xff];
+    b = curves[2][b & 0xff];
+}
@@ -0,0 +1,39 @@
+#ifndef COLORCORRECTION_H
+#define COLORCORRECTION_H
+
+#include "utils/colorlut.h"
+
+// 변환 직후 행 단위로 적용하는 색 보정 단계 (화이트 밸런스 게인 -> 3D LUT)
+// 변환 모듈(YuvConverter / FrameDecoder)이 한 행을 변환한 직후 같은 행에 적용한다.
+// LUT가 있으면 게인은 LUT 입력 곡선에 합쳐져 추가 비용이 없고,
+// LUT가 없으면 채널별 256 바이트 표 조회 한 번이다.
+// 캡처 스레드 전용 (LUT 로드는 캡처 시작 전에 이루어짐)
+class ColorCorrection
+{
+public:
+    static const int UNITY_GAIN = 256;  // 게인 Q8 (256 = 1.0)
+
+    ColorCorrection();
+
+    bool loadLut(const QString &path);
+    const ColorLut &lut() const { return colorLut; }
+
+    // 채널별 게인 (Q8), 모두 UNITY_GAIN이면 게인 단계 생략
+    void setGains(int red, int green, int blue);
+
+    bool isActive() const { return colorLut.isValid() || gainsActive; }
+
+    // RGB888 한 행을 제자리에서 보정
+    void applyRow(uchar *rgb, int width) const;
+    void map(int &r, int &g, int &b) const;
+
+private:
+    void rebuildCurves();
+
+    ColorLut colorLut;
+    int gains[3];
+    bool gainsActive;
+    uchar curves[3][256];
+};
+
+#endif // COLORCORRECTION_H
@@ -0,0 +1,287 @@
+#include "colorlut.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QRegularExpression>
+
+namespace {
+// 묶음 한 칸에서 채널 간격 (Q4 값 x 가중치 256 합이 2^21 미만)
+const int CHANNEL_SHIFT = 21;
+const quint64 CHANNEL_MASK = (1u << CHANNEL_SHIFT) - 1;
+}
+
+ColorLut::ColorLut() :
+    size(0),
+    redStep(0),
+    greenStep(0),
+    blueStep(0)
+{
+    for (int ch = 0; ch < 3; ch++) {
+        inputMin[ch] = 0.0f;
+        inputMax[ch] = 1.0f;
+    }
+    setInputCurves(NULL, NULL, NULL);
+}
+
+void ColorLut::setInputCurves(const uchar *red, const uchar *green, const uchar *blue)
+{
+    const uchar *source[3] = { red, green, blue };
+    for (int ch = 0; ch < 3; ch++) {
+        for (int v = 0; v < 256; v++) {
+            curves[ch][v] = source[ch] ? source[ch][v] : (uchar)v;
+        }
+    }
+    if (size > 0) {
+        buildIndexTables();
+    }
+}
+
+bool ColorLut::loadCube(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qDebug() << "ColorLut: cannot open" << path;
+        return false;
+    }
+
+    int cubeSize = 0;
+    float domainMin[3] = { 0.0f, 0.0f, 0.0f };
+    float domainMax[3] = { 1.0f, 1.0f, 1.0f };
+    QString cubeTitle;
+    QVector<float> values;
+    int lineNumber = 0;
+
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+        lineNumber++;
+        if (line.isEmpty() || line.startsWith('#'))
+            continue;
+
+        // 공백과 탭 모두 구분자로 허용
+        QStringList parts = line.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+        const QString &key = parts.at(0);
+
+        // 첫 토큰이 숫자인 줄만 데이터 행, 나머지는 모두 키워드
+        bool numeric = false;
+        key.toFloat(&numeric);
+        if (numeric) {
+            if (parts.size() != 3) {
+                qDebug() << "ColorLut: bad data row at line" << lineNumber << "of" << path;
+                return false;
+            }
+            for (int i = 0; i < 3; i++) {
+                bool ok = false;
+                values.append(parts.at(i).toFloat(&ok));
+                if (!ok) {
+                    qDebug() << "ColorLut: bad value at line" << lineNumber << "of" << path;
+                    return false;
+                }
+            }
+        } else if (key == "TITLE") {
+            cubeTitle = line.mid(5).trimmed().remove('"');
+        } else if (key == "LUT_3D_SIZE" && parts.size() == 2) {
+            cubeSize = parts.at(1).toInt();
+            if (cubeSize < MIN_SIZE || cubeSize > MAX_SIZE) {
+                qDebug() << "ColorLut: unsupported LUT_3D_SIZE" << cubeSize << "in" << path;
+                return false;
+            }
+            values.reserve(cubeSize * cubeSize * cubeSize * 3);
+        } else if (key == "LUT_1D_SIZE") {
+            qDebug() << "ColorLut: 1D LUT is not supported:" << path;
+            return false;
+        } else if ((key == "DOMAIN_MIN" || key == "DOMAIN_MAX") && parts.size() == 4) {
+            float *domain = (key == "DOMAIN_MIN") ? domainMin : domainMax;
+            for (int i = 0; i < 3; i++) {
+                domain[i] = parts.at(i + 1).toFloat();
+            }
+        } else if ((key == "LUT_3D_INPUT_RANGE" || key == "LUT_1D_INPUT_RANGE") && parts.size() == 3) {
+            // Resolve 등이 쓰는 형식: 세 채널 공통 입력 범위 (min max)
+            for (int i = 0; i < 3; i++) {
+                domainMin[i] = parts.at(1).toFloat();
+                domainMax[i] = parts.at(2).toFloat();
+            }
+        } else {
+            // 알 수 없는 키워드는 무시
+            qDebug() << "ColorLut: ignoring line" << lineNumber << ":" << line;
+        }
+    }
+
+    if (cubeSize == 0 || values.size() != cubeSize * cubeSize * cubeSize * 3) {
+        qDebug() << "ColorLut: expected" << cubeSize * cubeSize * cubeSize << "entries, got"
+                 << values.size() / 3 << "in" << path;
+        return false;
+    }
+
+    for (int channel = 0; channel < 3; channel++) {
+        if (!(domainMax[channel] > domainMin[channel])) {
+            qDebug() << "ColorLut: invalid DOMAIN_MIN/DOMAIN_MAX in" << path;
+            return false;
+        }
+    }
+
+    // 정의역은 입력 좌표 범위이므로 격자 위치 표에서 적용하고, 출력은 0~1로 자른 뒤 0~255 Q4로 묶어 저장
+    grid.resize(values.size() / 3);
+    for (int i = 0; i < grid.size(); i++) {
+        quint64 packed = 0;
+        for (int channel = 0; channel < 3; channel++) {
+            float v = qBound(0.0f, values[i * 3 + channel], 1.0f);
+            packed |= (quint64)(v * 255.0f * 16.0f + 0.5f) << (channel * CHANNEL_SHIFT);
+        }
+        grid[i] = packed;
+    }
+
+    size = cubeSize;
+    lutTitle = cubeTitle;
+    for (int channel = 0; channel < 3; channel++) {
+        inputMin[channel] = domainMin[channel];
+        inputMax[channel] = domainMax[channel];
+    }
+    buildIndexTables();
+
+    qDebug() << "ColorLut: loaded" << path << size << "^3" << (lutTitle.isEmpty() ? QString() : lutTitle);
+    return true;
+}
+
+void ColorLut::buildIndexTables()
+{
+    // .cube는 빨강이 가장 빠르게 변하는 순서
+    redStep = 1;
+    greenStep = size;
+    blueStep = size * size;
+
+    // 채널별로 입력 바이트의 격자 위치를 계산 (정의역 [min, max]가 격자 0 ~ size-1에 대응)
+    int gridIndex[3][256];
+    int gridFrac[3][256];
+    for (int channel = 0; channel < 3; channel++) {
+        float scale = (size - 1) * 256.0f / (inputMax[channel] - inputMin[channel]);
+        for (int v = 0; v < 256; v++) {
+            // 격자 위치 (Q8): (v / 255 - min) / (max - min) * (size - 1), 정의역 밖은 양 끝으로
+            float input = qBound(inputMin[channel], v / 255.0f, inputMax[channel]);
+            int position = (int)((input - inputMin[channel]) * scale + 0.5f);
+            int index = position >> 8;
+            int frac = position & 0xff;
+            // 마지막 격자점은 바로 앞 칸의 끝(소수부 1.0)으로 표현해 이웃 접근이 범위를 넘지 않게 함
+            if (index >= size - 1) {
+                index = size - 2;
+                frac = 256;
+            }
+            gridIndex[channel][v] = index;
+            gridFrac[channel][v] = frac;
+        }
+    }
+
+    // 입력 곡선을 거친 값의 격자 위치를 미리 합성
+    for (int v = 0; v < 256; v++) {
+        redOffset[v] = gridIndex[0][curves[0][v]] * redStep;
+        greenOffset[v] = gridIndex[1][curves[1][v]] * greenStep;
+        blueOffset[v] = gridIndex[2][curves[2][v]] * blueStep;
+        redFrac[v] = gridFrac[0][curves[0][v]];
+        greenFrac[v] = gridFrac[1][curves[1][v]];
+        blueFrac[v] = gridFrac[2][curves[2][v]];
+    }
+}
+
+inline void ColorLut::mapPixel(const quint64 *table, uchar *pixel) const
+{
+    // 입력을 먼저 읽어 둠 (출력이 같은 자리에 쓰이므로)
+    int r = pixel[0];
+    int g = pixel[1];
+    int b = pixel[2];
+    const quint64 *c000 = table + redOffset[r] + greenOffset[g] + blueOffset[b];
+    int fr = redFrac[r];
+    int fg = greenFrac[g];
+    int fb = blueFrac[b];
+
+    // 사면체 보간: 단위 정육면체를 소수부 크기 순서로 6개 사면체 중 하나로 나눔
+    // out = w0 * c000 + w1 * c1 + w2 * c2 + w3 * c111 (가중치 합 256)
+    int step1, step2;
+    int w0, w1, w2, w3;
+    if (fr >= fg) {
+        if (fg >= fb) {         // r >= g >= b
+            step1 = redStep;
+            step2 = redStep + greenStep;
+            w0 = 256 - fr; w1 = fr - fg; w2 = fg - fb; w3 = fb;
+        } else if (fr >= fb) {  // r >= b > g
+            step1 = redStep;
+            step2 = redStep + blueStep;
+            w0 = 256 - fr; w1 = fr - fb; w2 = fb - fg; w3 = fg;
+        } else {                // b > r >= g
+            step1 = blueStep;
+            step2 = redStep + blueStep;
+            w0 = 256 - fb; w1 = fb - fr; w2 = fr - fg; w3 = fg;
+        }
+    } else {
+        if (fr >= fb) {         // g > r >= b
+            step1 = greenStep;
+            step2 = redStep + greenStep;
+            w0 = 256 - fg; w1 = fg - fr; w2 = fr - fb; w3 = fb;
+        } else if (fg >= fb) {  // g >= b > r
+            step1 = greenStep;
+            step2 = greenStep + blueStep;
+            w0 = 256 - fg; w1 = fg - fb; w2 = fb - fr; w3 = fr;
+        } else {                // b > g > r
+            step1 = blueStep;
+            step2 = greenStep + blueStep;
+            w0 = 256 - fb; w1 = fb - fg; w2 = fg - fr; w3 = fr;
+        }
+    }
+
+    // 세 채널을 한 번에: Q4 값 x Q8 가중치 -> 채널마다 Q12 (21비트 안)
+    quint64 sum = w0 * c000[0] + w1 * c000[step1] + w2 * c000[step2]
+                + w3 * c000[redStep + greenStep + blueStep];
+
+    // 반올림 후 8비트 (최대 255를 넘지 않음)
+    pixel[0] = (uchar)(((sum & CHANNEL_MASK) + (1 << 11)) >> 12);
+    pixel[1] = (uchar)((((sum >> CHANNEL_SHIFT) & CHANNEL_MASK) + (1 << 11)) >> 12);
+    pixel[2] = (uchar)((((sum >> (2 * CHANNEL_SHIFT)) & CHANNEL_MASK) + (1 << 11)) >> 12);
+}
+
+void ColorLut::applyRow(uchar *rgb, int width) const
+{
+    if (size == 0)
+        return;
+
+    const quint64 *table = grid.constData();
+    for (int x = 0; x < width; x++) {
+        mapPixel(table, rgb);
+        rgb += 3;
+    }
+}
+
+void ColorLut::map(int &r, int &g, int &b) const
+{
+    if (size == 0)
+        return;
+
+    uchar pixel[3] = { (uchar)r, (uchar)g, (uchar)b };
+    mapPixel(grid.constData(), pixel);
+    r = pixel[0];
+    g = pixel[1];
+    b = pixel[2];
+}
+
+QString ColorLut::pathForCamera(const QString &cardName)
+{
+    QString explicitPath = QString::fromLocal8Bit(qgetenv("COLORBINGO_CAMERA_LUT"));
+    if (!explicitPath.isEmpty())
+        return explicitPath;
+
+    QString dir = QString::fromLocal8Bit(qgetenv("COLORBINGO_CAMERA_LUT_DIR"));
+    if (dir.isEmpty() || cardName.isEmpty())
+        return QString();
+
+    QString name;
+    for (QChar ch : cardName.trimmed()) {
+        name.append((ch.isLetterOrNumber() && ch.unicode() < 128) ? ch : QChar('_'));
+    }
+
+    QString path = QDir(dir).filePath(name + ".cube");
+    if (!QFileInfo::exists(path)) {
+        qDebug() << "ColorLut: no LUT for camera" << cardName << "(" << path << ")";
+        return QString();
+    }
+    return path;
+}
@@ -0,0 +1,70 @@
+#ifndef COLORLUT_H
+#define COLORLUT_H
+
+#include <QString>
+#include <QVector>
+
+// 카메라 색 보정용 3D LUT (.cube 형식, 보통 17^3 또는 33^3)
+// 입력 바이트마다 격자 위치와 소수부(Q8)를 미리 표로 만들어 두고,
+// 픽셀마다 사면체 보간(격자 정점 4개)으로 RGB를 변환한다.
+// 격자 값은 0~255를 Q4(12비트)로 하여 세 채널을 64비트 한 칸에 21비트 간격으로 묶어 둔다.
+// 가중치(Q8, 합 256)를 곱해 더해도 각 채널이 21비트를 넘지 않으므로
+// 정점 하나당 로드 1번 + 곱셈 1번으로 세 채널을 동시에 보간한다 (SWAR).
+// 17^3이면 약 40KB로 L1/L2에 들어간다.
+//
+// 변환 모듈(YuvConverter / FrameDecoder)이 한 행을 변환한 직후 같은 행에 적용하므로
+// 프레임 전체를 다시 읽는 별도 패스가 없다 (ColorCorrection 참고).
+// 로드는 캡처 시작 전, 입력 곡선 변경은 프레임 사이에 캡처 스레드에서만 하므로 잠금이 없다.
+class ColorLut
+{
+public:
+    static const int MIN_SIZE = 2;
+    static const int MAX_SIZE = 65;
+
+    ColorLut();
+
+    // Adobe/Resolve .cube 파일 로드 (LUT_3D_SIZE, DOMAIN_MIN/MAX, LUT_3D_INPUT_RANGE 지원, 1D LUT는 미지원)
+    bool loadCube(const QString &path);
+    bool isValid() const { return size > 0; }
+    int gridSize() const { return size; }
+    QString title() const { return lutTitle; }
+
+    // LUT 앞에 적용할 채널별 1D 곡선 (화이트 밸런스 게인 등, NULL이면 그대로)
+    // 격자 위치 표에 합쳐 두므로 픽셀당 추가 비용이 없다
+    void setInputCurves(const uchar *red, const uchar *green, const uchar *blue);
+
+    // RGB888 한 행을 제자리에서 변환
+    void applyRow(uchar *rgb, int width) const;
+    void map(int &r, int &g, int &b) const;
+
+    // COLORBINGO_CAMERA_LUT=<파일.cube>      모든 카메라에 이 LUT 사용
+    // COLORBINGO_CAMERA_LUT_DIR=<디렉터리>   <디렉터리>/<카메라 이름>.cube 를 찾음
+    // 카메라 이름(VIDIOC_QUERYCAP card)의 영문/숫자 외 문자는 '_'로 바꾼다.
+    // 해당하는 파일이 없으면 빈 문자열
+    static QString pathForCamera(const QString &cardName);
+
+private:
+    inline void mapPixel(const quint64 *table, uchar *pixel) const;
+    void buildIndexTables();
+
+    int size;
+    QString lutTitle;
+    QVector<quint64> grid;      // (b * size + g) * size + r 순서, R | G << 21 | B << 42 (각 0~255 Q4)
+
+    uchar curves[3][256];       // 입력 곡선 (기본은 항등)
+    float inputMin[3];          // DOMAIN_MIN/MAX: 격자 양 끝에 대응하는 입력 값 (기본 0~1)
+    float inputMax[3];
+
+    // 입력 바이트별 격자 시작 오프셋 (grid 원소 단위)과 보간 소수부 (0~256), 입력 곡선 포함
+    int redOffset[256];
+    int greenOffset[256];
+    int blueOffset[256];
+    int redFrac[256];
+    int greenFrac[256];
+    int blueFrac[256];
+    int redStep;                // 이웃 격자점까지 거리 (grid 원소 단위)
+    int greenStep;
+    int blueStep;
+};
+
+#endif // COLORLUT_H
@@ -0,0 +1,286 @@
+#include "colormatcher.h"
+#include <QDebug>
+#include <QVector>
+#include <math.h>
+
+ColorMatcher *ColorMatcher::instance = nullptr;
+
+namespace {
+// sRGB(D65) -> XYZ 변환 행렬, 기준 백색으로 미리 나눔
+const float XN = 0.95047f;
+const float YN = 1.00000f;
+const float ZN = 1.08883f;
+const float M[3][3] = {
+    { 0.4124564f / XN, 0.3575761f / XN, 0.1804375f / XN },
+    { 0.2126729f / YN, 0.7151522f / YN, 0.0721750f / YN },
+    { 0.0193339f / ZN, 0.1191920f / ZN, 0.9503041f / ZN }
+};
+
+const double PI = 3.14159265358979323846;
+
+inline double degrees(double rad) { return rad * 180.0 / PI; }
+inline double radians(double deg) { return deg * PI / 180.0; }
+}
+
+ColorMatcher *ColorMatcher::getInstance()
+{
+    if (instance == nullptr) {
+        instance = new ColorMatcher();
+    }
+    return instance;
+}
+
+ColorMatcher::ColorMatcher() :
+    metric(DELTA_E2000)
+{
+    for (int i = 0; i < 256; i++) {
+        double c = i / 255.0;
+        linearTable[i] = (float)(c <= 0.04045 ? c / 12.92 : pow((c + 0.055) / 1.055, 2.4));
+    }
+
+    // f(t) = t^(1/3) (t > (6/29)^3), 아니면 선형 구간
+    const double epsilon = 216.0 / 24389.0;
+    const double kappa = 24389.0 / 27.0;
+    for (int i = 0; i < F_TABLE_SIZE + 2; i++) {
+        double t = (double)i / F_TABLE_SIZE;
+        fTable[i] = (float)(t > epsilon ? cbrt(t) : (kappa * t + 16.0) / 116.0);
+    }
+}
+
+inline float ColorMatcher::fLookup(float t) const
+{
+    // sRGB 범위에서 t는 0~1 (반올림 오차로 살짝 넘을 수 있어 자름)
+    if (t <= 0.0f)
+        return fTable[0];
+    float pos = t * F_TABLE_SIZE;
+    if (pos >= F_TABLE_SIZE)
+        return fTable[F_TABLE_SIZE];
+    int index = (int)pos;
+    float frac = pos - index;
+    return fTable[index] + (fTable[index + 1] - fTable[index]) * frac;
+}
+
+LabColor ColorMatcher::toLab(int r, int g, int b) const
+{
+    float lr = linearTable[r & 0xff];
+    float lg = linearTable[g & 0xff];
+    float lb = linearTable[b & 0xff];
+
+    float fx = fLookup(M[0][0] * lr + M[0][1] * lg + M[0][2] * lb);
+    float fy = fLookup(M[1][0] * lr + M[1][1] * lg + M[1][2] * lb);
+    float fz = fLookup(M[2][0] * lr + M[2][1] * lg + M[2][2] * lb);
+
+    LabColor lab;
+    lab.L = 116.0f * fy - 16.0f;
+    lab.a = 500.0f * (fx - fy);
+    lab.b = 200.0f * (fy - fz);
+    return lab;
+}
+
+float ColorMatcher::deltaE76(const LabColor &c1, const LabColor &c2)
+{
+    float dL = c1.L - c2.L;
+    float da = c1.a - c2.a;
+    float db = c1.b - c2.b;
+    return sqrtf(dL * dL + da * da + db * db);
+}
+
+float ColorMatcher::deltaE94(const LabColor &c1, const LabColor &c2)
+{
+    // 그래픽 아트 가중치 (kL = 1, K1 = 0.045, K2 = 0.015)
+    float dL = c1.L - c2.L;
+    float C1 = sqrtf(c1.a * c1.a + c1.b * c1.b);
+    float C2 = sqrtf(c2.a * c2.a + c2.b * c2.b);
+    float dC = C1 - C2;
+    float da = c1.a - c2.a;
+    float db = c1.b - c2.b;
+    float dH2 = da * da + db * db - dC * dC;
+    if (dH2 < 0.0f)
+        dH2 = 0.0f;
+
+    float sC = 1.0f + 0.045f * C1;
+    float sH = 1.0f + 0.015f * C1;
+    float tC = dC / sC;
+    return sqrtf(dL * dL + tC * tC + dH2 / (sH * sH));
+}
+
+float ColorMatcher::deltaE2000(const LabColor &c1, const LabColor &c2)
+{
+    // Sharma, Wu, Dalal (2005) 구현 (kL = kC = kH = 1)
+    double L1 = c1.L, a1 = c1.a, b1 = c1.b;
+    double L2 = c2.L, a2 = c2.a, b2 = c2.b;
+
+    double C1 = sqrt(a1 * a1 + b1 * b1);
+    double C2 = sqrt(a2 * a2 + b2 * b2);
+    double Cbar = (C1 + C2) / 2.0;
+    double Cbar7 = pow(Cbar, 7.0);
+    double G = 0.5 * (1.0 - sqrt(Cbar7 / (Cbar7 + 6103515625.0)));  // 25^7
+
+    double a1p = (1.0 + G) * a1;
+    double a2p = (1.0 + G) * a2;
+    double C1p = sqrt(a1p * a1p + b1 * b1);
+    double C2p = sqrt(a2p * a2p + b2 * b2);
+
+    double h1p = (a1p == 0.0 && b1 == 0.0) ? 0.0 : degrees(atan2(b1, a1p));
+    if (h1p < 0.0)
+        h1p += 360.0;
+    double h2p = (a2p == 0.0 && b2 == 0.0) ? 0.0 : degrees(atan2(b2, a2p));
+    if (h2p < 0.0)
+        h2p += 360.0;
+
+    double dLp = L2 - L1;
+    double dCp = C2p - C1p;
+
+    double dhp = 0.0;
+    if (C1p * C2p != 0.0) {
+        dhp = h2p - h1p;
+        if (dhp > 180.0)
+            dhp -= 360.0;
+        else if (dhp < -180.0)
+            dhp += 360.0;
+    }
+    double dHp = 2.0 * sqrt(C1p * C2p) * sin(radians(dhp / 2.0));
+
+    double Lbarp = (L1 + L2) / 2.0;
+    double Cbarp = (C1p + C2p) / 2.0;
+
+    double hbarp = h1p + h2p;
+    if (C1p * C2p != 0.0) {
+        if (fabs(h1p - h2p) <= 180.0)
+            hbarp /= 2.0;
+        else if (h1p + h2p < 360.0)
+            hbarp = (hbarp + 360.0) / 2.0;
+        else
+            hbarp = (hbarp - 360.0) / 2.0;
+    }
+
+    double T = 1.0
+            - 0.17 * cos(radians(hbarp - 30.0))
+            + 0.24 * cos(radians(2.0 * hbarp))
+            + 0.32 * cos(radians(3.0 * hbarp + 6.0))
+            - 0.20 * cos(radians(4.0 * hbarp - 63.0));
+
+    double dTheta = 30.0 * exp(-((hbarp - 275.0) / 25.0) * ((hbarp - 275.0) / 25.0));
+    double Cbarp7 = pow(Cbarp, 7.0);
+    double RC = 2.0 * sqrt(Cbarp7 / (Cbarp7 + 6103515625.0));
+    double Lm50 = (Lbarp - 50.0) * (Lbarp - 50.0);
+    double SL = 1.0 + (0.015 * Lm50) / sqrt(20.0 + Lm50);
+    double SC = 1.0 + 0.045 * Cbarp;
+    double SH = 1.0 + 0.015 * Cbarp * T;
+    double RT = -sin(radians(2.0 * dTheta)) * RC;
+
+    double tL = dLp / SL;
+    double tC = dCp / SC;
+    double tH = dHp / SH;
+    return (float)sqrt(tL * tL + tC * tC + tH * tH + RT * tC * tH);
+}
+
+float ColorMatcher::deltaE(const LabColor &c1, const LabColor &c2, Metric metric)
+{
+    switch (metric) {
+    case DELTA_E76:
+        return deltaE76(c1, c2);
+    case DELTA_E94:
+        return deltaE94(c1, c2);
+    case DELTA_E2000:
+    default:
+        return deltaE2000(c1, c2);
+    }
+}
+
+float ColorMatcher::deltaE(const QColor &c1, const QColor &c2) const
+{
+    return deltaE(toLab(c1), toLab(c2), metric);
+}
+
+int ColorMatcher::distance(const QColor &c1, const QColor &c2) const
+{
+    float d = deltaE(c1, c2);
+    return d >= 100.0f ? 100 : (int)(d + 0.5f);
+}
+
+int ColorMatcher::scoreAll(const LabColor &sample, const LabColor *targets, int count, float *scores) const
+{
+    int best = -1;
+    float bestScore = 0.0f;
+    Metric m = metric;
+
+    for (int i = 0; i < count; i++) {
+        scores[i] = deltaE(sample, targets[i], m);
+        if (best < 0 || scores[i] < bestScore) {
+            best = i;
+            bestScore = scores[i];
+        }
+    }
+    return best;
+}
+
+int ColorMatcher::scoreAll(const QColor &sample, const QList<QColor> &targets, float *scores) const
+{
+    // 빙고판은 9칸이므로 스택 배열로 충분 (넘으면 나눠서 처리)
+    const int CHUNK = 16;
+    LabColor labs[CHUNK];
+    LabColor sampleLab = toLab(sample);
+
+    int best = -1;
+    for (int start = 0; start < targets.size(); start += CHUNK) {
+        int n = qMin(CHUNK, targets.size() - start);
+        for (int i = 0; i < n; i++) {
+            labs[i] = toLab(targets.at(start + i));
+        }
+        int chunkBest = scoreAll(sampleLab, labs, n, scores + start);
+        if (best < 0 || scores[start + chunkBest] < scores[best]) {
+            best = start + chunkBest;
+        }
+    }
+    return best;
+}
+
+bool ColorMatcher::matchesTarget(const QColor &sample, const QList<QColor> &targets, const bool *open,
+                                 int selected, int threshold, int *nearest) const
+{
+    if (selected < 0 || selected >= targets.size()) {
+        if (nearest)
+            *nearest = -1;
+        return false;
+    }
+
+    QVector<float> scores(targets.size());
+    scoreAll(sample, targets, scores.data());
+    return acceptsMatch(scores.data(), open, targets.size(), selected, threshold, nearest);
+}
+
+bool ColorMatcher::acceptsMatch(const float *scores, const bool *open, int count,
+                                int selected, int threshold, int *nearest)
+{
+    if (nearest)
+        *nearest = -1;
+    if (selected < 0 || selected >= count)
+        return false;
+
+    // 열린 칸 중 가장 가까운 칸 (선택한 칸은 항상 후보)
+    int best = selected;
+    for (int i = 0; i < count; i++) {
+        if (i != selected && !open[i])
+            continue;
+        if (scores[i] < scores[best])
+            best = i;
+    }
+    if (nearest)
+        *nearest = best;
+
+    // distance()와 같은 반올림 기준으로 임계값 비교
+    if (scores[selected] >= 100.0f || (int)(scores[selected] + 0.5f) > threshold)
+        return false;
+    return scores[best] >= scores[selected] - AMBIGUITY_MARGIN;
+}
+
+float ColorMatcher::minDistance(const QColor &candidate, const QList<QColor> &colors) const
+{
+    if (colors.isEmpty())
+        return 1000.0f;
+
+    QVector<float> scores(colors.size());
+    int best = scoreAll(candidate, colors, scores.data());
+    return scores[best];
+}
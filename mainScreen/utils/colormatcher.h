@@ -0,0 +1,93 @@
+#ifndef COLORMATCHER_H
+#define COLORMATCHER_H
+
+#include <QColor>
+#include <QList>
+
+// CIELAB 색 (D65 기준, L 0~100)
+struct LabColor {
+    float L;
+    float a;
+    float b;
+};
+
+// 지각적 색 거리 계산기 (CIELAB ΔE76 / ΔE94 / CIEDE2000)
+// RGB 유클리드 거리는 초록은 너무 쉽게, 파랑은 너무 어렵게 통과시키므로
+// 게임 판정과 빙고판 생성은 모두 이 모듈의 거리를 사용한다.
+//
+// sRGB -> Lab 변환은 시작 시 만든 표를 사용한다:
+//   채널별 감마 해제 표(256) + 3x3 행렬 + Lab f(t) 표(선형 보간)
+// 256^3 전체 표(수백 MB) 대신 분리 가능한 단계만 표로 만들어 변환 한 번이 수십 ns 수준이다.
+// 표는 생성 후 읽기 전용이므로 어느 스레드에서나 사용할 수 있다.
+class ColorMatcher
+{
+public:
+    enum Metric {
+        DELTA_E76,      // Lab 유클리드 거리
+        DELTA_E94,      // CIE94 (그래픽 아트 가중치)
+        DELTA_E2000     // CIEDE2000 (기본값)
+    };
+
+    // 첫 호출은 GUI 스레드(위젯 생성자)에서 이루어져 다른 스레드보다 앞선다
+    static ColorMatcher *getInstance();
+
+    LabColor toLab(int r, int g, int b) const;
+    LabColor toLab(const QColor &color) const { return toLab(color.red(), color.green(), color.blue()); }
+
+    static float deltaE76(const LabColor &c1, const LabColor &c2);
+    static float deltaE94(const LabColor &c1, const LabColor &c2);
+    static float deltaE2000(const LabColor &c1, const LabColor &c2);
+    static float deltaE(const LabColor &c1, const LabColor &c2, Metric metric);
+
+    float deltaE(const QColor &c1, const QColor &c2) const;
+
+    // 게임용 0~100 정수 거리 (현재 방식의 ΔE를 반올림, 100에서 자름)
+    int distance(const QColor &c1, const QColor &c2) const;
+
+    // 표본 하나를 여러 목표색과 한 번에 비교 (scores[i] = ΔE)
+    // 가장 가까운 목표의 인덱스를 반환 (count가 0이면 -1)
+    int scoreAll(const LabColor &sample, const LabColor *targets, int count, float *scores) const;
+    int scoreAll(const QColor &sample, const QList<QColor> &targets, float *scores) const;
+
+    // sample이 targets[selected] 칸과 맞는지 판정
+    // selected까지의 ΔE가 threshold 이내이고, 아직 열린(open[i]) 다른 칸이
+    // AMBIGUITY_MARGIN 이상 더 가깝지 않아야 한다. nearest에는 열린 칸 중 가장 가까운 칸을 돌려준다.
+    bool matchesTarget(const QColor &sample, const QList<QColor> &targets, const bool *open,
+                       int selected, int threshold, int *nearest = nullptr) const;
+    // 이미 계산한 점수(scoreAll)로 같은 판정 (버튼 캡처와 자동 매칭이 함께 사용)
+    static bool acceptsMatch(const float *scores, const bool *open, int count,
+                             int selected, int threshold, int *nearest = nullptr);
+
+    // colors 중 candidate와 가장 가까운 색까지의 ΔE (colors가 비었으면 큰 값)
+    float minDistance(const QColor &candidate, const QList<QColor> &colors) const;
+
+    void setMetric(Metric m) { metric = m; }
+    Metric getMetric() const { return metric; }
+
+    // 빙고판 칸끼리 최소한 이 정도(ΔE)는 달라야 구분하기 쉽다
+    static const int MIN_CELL_DISTANCE = 12;
+
+    // 캡처 판정 임계값 (distance 기준, CIEDE2000)
+    // 빙고판 생성과 같은 분포의 칸 색에 노출 0.75~1.15배, 채널별 ±10% 화이트 밸런스 오차,
+    // 센서 잡음(σ 5)을 준 모의 캡처 36000개로 맞춘 값: 같은 칸 통과율 99.6%로 예전 RGB 거리 20
+    // (99.7%)과 같고, 다른 칸을 잘못 통과시키는 비율은 15.5%에서 10.1%로 줄어든다.
+    static const int MATCH_THRESHOLD = 20;
+    // 같은 모의 캡처에서 열린 다른 칸이 이만큼 더 가까우면 거부: 같은 칸 통과율 98.4%,
+    // 다른 칸 오통과 2.7% (모든 칸이 열린 최악의 경우)
+    static const int AMBIGUITY_MARGIN = 5;
+
+private:
+    ColorMatcher();
+
+    static const int F_TABLE_SIZE = 4096;
+
+    inline float fLookup(float t) const;
+
+    float linearTable[256];             // sRGB 감마 해제 (0~1)
+    float fTable[F_TABLE_SIZE + 2];     // Lab f(t), t = 0~1 (+ 보간용 여유)
+    Metric metric;
+
+    static ColorMatcher *instance;
+};
+
+#endif // COLORMATCHER_H
@@ -0,0 +1,60 @@
+#include "colorstabilizer.h"
+#include <math.h>
+
+ColorStabilizer::ColorStabilizer(float alpha, float stableDeviation) :
+    alpha(alpha),
+    enterVariance(stableDeviation * stableDeviation),
+    exitVariance(2.25f * stableDeviation * stableDeviation)    // 1.5배 표준편차
+{
+    reset();
+}
+
+void ColorStabilizer::reset()
+{
+    for (int i = 0; i < 3; i++) {
+        mean[i] = 0.0f;
+        variance[i] = 0.0f;
+    }
+    frames = 0;
+    stable = false;
+}
+
+void ColorStabilizer::update(int r, int g, int b)
+{
+    float sample[3] = { (float)r, (float)g, (float)b };
+
+    // 첫 프레임은 평균을 바로 맞추고 분산은 0에서 시작 (워밍업 동안은 불안정)
+    if (frames == 0) {
+        for (int i = 0; i < 3; i++) {
+            mean[i] = sample[i];
+            variance[i] = 0.0f;
+        }
+        frames = 1;
+        stable = false;
+        return;
+    }
+
+    float total = 0.0f;
+    for (int i = 0; i < 3; i++) {
+        float diff = sample[i] - mean[i];
+        float increment = alpha * diff;
+        mean[i] += increment;
+        variance[i] = (1.0f - alpha) * (variance[i] + diff * increment);
+        total += variance[i];
+    }
+
+    if (frames < DEFAULT_WARMUP_FRAMES) {
+        frames++;
+        return;
+    }
+
+    if (stable)
+        stable = total < exitVariance;
+    else
+        stable = total <= enterVariance;
+}
+
+float ColorStabilizer::deviation() const
+{
+    return sqrtf(variance[0] + variance[1] + variance[2]);
+}
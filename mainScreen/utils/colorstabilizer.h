@@ -0,0 +1,41 @@
+#ifndef COLORSTABILIZER_H
+#define COLORSTABILIZER_H
+
+// 샘플링 원 평균 색의 시간 평활과 안정도 추정
+// 프레임마다 지수 이동 평균(EMA)과 지수 가중 분산을 증분으로 갱신한다 (프레임을 다시 읽지 않음).
+//   diff = x - mean, mean += alpha * diff, var = (1 - alpha) * (var + alpha * diff^2)
+// 흔들림/자동 노출 전환 프레임 하나가 캡처 값을 망치지 않도록 캡처에는 평활 값을 쓰고,
+// 표준편차(세 채널 합, RGB 단위)가 작으면 안정 상태로 본다.
+// 안정 판정은 들어갈 때와 나올 때 기준을 달리해 경계에서 깜박이지 않게 한다.
+//
+// 캡처 스레드 전용 (잠금 없음), 결과는 FrameStats로 게시된다.
+class ColorStabilizer
+{
+public:
+    static const int DEFAULT_WARMUP_FRAMES = 4;
+
+    explicit ColorStabilizer(float alpha = 0.3f, float stableDeviation = 4.0f);
+
+    // 원 크기 변경, 스트림 재시작, ROI 무효 프레임 후에 호출
+    void reset();
+    void update(int r, int g, int b);
+
+    bool isValid() const { return frames > 0; }
+    int red() const { return (int)(mean[0] + 0.5f); }
+    int green() const { return (int)(mean[1] + 0.5f); }
+    int blue() const { return (int)(mean[2] + 0.5f); }
+    // 세 채널 분산 합의 제곱근 (RGB 단위)
+    float deviation() const;
+    bool isStable() const { return stable; }
+
+private:
+    float alpha;
+    float enterVariance;    // 이 이하로 내려가면 안정
+    float exitVariance;     // 이 이상으로 올라가면 불안정
+    float mean[3];
+    float variance[3];
+    int frames;
+    bool stable;
+};
+
+#endif // COLORSTABILIZER_H
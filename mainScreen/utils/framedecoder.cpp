@@ -0,0 +1,225 @@
+#include "framedecoder.h"
+#include "yuvconverter.h"
+#include "colorcorrection.h"
+#include <QDebug>
+#include <string.h>
+#include <linux/videodev2.h>
+
+#ifdef HAVE_TURBOJPEG
+#include <turbojpeg.h>
+#else
+#include <QBuffer>
+#include <QImageReader>
+#endif
+
+static bool checkDestination(const FrameDecoder::Layout &layout, QImage &rgbImage)
+{
+    if (rgbImage.width() != layout.width || rgbImage.height() != layout.height
+            || rgbImage.format() != QImage::Format_RGB888) {
+        rgbImage = QImage(layout.width, layout.height, QImage::Format_RGB888);
+    }
+    return !rgbImage.isNull();
+}
+
+// 사용할 행 간격 (0이면 포맷 최소값, 한 행도 담지 못하는 값이면 0을 돌려 변환을 거부)
+static int strideFor(const FrameDecoder::Layout &layout)
+{
+    int minimum = FrameDecoder::minBytesPerLine(layout.pixelFormat, layout.width);
+    if (layout.bytesPerLine == 0)
+        return minimum;
+    return layout.bytesPerLine >= minimum ? layout.bytesPerLine : 0;
+}
+
+static bool decodeYuyv(const uchar *data, size_t size, const FrameDecoder::Layout &layout, QImage &rgbImage)
+{
+    int bytesPerLine = strideFor(layout);
+    if (!bytesPerLine || size < (size_t)bytesPerLine * layout.height || !checkDestination(layout, rgbImage))
+        return false;
+
+    YuvConverter::yuyvToRgb888(data, bytesPerLine, layout.width, layout.height, rgbImage, layout.correction);
+    return true;
+}
+
+static bool decodeNv12(const uchar *data, size_t size, const FrameDecoder::Layout &layout, QImage &rgbImage)
+{
+    int bytesPerLine = strideFor(layout);
+    size_t ySize = (size_t)bytesPerLine * layout.height;
+    if (!bytesPerLine || size < ySize + ySize / 2 || !checkDestination(layout, rgbImage))
+        return false;
+
+    YuvConverter::nv12ToRgb888(data, data + ySize, bytesPerLine, layout.width, layout.height, rgbImage, layout.correction);
+    return true;
+}
+
+static bool decodeRgb24(const uchar *data, size_t size, const FrameDecoder::Layout &layout, QImage &rgbImage)
+{
+    int bytesPerLine = strideFor(layout);
+    if (!bytesPerLine || size < (size_t)bytesPerLine * layout.height || !checkDestination(layout, rgbImage))
+        return false;
+
+    // 이미 RGB888 배치이므로 행 단위 복사만 수행 (색 보정은 복사한 행에 바로 적용)
+    bool correct = layout.correction && layout.correction->isActive();
+    for (int i = 0; i < layout.height; i++) {
+        uchar *rgb = rgbImage.scanLine(i);
+        memcpy(rgb, data + i * bytesPerLine, layout.width * 3);
+        if (correct) {
+            layout.correction->applyRow(rgb, layout.width);
+        }
+    }
+    return true;
+}
+
+#ifdef HAVE_TURBOJPEG
+// 프레임 단위로 디코딩하는 포맷(MJPEG)은 디코딩 후 한 번 더 지나가며 보정
+static void applyCorrection(const FrameDecoder::Layout &layout, QImage &rgbImage)
+{
+    if (!layout.correction || !layout.correction->isActive())
+        return;
+
+    for (int i = 0; i < rgbImage.height(); i++) {
+        layout.correction->applyRow(rgbImage.scanLine(i), rgbImage.width());
+    }
+}
+
+static bool decodeMjpeg(const uchar *data, size_t size, const FrameDecoder::Layout &layout, QImage &rgbImage)
+{
+    // 디코더 핸들 생성 비용을 피하기 위해 스레드별로 재사용 (캡처 스레드 하나뿐)
+    static thread_local tjhandle handle = tjInitDecompress();
+    if (!handle || !checkDestination(layout, rgbImage))
+        return false;
+
+    int width = 0, height = 0, subsamp = 0, colorspace = 0;
+    if (tjDecompressHeader3(handle, data, size, &width, &height, &subsamp, &colorspace) != 0) {
+        qDebug() << "MJPEG header error:" << tjGetErrorStr2(handle);
+        return false;
+    }
+
+    if (width != layout.width || height != layout.height) {
+        qDebug() << "MJPEG frame size mismatch:" << width << "x" << height;
+        return false;
+    }
+
+    // QImage 버퍼에 직접 디코딩 (중간 복사 없음)
+    if (tjDecompress2(handle, data, size, rgbImage.bits(), width, rgbImage.bytesPerLine(), height,
+                      TJPF_RGB, TJFLAG_FASTDCT | TJFLAG_FASTUPSAMPLE) != 0) {
+        qDebug() << "MJPEG decode error:" << tjGetErrorStr2(handle);
+        return false;
+    }
+    applyCorrection(layout, rgbImage);
+    return true;
+}
+#else
+static bool decodeMjpeg(const uchar *data, size_t size, const FrameDecoder::Layout &layout, QImage &rgbImage)
+{
+    // libjpeg-turbo가 없으면 Qt JPEG 플러그인으로 대체 (느리지만 동작은 동일)
+    // 플러그인은 컬러 JPEG를 RGB32로만 디코딩하므로, 디코딩 버퍼를 스레드별로 재사용하고
+    // (크기와 포맷이 같으면 QImageReader가 다시 할당하지 않음) 기존 RGB888 버퍼에 행 단위로 옮기며 보정
+    static thread_local QImage decoded;
+    QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char *>(data), (int)size);
+    QBuffer buffer(&bytes);
+    QImageReader reader(&buffer, "JPEG");
+    if (!reader.read(&decoded))
+        return false;
+
+    if (decoded.width() != layout.width || decoded.height() != layout.height) {
+        qDebug() << "MJPEG frame size mismatch:" << decoded.width() << "x" << decoded.height();
+        return false;
+    }
+    if (!checkDestination(layout, rgbImage))
+        return false;
+
+    // 흑백 JPEG 등 드문 경우만 변환
+    if (decoded.format() != QImage::Format_RGB32 && decoded.format() != QImage::Format_ARGB32) {
+        decoded = decoded.convertToFormat(QImage::Format_RGB32);
+    }
+
+    bool correct = layout.correction && layout.correction->isActive();
+    for (int i = 0; i < layout.height; i++) {
+        const QRgb *src = reinterpret_cast<const QRgb *>(decoded.constScanLine(i));
+        uchar *rgb = rgbImage.scanLine(i);
+        for (int x = 0; x < layout.width; x++) {
+            rgb[x * 3] = qRed(src[x]);
+            rgb[x * 3 + 1] = qGreen(src[x]);
+            rgb[x * 3 + 2] = qBlue(src[x]);
+        }
+        if (correct) {
+            layout.correction->applyRow(rgb, layout.width);
+        }
+    }
+    return true;
+}
+#endif
+
+const FrameDecoder::Entry *FrameDecoder::entries(int &count)
+{
+    // 변환 비용 순: RGB24(복사) < YUYV(SIMD) < NV12(스칼라) < MJPEG(엔트로피 디코딩)
+    static const Entry table[] = {
+        { V4L2_PIX_FMT_RGB24, "RGB24", 1, decodeRgb24 },
+        { V4L2_PIX_FMT_YUYV,  "YUYV",  2, decodeYuyv },
+        { V4L2_PIX_FMT_NV12,  "NV12",  3, decodeNv12 },
+#ifdef HAVE_TURBOJPEG
+        { V4L2_PIX_FMT_MJPEG, "MJPEG", 6, decodeMjpeg },
+#else
+        { V4L2_PIX_FMT_MJPEG, "MJPEG", 12, decodeMjpeg },
+#endif
+    };
+    count = sizeof(table) / sizeof(table[0]);
+    return table;
+}
+
+const FrameDecoder::Entry *FrameDecoder::find(quint32 pixelFormat)
+{
+    int count = 0;
+    const Entry *table = entries(count);
+    for (int i = 0; i < count; i++) {
+        if (table[i].pixelFormat == pixelFormat)
+            return &table[i];
+    }
+    return NULL;
+}
+
+QList<quint32> FrameDecoder::supportedFormats()
+{
+    int count = 0;
+    const Entry *table = entries(count);
+    QList<quint32> formats;
+    for (int i = 0; i < count; i++) {
+        formats.append(table[i].pixelFormat);
+    }
+    return formats;
+}
+
+bool FrameDecoder::decode(const uchar *data, size_t size, const Layout &layout, QImage &rgbImage)
+{
+    const Entry *entry = find(layout.pixelFormat);
+    if (!entry) {
+        qDebug() << "No decoder for pixel format" << fourccToString(layout.pixelFormat);
+        return false;
+    }
+    return entry->decode(data, size, layout, rgbImage);
+}
+
+int FrameDecoder::minBytesPerLine(quint32 pixelFormat, int width)
+{
+    switch (pixelFormat) {
+    case V4L2_PIX_FMT_YUYV:
+        return width * 2;
+    case V4L2_PIX_FMT_RGB24:
+        return width * 3;
+    case V4L2_PIX_FMT_NV12:
+        return width;
+    default:
+        return 0;
+    }
+}
+
+QString FrameDecoder::fourccToString(quint32 pixelFormat)
+{
+    char fourcc[5];
+    fourcc[0] = (char)(pixelFormat & 0xFF);
+    fourcc[1] = (char)((pixelFormat >> 8) & 0xFF);
+    fourcc[2] = (char)((pixelFormat >> 16) & 0xFF);
+    fourcc[3] = (char)((pixelFormat >> 24) & 0xFF);
+    fourcc[4] = '\0';
+    return QString::fromLatin1(fourcc);
+}
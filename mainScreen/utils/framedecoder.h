@@ -0,0 +1,49 @@
+#ifndef FRAMEDECODER_H
+#define FRAMEDECODER_H
+
+#include <QImage>
+#include <QList>
+
+class ColorCorrection;
+
+// V4L2 픽셀 포맷별 RGB888 디코더 레지스트리
+// 카메라는 이 레지스트리에 등록된 포맷 중에서만 협상하며, 드라이버가 실제로
+// 돌려준 포맷에 맞는 디코더로 버퍼를 변환한다.
+class FrameDecoder
+{
+public:
+    // 디코딩에 필요한 버퍼 배치 정보
+    struct Layout {
+        quint32 pixelFormat;    // V4L2_PIX_FMT_*
+        int width;
+        int height;
+        int bytesPerLine;       // 0이면 포맷 기본값 사용
+        const ColorCorrection *correction;  // 변환 직후 적용할 색 보정 (NULL이면 없음)
+    };
+
+    // data/size 버퍼를 rgbImage(Format_RGB888, width x height)에 변환
+    typedef bool (*DecodeFunc)(const uchar *data, size_t size, const Layout &layout, QImage &rgbImage);
+
+    struct Entry {
+        quint32 pixelFormat;
+        const char *name;
+        int cpuCost;            // 픽셀당 상대적 변환 비용 (낮을수록 저렴)
+        DecodeFunc decode;
+    };
+
+    // 포맷에 해당하는 디코더 (없으면 NULL)
+    static const Entry *find(quint32 pixelFormat);
+    // 지원 포맷 목록 (변환 비용이 낮은 순)
+    static QList<quint32> supportedFormats();
+    // 레지스트리에서 디코더를 찾아 변환 (미지원 포맷이면 false)
+    static bool decode(const uchar *data, size_t size, const Layout &layout, QImage &rgbImage);
+    // 한 행을 담는 데 필요한 최소 bytesPerLine (압축 포맷이면 0)
+    static int minBytesPerLine(quint32 pixelFormat, int width);
+    // 로그용 FourCC 문자열
+    static QString fourccToString(quint32 pixelFormat);
+
+private:
+    static const Entry *entries(int &count);
+};
+
+#endif // FRAMEDECODER_H
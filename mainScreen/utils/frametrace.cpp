@@ -0,0 +1,214 @@
+#include "frametrace.h"
+#include <QDebug>
+#include <QFile>
+#include <QByteArray>
+#include <QCoreApplication>
+#include <algorithm>
+#include <vector>
+#include <map>
+#include <time.h>
+
+FrameTrace *FrameTrace::instance = nullptr;
+
+// 첫 호출은 V4L2Camera 생성자(GUI 스레드)에서 이루어져 캡처 스레드보다 앞선다
+FrameTrace *FrameTrace::getInstance()
+{
+    if (instance == nullptr) {
+        instance = new FrameTrace();
+    }
+    return instance;
+}
+
+FrameTrace::FrameTrace() :
+    writeIndex(0),
+    enabled(false),
+    hudEnabled(false)
+{
+    for (int i = 0; i < RING_SIZE; i++) {
+        ring[i].ticket.store(0, std::memory_order_relaxed);
+    }
+
+    QByteArray trace = qgetenv("COLORBINGO_FRAME_TRACE");
+    hudEnabled = !qgetenv("COLORBINGO_FRAME_HUD").isEmpty();
+    enabled = hudEnabled || !trace.isEmpty();
+
+    if (trace.endsWith(".json")) {
+        dumpPath = QString::fromLocal8Bit(trace);
+        // QApplication 종료 시 덤프
+        qAddPostRoutine(dumpAtExit);
+    }
+
+    if (enabled) {
+        qDebug() << "Frame pipeline tracing enabled" << (hudEnabled ? "(HUD)" : "") << dumpPath;
+    }
+}
+
+void FrameTrace::dumpAtExit()
+{
+    if (instance && !instance->dumpPath.isEmpty()) {
+        instance->dumpChromeTrace(instance->dumpPath);
+    }
+}
+
+qint64 FrameTrace::nowUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (qint64)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+const char *FrameTrace::stageName(int stage)
+{
+    static const char *names[STAGE_COUNT] = {
+        "driver", "dequeue", "convert", "publish", "pickup", "scale", "paint", "average", "display"
+    };
+    return (stage >= 0 && stage < STAGE_COUNT) ? names[stage] : "?";
+}
+
+void FrameTrace::recordAt(quint32 stream, quint32 sequence, Stage stage, qint64 timestampUs)
+{
+    if (!enabled)
+        return;
+
+    // 여러 스레드가 동시에 기록해도 쓰기 번호로 슬롯이 나뉨
+    quint64 index = writeIndex.fetch_add(1, std::memory_order_relaxed);
+    Entry &e = ring[index & (RING_SIZE - 1)];
+
+    e.ticket.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    e.stream.store(stream, std::memory_order_relaxed);
+    e.sequence.store(sequence, std::memory_order_relaxed);
+    e.stage.store(stage, std::memory_order_relaxed);
+    e.timestampUs.store(timestampUs, std::memory_order_relaxed);
+    e.ticket.store(index + 1, std::memory_order_release);
+}
+
+int FrameTrace::snapshot(Snapshot *out, int maxCount) const
+{
+    quint64 end = writeIndex.load(std::memory_order_acquire);
+    quint64 count = qMin<quint64>(end, qMin(maxCount, (int)RING_SIZE));
+    int n = 0;
+
+    for (quint64 index = end - count; index < end; index++) {
+        const Entry &e = ring[index & (RING_SIZE - 1)];
+
+        // 기록 중이거나 이미 덮어쓴 슬롯은 건너뜀 (seqlock 방식 검증)
+        if (e.ticket.load(std::memory_order_acquire) != index + 1)
+            continue;
+        Snapshot s;
+        s.stream = e.stream.load(std::memory_order_relaxed);
+        s.sequence = e.sequence.load(std::memory_order_relaxed);
+        s.stage = e.stage.load(std::memory_order_relaxed);
+        s.timestampUs = e.timestampUs.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (e.ticket.load(std::memory_order_relaxed) != index + 1)
+            continue;
+
+        out[n++] = s;
+    }
+    return n;
+}
+
+void FrameTrace::computeStats(StageStats *stats, double &fps) const
+{
+    std::vector<Snapshot> entries(RING_SIZE);
+    int n = snapshot(entries.data(), RING_SIZE);
+
+    // 프레임(스트림 세대 + 시퀀스 번호)별로 단계 시각 모으기
+    std::map<quint64, std::vector<qint64> > frames;
+    qint64 firstPublish = 0, lastPublish = 0;
+    int publishCount = 0;
+    for (int i = 0; i < n; i++) {
+        std::vector<qint64> &t = frames[frameKey(entries[i])];
+        if (t.empty())
+            t.assign(STAGE_COUNT, 0);
+        t[entries[i].stage] = entries[i].timestampUs;
+
+        if (entries[i].stage == STAGE_PUBLISH) {
+            if (publishCount == 0)
+                firstPublish = entries[i].timestampUs;
+            lastPublish = entries[i].timestampUs;
+            publishCount++;
+        }
+    }
+
+    // 각 단계 지연 = 해당 단계 시각 - 같은 프레임에서 기록된 직전 단계 시각
+    std::vector<qint64> durations[STAGE_COUNT];
+    for (std::map<quint64, std::vector<qint64> >::const_iterator it = frames.begin(); it != frames.end(); ++it) {
+        const std::vector<qint64> &t = it->second;
+        qint64 previous = 0;
+        for (int stage = 0; stage < STAGE_COUNT; stage++) {
+            if (!t[stage])
+                continue;
+            if (previous && t[stage] >= previous)
+                durations[stage].push_back(t[stage] - previous);
+            previous = t[stage];
+        }
+    }
+
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+        std::vector<qint64> &d = durations[stage];
+        stats[stage].samples = (int)d.size();
+        if (d.empty()) {
+            stats[stage].p50Ms = stats[stage].p99Ms = 0.0;
+            continue;
+        }
+        std::sort(d.begin(), d.end());
+        stats[stage].p50Ms = d[d.size() / 2] / 1000.0;
+        stats[stage].p99Ms = d[qMin(d.size() - 1, (d.size() * 99) / 100)] / 1000.0;
+    }
+
+    fps = (publishCount > 1 && lastPublish > firstPublish)
+            ? (publishCount - 1) * 1000000.0 / (lastPublish - firstPublish) : 0.0;
+}
+
+bool FrameTrace::dumpChromeTrace(const QString &path) const
+{
+    std::vector<Snapshot> entries(RING_SIZE);
+    int n = snapshot(entries.data(), RING_SIZE);
+
+    std::map<quint64, std::vector<qint64> > frames;
+    for (int i = 0; i < n; i++) {
+        std::vector<qint64> &t = frames[frameKey(entries[i])];
+        if (t.empty())
+            t.assign(STAGE_COUNT, 0);
+        t[entries[i].stage] = entries[i].timestampUs;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << "Cannot write frame trace" << path << ":" << file.errorString();
+        return false;
+    }
+
+    // 단계마다 완료 이벤트(ph:X) 하나, 캡처 단계는 tid 1, GUI 단계는 tid 2
+    QByteArray json = "{\"traceEvents\":[\n";
+    bool first = true;
+    for (std::map<quint64, std::vector<qint64> >::const_iterator it = frames.begin(); it != frames.end(); ++it) {
+        const std::vector<qint64> &t = it->second;
+        qint64 previous = 0;
+        for (int stage = 0; stage < STAGE_COUNT; stage++) {
+            if (!t[stage])
+                continue;
+            if (previous && t[stage] >= previous) {
+                json += first ? "" : ",\n";
+                json += QString("{\"name\":\"%1\",\"ph\":\"X\",\"pid\":1,\"tid\":%2,\"ts\":%3,\"dur\":%4,"
+                                "\"args\":{\"stream\":%5,\"seq\":%6}}")
+                        .arg(stageName(stage))
+                        .arg(stage <= STAGE_PUBLISH ? 1 : 2)
+                        .arg(previous)
+                        .arg(t[stage] - previous)
+                        .arg((quint32)(it->first >> 32))
+                        .arg((quint32)it->first).toUtf8();
+                first = false;
+            }
+            previous = t[stage];
+        }
+    }
+    json += "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    bool ok = file.write(json) == json.size();
+    file.close();
+    qDebug() << "Frame trace written to" << path << (ok ? "" : "(write error)");
+    return ok;
+}
@@ -0,0 +1,93 @@
+#ifndef FRAMETRACE_H
+#define FRAMETRACE_H
+
+#include <QString>
+#include <atomic>
+
+// 카메라 프레임 파이프라인 단계별 타임스탬프 기록기
+// 캡처 스레드와 GUI 스레드가 잠금 없이 고정 크기 링 버퍼에 기록하고,
+// HUD 표시(p50/p99, fps)와 Chrome trace JSON 덤프에 사용한다.
+// 프레임은 (스트림 세대, 드라이버 시퀀스)로 구분한다. 스트림 재시작/장치 재열기/녹화 반복 재생 때
+// 시퀀스 번호가 다시 시작되므로 V4L2Camera가 그때마다 세대를 올려 FrameStats와 함께 넘긴다.
+//
+// COLORBINGO_FRAME_TRACE=1            기록 활성화
+// COLORBINGO_FRAME_TRACE=<파일.json>  기록 활성화 + 종료 시 Chrome trace 덤프
+// COLORBINGO_FRAME_HUD=1              카메라 화면에 HUD 표시 (기록도 활성화)
+class FrameTrace
+{
+public:
+    enum Stage {
+        STAGE_DRIVER = 0,   // 드라이버 타임스탬프 (센서 캡처 완료)
+        STAGE_DEQUEUE,      // VIDIOC_DQBUF 완료
+        STAGE_CONVERT,      // RGB 변환 완료
+        STAGE_PUBLISH,      // 트리플 버퍼 게시
+        STAGE_PICKUP,       // GUI 스레드가 프레임 획득
+        STAGE_SCALE,        // 화면 크기로 스케일
+        STAGE_PAINT,        // 원 오버레이 그리기 (PreviewRenderer는 스케일과 한 번에 기록)
+        STAGE_AVERAGE,      // 원 내부 평균 계산
+        STAGE_DISPLAY,      // setPixmap / 라벨 갱신 완료
+        STAGE_COUNT
+    };
+
+    struct StageStats {
+        double p50Ms;       // 이전 단계로부터의 지연 중앙값
+        double p99Ms;
+        int samples;
+    };
+
+    static FrameTrace *getInstance();
+
+    bool isEnabled() const { return enabled; }
+    bool isHudEnabled() const { return hudEnabled; }
+
+    // CLOCK_MONOTONIC (V4L2 드라이버 타임스탬프와 같은 기준)
+    static qint64 nowUs();
+    static const char *stageName(int stage);
+
+    // 잠금 없이 기록 (비활성이면 즉시 반환)
+    inline void record(quint32 stream, quint32 sequence, Stage stage)
+    {
+        if (enabled)
+            recordAt(stream, sequence, stage, nowUs());
+    }
+    void recordAt(quint32 stream, quint32 sequence, Stage stage, qint64 timestampUs);
+
+    // 최근 링 내용으로 단계별 통계와 게시 fps 계산 (stats는 STAGE_COUNT개)
+    void computeStats(StageStats *stats, double &fps) const;
+
+    // Chrome trace(about:tracing / Perfetto) JSON으로 저장
+    bool dumpChromeTrace(const QString &path) const;
+
+private:
+    FrameTrace();
+
+    static const int RING_SIZE = 8192;  // 2의 거듭제곱
+    struct Entry {
+        std::atomic<quint64> ticket;    // 기록 완료된 쓰기 번호 + 1 (0이면 비어 있음)
+        std::atomic<quint32> stream;
+        std::atomic<quint32> sequence;
+        std::atomic<int> stage;
+        std::atomic<qint64> timestampUs;
+    };
+
+    struct Snapshot {
+        quint32 stream;
+        quint32 sequence;
+        int stage;
+        qint64 timestampUs;
+    };
+
+    int snapshot(Snapshot *out, int maxCount) const;
+    static quint64 frameKey(const Snapshot &s) { return ((quint64)s.stream << 32) | s.sequence; }
+    static void dumpAtExit();
+
+    Entry ring[RING_SIZE];
+    std::atomic<quint64> writeIndex;
+    bool enabled;
+    bool hudEnabled;
+    QString dumpPath;
+
+    static FrameTrace *instance;
+};
+
+#endif // FRAMETRACE_H
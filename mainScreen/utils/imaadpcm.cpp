@@ -0,0 +1,132 @@
+#include "imaadpcm.h"
+
+namespace {
+const int STEP_TABLE[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+    19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+    130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+const int INDEX_TABLE[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+struct ChannelState {
+    int predictor;
+    int index;
+};
+
+inline qint16 decodeNibble(ChannelState &state, int nibble)
+{
+    int step = STEP_TABLE[state.index];
+    int diff = step >> 3;
+    if (nibble & 4) diff += step;
+    if (nibble & 2) diff += step >> 1;
+    if (nibble & 1) diff += step >> 2;
+    if (nibble & 8)
+        state.predictor -= diff;
+    else
+        state.predictor += diff;
+
+    state.predictor = qBound(-32768, state.predictor, 32767);
+    state.index = qBound(0, state.index + INDEX_TABLE[nibble], 88);
+    return (qint16)state.predictor;
+}
+}
+
+int ImaAdpcm::framesPerBlock(int blockBytes, int channels)
+{
+    int headerBytes = 4 * channels;
+    if (channels <= 0 || blockBytes < headerBytes)
+        return 0;
+    // 데이터는 채널마다 4바이트(8샘플) 단위로 번갈아 저장됨
+    return ((blockBytes - headerBytes) / headerBytes) * 8 + 1;
+}
+
+bool ImaAdpcm::describe(const uchar *data, int dataSize, int blockAlign, int channels,
+                        int factFrames, Layout &layout)
+{
+    if (!data || channels < 1 || channels > MAX_CHANNELS || blockAlign < 4 * channels
+            || (blockAlign - 4 * channels) % (4 * channels) != 0 || dataSize < 4 * channels)
+        return false;
+
+    layout.blocks = data;
+    layout.blockAlign = blockAlign;
+    layout.dataSize = dataSize;
+    layout.channels = channels;
+    layout.framesPerBlock = framesPerBlock(blockAlign, channels);
+    layout.blockCount = (dataSize + blockAlign - 1) / blockAlign;
+
+    int lastBytes = dataSize - (layout.blockCount - 1) * blockAlign;
+    int lastFrames = framesPerBlock(lastBytes, channels);
+    if (lastFrames == 0) {
+        // 헤더도 안 되는 꼬리는 버림
+        layout.blockCount--;
+        lastFrames = layout.framesPerBlock;
+    }
+    layout.frames = (layout.blockCount - 1) * layout.framesPerBlock + lastFrames;
+    if (factFrames > 0 && factFrames < layout.frames)
+        layout.frames = factFrames;
+
+    return layout.isValid();
+}
+
+int ImaAdpcm::decodeBlock(const Layout &layout, int index, qint16 *out, int outputChannels)
+{
+    if (index < 0 || index >= layout.blockCount)
+        return 0;
+
+    int channels = layout.channels;
+    const uchar *block = layout.blocks + index * layout.blockAlign;
+    int blockBytes = qMin(layout.blockAlign, layout.dataSize - index * layout.blockAlign);
+    int frames = framesPerBlock(blockBytes, channels);
+    // 마지막 블록의 패딩 (fact 청크 기준)
+    frames = qMin(frames, layout.frames - index * layout.framesPerBlock);
+    if (frames <= 0)
+        return 0;
+
+    ChannelState state[MAX_CHANNELS];
+    for (int c = 0; c < channels; c++) {
+        const uchar *header = block + c * 4;
+        state[c].predictor = (qint16)(header[0] | (header[1] << 8));
+        state[c].index = qBound(0, (int)header[2], 88);
+    }
+
+    // 출력 채널 c는 원본 min(c, channels - 1)에서 가져옴
+    for (int c = 0; c < outputChannels; c++) {
+        out[c] = (qint16)state[qMin(c, channels - 1)].predictor;
+    }
+
+    // 채널마다 4바이트(8샘플)씩 번갈아 저장, 각 바이트는 하위 니블이 먼저
+    const uchar *data = block + 4 * channels;
+    qint16 decoded[MAX_CHANNELS][8];
+    int frame = 1;
+    while (frame < frames) {
+        for (int c = 0; c < channels; c++) {
+            for (int i = 0; i < 4; i++) {
+                uchar byte = data[i];
+                decoded[c][i * 2] = decodeNibble(state[c], byte & 0x0f);
+                decoded[c][i * 2 + 1] = decodeNibble(state[c], byte >> 4);
+            }
+            data += 4;
+        }
+
+        int count = qMin(8, frames - frame);
+        qint16 *dst = out + frame * outputChannels;
+        for (int i = 0; i < count; i++) {
+            for (int c = 0; c < outputChannels; c++) {
+                *dst++ = decoded[qMin(c, channels - 1)][i];
+            }
+        }
+        frame += count;
+    }
+
+    return frames;
+}
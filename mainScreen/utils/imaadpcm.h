@@ -0,0 +1,46 @@
+#ifndef IMAADPCM_H
+#define IMAADPCM_H
+
+#include <QtGlobal>
+
+// WAV IMA-ADPCM (WAVE_FORMAT_IMA_ADPCM, 0x11) 블록 디코더
+// 샘플당 4비트로 16비트 PCM의 1/4 크기이며, 블록마다 채널별 예측값/스텝 인덱스 헤더가 있어
+// 블록 단위로 독립적으로(임의 위치에서) 디코드할 수 있다.
+// 오디오 스레드에서 한 블록씩 디코드하는 스트리밍 재생용 (할당 없음)
+class ImaAdpcm
+{
+public:
+    static const int FORMAT_TAG = 0x0011;
+    static const int MAX_CHANNELS = 2;
+    // 스트리밍 재생 시 음성마다 잡아 두는 블록 버퍼 크기 (이보다 큰 블록은 전체 디코드)
+    static const int MAX_BLOCK_FRAMES = 4096;
+
+    // 메모리에 있는 블록 배열
+    struct Layout {
+        const uchar *blocks;
+        int blockAlign;         // 블록 하나의 바이트 수 (마지막 블록은 더 짧을 수 있음)
+        int blockCount;
+        int dataSize;           // 전체 블록 데이터 바이트 수
+        int channels;           // 원본 채널 수
+        int framesPerBlock;
+        int frames;             // 전체 프레임 수
+
+        Layout() : blocks(NULL), blockAlign(0), blockCount(0), dataSize(0),
+                   channels(0), framesPerBlock(0), frames(0) {}
+        bool isValid() const { return blocks != NULL && blockCount > 0 && frames > 0; }
+    };
+
+    // 블록 바이트 수로부터 블록당 프레임 수 (헤더 샘플 1 + 4비트 샘플들)
+    static int framesPerBlock(int blockBytes, int channels);
+
+    // fmt 청크 정보로 Layout 구성 (지원하지 않는 형식이면 false)
+    // factFrames가 0보다 크면 fact 청크의 전체 프레임 수로 마지막 블록의 패딩을 잘라냄
+    static bool describe(const uchar *data, int dataSize, int blockAlign, int channels,
+                         int factFrames, Layout &layout);
+
+    // index번째 블록을 outputChannels 채널 S16 인터리브로 디코드 (모노는 복제, 반환: 프레임 수)
+    // out은 framesPerBlock * outputChannels 개 이상
+    static int decodeBlock(const Layout &layout, int index, qint16 *out, int outputChannels);
+};
+
+#endif // IMAADPCM_H
@@ -0,0 +1,403 @@
+#include "paletteextractor.h"
+#include "colormatcher.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PALETTE_HAVE_SSE2 1
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PALETTE_HAVE_NEON 1
+#if !defined(__aarch64__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+
+namespace {
+// 카메라가 구분하기 어려운 양 끝 밝기 (그림자 잡음, 하이라이트 포화)는 후보에서 제외
+const float MIN_LIGHTNESS = 10.0f;
+const float MAX_LIGHTNESS = 97.0f;
+
+// 중심 이동이 이보다 작으면 수렴으로 봄 (ΔE76)
+const float CONVERGED_SHIFT = 0.5f;
+
+// 화면의 이 비율(1/n) 이상을 차지하는 군집만 고름 (원 안에 담을 수 있는 크기)
+const int MIN_POPULATION_DIVISOR = 100;
+
+// 처음에는 크게 떨어진 색만 고르고, 부족하면 기준을 낮춰 다시 고름
+const float SEPARATION_STEPS[] = { 25.0f, 18.0f, (float)ColorMatcher::MIN_CELL_DISTANCE };
+}
+
+PaletteExtractor::PaletteExtractor() :
+    pointCount(0),
+    centerCount(0)
+{
+}
+
+void PaletteExtractor::assignScalar(const float *L, const float *A, const float *B, int count,
+                                    const float *centerL, const float *centerA, const float *centerB,
+                                    int centers, int *labels, float *distances)
+{
+    for (int i = 0; i < count; i++) {
+        float best = FLT_MAX;
+        int bestIndex = 0;
+        for (int c = 0; c < centers; c++) {
+            float dl = L[i] - centerL[c];
+            float da = A[i] - centerA[c];
+            float db = B[i] - centerB[c];
+            float d = dl * dl + da * da + db * db;
+            if (d < best) {
+                best = d;
+                bestIndex = c;
+            }
+        }
+        labels[i] = bestIndex;
+        distances[i] = best;
+    }
+}
+
+#ifdef PALETTE_HAVE_SSE2
+// SSE2: 4점을 동시에 모든 중심과 비교 (인덱스는 float로 들고 있다가 마지막에 변환)
+static void assignSse2(const float *L, const float *A, const float *B, int count,
+                       const float *centerL, const float *centerA, const float *centerB,
+                       int centers, int *labels, float *distances)
+{
+    for (int i = 0; i < count; i += 4) {
+        __m128 l = _mm_loadu_ps(L + i);
+        __m128 a = _mm_loadu_ps(A + i);
+        __m128 b = _mm_loadu_ps(B + i);
+        __m128 best = _mm_set1_ps(FLT_MAX);
+        __m128 bestIndex = _mm_setzero_ps();
+
+        for (int c = 0; c < centers; c++) {
+            __m128 dl = _mm_sub_ps(l, _mm_set1_ps(centerL[c]));
+            __m128 da = _mm_sub_ps(a, _mm_set1_ps(centerA[c]));
+            __m128 db = _mm_sub_ps(b, _mm_set1_ps(centerB[c]));
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dl, dl), _mm_mul_ps(da, da)), _mm_mul_ps(db, db));
+
+            __m128 closer = _mm_cmplt_ps(d, best);
+            best = _mm_min_ps(d, best);
+            bestIndex = _mm_or_ps(_mm_and_ps(closer, _mm_set1_ps((float)c)),
+                                  _mm_andnot_ps(closer, bestIndex));
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(labels + i), _mm_cvttps_epi32(bestIndex));
+        _mm_storeu_ps(distances + i, best);
+    }
+}
+#endif // PALETTE_HAVE_SSE2
+
+#ifdef PALETTE_HAVE_NEON
+// NEON: SSE2 경로와 같은 방식 (vbsl로 더 가까운 중심 인덱스 선택)
+static void assignNeon(const float *L, const float *A, const float *B, int count,
+                       const float *centerL, const float *centerA, const float *centerB,
+                       int centers, int *labels, float *distances)
+{
+    for (int i = 0; i < count; i += 4) {
+        float32x4_t l = vld1q_f32(L + i);
+        float32x4_t a = vld1q_f32(A + i);
+        float32x4_t b = vld1q_f32(B + i);
+        float32x4_t best = vdupq_n_f32(FLT_MAX);
+        float32x4_t bestIndex = vdupq_n_f32(0.0f);
+
+        for (int c = 0; c < centers; c++) {
+            float32x4_t dl = vsubq_f32(l, vdupq_n_f32(centerL[c]));
+            float32x4_t da = vsubq_f32(a, vdupq_n_f32(centerA[c]));
+            float32x4_t db = vsubq_f32(b, vdupq_n_f32(centerB[c]));
+            float32x4_t d = vmulq_f32(dl, dl);
+            d = vmlaq_f32(d, da, da);
+            d = vmlaq_f32(d, db, db);
+
+            uint32x4_t closer = vcltq_f32(d, best);
+            best = vminq_f32(d, best);
+            bestIndex = vbslq_f32(closer, vdupq_n_f32((float)c), bestIndex);
+        }
+
+        vst1q_s32(labels + i, vcvtq_s32_f32(bestIndex));
+        vst1q_f32(distances + i, best);
+    }
+}
+#endif // PALETTE_HAVE_NEON
+
+PaletteExtractor::Kernel PaletteExtractor::selectKernel()
+{
+    Kernel k = { &PaletteExtractor::assignScalar, "scalar" };
+
+#ifdef PALETTE_HAVE_SSE2
+    k.assign = &assignSse2;
+    k.name = "sse2";
+#endif
+
+#ifdef PALETTE_HAVE_NEON
+#if defined(__aarch64__)
+    k.assign = &assignNeon;
+    k.name = "neon";
+#else
+    if (getauxval(AT_HWCAP) & HWCAP_NEON) {
+        k.assign = &assignNeon;
+        k.name = "neon";
+    }
+#endif
+#endif
+
+    qDebug() << "PaletteExtractor: using" << k.name << "kernel";
+    return k;
+}
+
+const PaletteExtractor::Kernel &PaletteExtractor::kernel()
+{
+    static const Kernel k = selectKernel();
+    return k;
+}
+
+const char *PaletteExtractor::kernelName()
+{
+    return kernel().name;
+}
+
+void PaletteExtractor::sampleGrid(const QImage &frame)
+{
+    QImage converted;
+    const QImage *src = &frame;
+    if (frame.format() != QImage::Format_RGB888) {
+        // 카메라 프레임은 항상 RGB888이므로 예외 경로에서만 변환
+        converted = frame.convertToFormat(QImage::Format_RGB888);
+        src = &converted;
+    }
+
+    int width = src->width();
+    int height = src->height();
+    ColorMatcher *matcher = ColorMatcher::getInstance();
+
+    const int capacity = GRID_WIDTH * GRID_HEIGHT;
+    pointL.resize(capacity);
+    pointA.resize(capacity);
+    pointB.resize(capacity);
+    pointRgb.resize(capacity);
+    pointCount = 0;
+
+    for (int gy = 0; gy < GRID_HEIGHT; gy++) {
+        // 격자 칸 중앙의 2x2 픽셀 평균 (센서 잡음 완화)
+        int y0 = qMin(height - 1, ((gy * 2 + 1) * height) / (GRID_HEIGHT * 2));
+        int y1 = qMin(height - 1, y0 + 1);
+        const uchar *row0 = src->constScanLine(y0);
+        const uchar *row1 = src->constScanLine(y1);
+
+        for (int gx = 0; gx < GRID_WIDTH; gx++) {
+            int x0 = qMin(width - 1, ((gx * 2 + 1) * width) / (GRID_WIDTH * 2));
+            int x1 = qMin(width - 1, x0 + 1);
+            const uchar *p00 = row0 + x0 * 3;
+            const uchar *p01 = row0 + x1 * 3;
+            const uchar *p10 = row1 + x0 * 3;
+            const uchar *p11 = row1 + x1 * 3;
+            int r = (p00[0] + p01[0] + p10[0] + p11[0] + 2) >> 2;
+            int g = (p00[1] + p01[1] + p10[1] + p11[1] + 2) >> 2;
+            int b = (p00[2] + p01[2] + p10[2] + p11[2] + 2) >> 2;
+
+            LabColor lab = matcher->toLab(r, g, b);
+            if (lab.L < MIN_LIGHTNESS || lab.L > MAX_LIGHTNESS)
+                continue;
+
+            pointL[pointCount] = lab.L;
+            pointA[pointCount] = lab.a;
+            pointB[pointCount] = lab.b;
+            pointRgb[pointCount] = qRgb(r, g, b);
+            pointCount++;
+        }
+    }
+
+    // SIMD 커널이 4점 단위로 읽으므로 마지막 점을 복사해 채움 (갱신에는 포함하지 않음)
+    int padded = (pointCount + 3) & ~3;
+    pointL.resize(padded);
+    pointA.resize(padded);
+    pointB.resize(padded);
+    for (int i = pointCount; i < padded; i++) {
+        pointL[i] = pointL[pointCount - 1];
+        pointA[i] = pointA[pointCount - 1];
+        pointB[i] = pointB[pointCount - 1];
+    }
+    labels.resize(padded);
+    distances.resize(padded);
+}
+
+void PaletteExtractor::seedCenters()
+{
+    // k-means++: 이미 고른 중심에서 먼 점일수록 높은 확률로 다음 중심이 됨
+    QRandomGenerator *random = QRandomGenerator::global();
+    int first = random->bounded(pointCount);
+    centerL[0] = pointL[first];
+    centerA[0] = pointA[first];
+    centerB[0] = pointB[first];
+    centerCount = 1;
+
+    float *nearest = distances.data();
+    for (int i = 0; i < pointCount; i++) {
+        float dl = pointL[i] - centerL[0];
+        float da = pointA[i] - centerA[0];
+        float db = pointB[i] - centerB[0];
+        nearest[i] = dl * dl + da * da + db * db;
+    }
+
+    while (centerCount < CLUSTER_COUNT) {
+        double total = 0.0;
+        for (int i = 0; i < pointCount; i++) {
+            total += nearest[i];
+        }
+        // 남은 점이 모두 기존 중심과 같은 색이면 더 나눌 것이 없음
+        if (total <= 0.0)
+            break;
+
+        double target = random->generateDouble() * total;
+        int pick = pointCount - 1;
+        for (int i = 0; i < pointCount; i++) {
+            target -= nearest[i];
+            if (target < 0.0) {
+                pick = i;
+                break;
+            }
+        }
+
+        int c = centerCount++;
+        centerL[c] = pointL[pick];
+        centerA[c] = pointA[pick];
+        centerB[c] = pointB[pick];
+        for (int i = 0; i < pointCount; i++) {
+            float dl = pointL[i] - centerL[c];
+            float da = pointA[i] - centerA[c];
+            float db = pointB[i] - centerB[c];
+            nearest[i] = qMin(nearest[i], dl * dl + da * da + db * db);
+        }
+    }
+}
+
+void PaletteExtractor::assignPoints()
+{
+    kernel().assign(pointL.constData(), pointA.constData(), pointB.constData(), labels.size(),
+                    centerL, centerA, centerB, centerCount, labels.data(), distances.data());
+}
+
+float PaletteExtractor::updateCenters()
+{
+    double sumL[CLUSTER_COUNT] = { 0.0 };
+    double sumA[CLUSTER_COUNT] = { 0.0 };
+    double sumB[CLUSTER_COUNT] = { 0.0 };
+    for (int c = 0; c < centerCount; c++) {
+        clusters[c].population = 0;
+        clusters[c].rgbSum[0] = clusters[c].rgbSum[1] = clusters[c].rgbSum[2] = 0;
+    }
+
+    for (int i = 0; i < pointCount; i++) {
+        int c = labels[i];
+        sumL[c] += pointL[i];
+        sumA[c] += pointA[i];
+        sumB[c] += pointB[i];
+        Cluster &cluster = clusters[c];
+        cluster.population++;
+        cluster.rgbSum[0] += qRed(pointRgb[i]);
+        cluster.rgbSum[1] += qGreen(pointRgb[i]);
+        cluster.rgbSum[2] += qBlue(pointRgb[i]);
+    }
+
+    float maxShift = 0.0f;
+    for (int c = 0; c < centerCount; c++) {
+        float newL, newA, newB;
+        if (clusters[c].population > 0) {
+            int n = clusters[c].population;
+            newL = (float)(sumL[c] / n);
+            newA = (float)(sumA[c] / n);
+            newB = (float)(sumB[c] / n);
+        } else {
+            // 빈 군집은 현재 가장 멀리 떨어진 점으로 옮김
+            int farthest = (int)(std::max_element(distances.constData(), distances.constData() + pointCount)
+                                 - distances.constData());
+            newL = pointL[farthest];
+            newA = pointA[farthest];
+            newB = pointB[farthest];
+            distances[farthest] = 0.0f;
+        }
+
+        float dl = newL - centerL[c];
+        float da = newA - centerA[c];
+        float db = newB - centerB[c];
+        maxShift = qMax(maxShift, sqrtf(dl * dl + da * da + db * db));
+        centerL[c] = newL;
+        centerA[c] = newA;
+        centerB[c] = newB;
+    }
+    return maxShift;
+}
+
+QList<QColor> PaletteExtractor::selectColors(int count) const
+{
+    QList<QColor> colors;
+    ColorMatcher *matcher = ColorMatcher::getInstance();
+
+    int order[CLUSTER_COUNT];
+    for (int c = 0; c < centerCount; c++) {
+        order[c] = c;
+    }
+    std::sort(order, order + centerCount, [this](int x, int y) {
+        return clusters[x].population > clusters[y].population;
+    });
+
+    int minPopulation = qMax(4, pointCount / MIN_POPULATION_DIVISOR);
+    bool picked[CLUSTER_COUNT] = { false };
+
+    for (float separation : SEPARATION_STEPS) {
+        for (int i = 0; i < centerCount && colors.size() < count; i++) {
+            int c = order[i];
+            const Cluster &cluster = clusters[c];
+            if (picked[c] || cluster.population < minPopulation)
+                continue;
+
+            // 군집 대표색은 실제 픽셀 RGB의 평균 (Lab 중심을 역변환하지 않음)
+            QColor color(cluster.rgbSum[0] / cluster.population,
+                         cluster.rgbSum[1] / cluster.population,
+                         cluster.rgbSum[2] / cluster.population);
+            if (matcher->minDistance(color, colors) < separation)
+                continue;
+
+            colors.append(color);
+            picked[c] = true;
+        }
+    }
+    return colors;
+}
+
+QList<QColor> PaletteExtractor::extract(const QImage &frame, int count)
+{
+    if (frame.isNull() || count <= 0)
+        return QList<QColor>();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    sampleGrid(frame);
+    if (pointCount == 0) {
+        qDebug() << "PaletteExtractor: no usable pixels (frame too dark or too bright)";
+        return QList<QColor>();
+    }
+
+    seedCenters();
+    int iterations = 0;
+    while (iterations < MAX_ITERATIONS) {
+        iterations++;
+        assignPoints();
+        if (updateCenters() < CONVERGED_SHIFT)
+            break;
+    }
+
+    QList<QColor> colors = selectColors(count);
+    qDebug() << "PaletteExtractor:" << colors.size() << "colors from" << pointCount << "points,"
+             << centerCount << "clusters," << iterations << "iterations in"
+             << timer.nsecsElapsed() / 1000 << "us (" << kernelName() << ")";
+    return colors;
+}
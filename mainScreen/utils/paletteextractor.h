@@ -0,0 +1,76 @@
+#ifndef PALETTEEXTRACTOR_H
+#define PALETTEEXTRACTOR_H
+
+#include <QImage>
+#include <QColor>
+#include <QList>
+#include <QVector>
+
+// 카메라 프레임에서 빙고판용 대표 색을 고르는 팔레트 추출기
+// 고정 위치 9곳의 평균 대신 축소 격자 전체를 Lab 공간에서 k-means로 양자화하고,
+// 화면에서 차지하는 비율이 큰(플레이어가 실제로 찾을 수 있는) 군집부터
+// 이미 고른 색과 충분히 다른(CIEDE2000) 것만 골라 반환한다.
+//
+// 점 배정(가장 가까운 중심 찾기)이 대부분의 시간을 차지하므로 4점씩 SIMD로 처리한다
+// (SSE2 / NEON, 그 외는 스칼라). 80x60 격자, 16군집, 최대 10회 반복으로 수 ms 이내다.
+class PaletteExtractor
+{
+public:
+    static const int GRID_WIDTH = 80;
+    static const int GRID_HEIGHT = 60;
+    static const int CLUSTER_COUNT = 16;
+    static const int MAX_ITERATIONS = 10;
+
+    // 4점 단위 배정 커널: 각 점의 가장 가까운 중심 인덱스와 거리^2 (ΔE76^2)
+    // count는 4의 배수, 동률이면 작은 인덱스
+    typedef void (*AssignKernel)(const float *L, const float *A, const float *B, int count,
+                                 const float *centerL, const float *centerA, const float *centerB,
+                                 int centers, int *labels, float *distances);
+
+    PaletteExtractor();
+
+    // 서로 구분되는 색을 최대 count개 반환 (비율이 큰 군집부터, 부족하면 그만큼만)
+    QList<QColor> extract(const QImage &frame, int count);
+
+    static const char *kernelName();
+
+private:
+    struct Kernel {
+        AssignKernel assign;
+        const char *name;
+    };
+
+    struct Cluster {
+        int population;
+        qint64 rgbSum[3];
+    };
+
+    void sampleGrid(const QImage &frame);
+    void seedCenters();
+    void assignPoints();
+    float updateCenters();
+    QList<QColor> selectColors(int count) const;
+
+    static void assignScalar(const float *L, const float *A, const float *B, int count,
+                             const float *centerL, const float *centerA, const float *centerB,
+                             int centers, int *labels, float *distances);
+    static const Kernel &kernel();
+    static Kernel selectKernel();
+
+    // 격자 점 (SoA, 4의 배수로 채움 - 남는 자리는 마지막 점 복사)
+    QVector<float> pointL;
+    QVector<float> pointA;
+    QVector<float> pointB;
+    QVector<QRgb> pointRgb;
+    QVector<int> labels;
+    QVector<float> distances;
+    int pointCount;
+
+    float centerL[CLUSTER_COUNT];
+    float centerA[CLUSTER_COUNT];
+    float centerB[CLUSTER_COUNT];
+    Cluster clusters[CLUSTER_COUNT];
+    int centerCount;
+};
+
+#endif // PALETTEEXTRACTOR_H
@@ -0,0 +1,240 @@
+#include "previewrenderer.h"
+#include <QDebug>
+#include <math.h>
+
+PreviewRenderer::PreviewRenderer(Filter filter) :
+    filter(filter),
+    tableSrcWidth(0),
+    tableSrcHeight(0),
+    tableFilter(filter),
+    maskRadiusPercent(-1)
+{
+}
+
+void PreviewRenderer::setFilter(Filter newFilter)
+{
+    filter = newFilter;
+}
+
+void PreviewRenderer::clear()
+{
+    output = QImage();
+    converted = QImage();
+    tableSrcWidth = tableSrcHeight = 0;
+    maskRadiusPercent = -1;
+    maskSize = QSize();
+    ringPixels.clear();
+    ringRowStart.clear();
+}
+
+void PreviewRenderer::rebuildScaleTables(int srcWidth, int srcHeight)
+{
+    int dstWidth = output.width();
+    int dstHeight = output.height();
+
+    xOffset0.resize(dstWidth);
+    xOffset1.resize(dstWidth);
+    xWeight.resize(dstWidth);
+    yRow0.resize(dstHeight);
+    yRow1.resize(dstHeight);
+    yWeight.resize(dstHeight);
+
+    if (filter == NEAREST) {
+        // QPixmap::scaled(FastTransformation)과 같은 픽셀 중심 기준 최근접 샘플링
+        for (int x = 0; x < dstWidth; x++) {
+            int sx = qMin(srcWidth - 1, (int)(((qint64)x * 2 + 1) * srcWidth / (dstWidth * 2)));
+            xOffset0[x] = xOffset1[x] = sx * 3;
+            xWeight[x] = 0;
+        }
+        for (int y = 0; y < dstHeight; y++) {
+            int sy = qMin(srcHeight - 1, (int)(((qint64)y * 2 + 1) * srcHeight / (dstHeight * 2)));
+            yRow0[y] = yRow1[y] = sy;
+            yWeight[y] = 0;
+        }
+    } else {
+        // 쌍선형: 입력 좌표를 8비트 소수(1/256)로 계산, 가장자리는 마지막 픽셀로 고정
+        for (int x = 0; x < dstWidth; x++) {
+            int fx = (int)((((qint64)x * 2 + 1) * srcWidth * 256) / (dstWidth * 2)) - 128;
+            fx = qMax(0, fx);
+            int sx = fx >> 8;
+            int weight = fx & 0xff;
+            if (sx >= srcWidth - 1) {
+                sx = srcWidth - 1;
+                weight = 0;
+            }
+            xOffset0[x] = sx * 3;
+            xOffset1[x] = qMin(sx + 1, srcWidth - 1) * 3;
+            xWeight[x] = weight;
+        }
+        for (int y = 0; y < dstHeight; y++) {
+            int fy = (int)((((qint64)y * 2 + 1) * srcHeight * 256) / (dstHeight * 2)) - 128;
+            fy = qMax(0, fy);
+            int sy = fy >> 8;
+            int weight = fy & 0xff;
+            if (sy >= srcHeight - 1) {
+                sy = srcHeight - 1;
+                weight = 0;
+            }
+            yRow0[y] = sy;
+            yRow1[y] = qMin(sy + 1, srcHeight - 1);
+            yWeight[y] = weight;
+        }
+    }
+
+    tableSrcWidth = srcWidth;
+    tableSrcHeight = srcHeight;
+    tableFilter = filter;
+}
+
+void PreviewRenderer::rebuildRingMask(int radiusPercent)
+{
+    int w = output.width();
+    int h = output.height();
+
+    ringPixels.clear();
+    ringRowStart.fill(0, h + 1);
+    maskRadiusPercent = radiusPercent;
+    maskSize = output.size();
+
+    if (radiusPercent <= 0)
+        return;
+
+    // 기존 QPainter::drawEllipse(QPoint(w/2, h/2), r, r) + 5px 펜과 같은 위치
+    // 픽셀 중심에서 원까지 거리로 커버리지를 근사 (두께/2 + 0.5px 안쪽은 불투명)
+    int centerX = w / 2;
+    int centerY = h / 2;
+    int radius = (w * radiusPercent) / 100;
+    double halfWidth = RING_WIDTH / 2.0;
+    int reach = radius + RING_WIDTH;
+
+    for (int y = 0; y < h; y++) {
+        ringRowStart[y] = ringPixels.size();
+
+        double dy = y + 0.5 - centerY;
+        if (dy < -reach || dy > reach)
+            continue;
+
+        int x0 = qMax(0, centerX - reach);
+        int x1 = qMin(w, centerX + reach + 1);
+        for (int x = x0; x < x1; x++) {
+            double dx = x + 0.5 - centerX;
+            double distance = fabs(sqrt(dx * dx + dy * dy) - radius);
+            double coverage = halfWidth + 0.5 - distance;
+            if (coverage <= 0.0)
+                continue;
+
+            RingPixel p;
+            p.x = x;
+            p.alpha = coverage >= 1.0 ? 256 : (int)(coverage * 256.0 + 0.5);
+            ringPixels.append(p);
+        }
+    }
+    ringRowStart[h] = ringPixels.size();
+}
+
+void PreviewRenderer::scaleRowNearest(const uchar *srcRow, QRgb *dst) const
+{
+    const int *offsets = xOffset0.constData();
+    int width = output.width();
+
+    for (int x = 0; x < width; x++) {
+        const uchar *p = srcRow + offsets[x];
+        dst[x] = 0xff000000u | (p[0] << 16) | (p[1] << 8) | p[2];
+    }
+}
+
+void PreviewRenderer::scaleRowBilinear(const uchar *row0, const uchar *row1, int fy, QRgb *dst) const
+{
+    const int *offsets0 = xOffset0.constData();
+    const int *offsets1 = xOffset1.constData();
+    const int *weights = xWeight.constData();
+    int width = output.width();
+    int iy = 256 - fy;
+
+    for (int x = 0; x < width; x++) {
+        int fx = weights[x];
+        int ix = 256 - fx;
+        const uchar *a = row0 + offsets0[x];
+        const uchar *b = row0 + offsets1[x];
+        const uchar *c = row1 + offsets0[x];
+        const uchar *d = row1 + offsets1[x];
+
+        // 가로 보간 후 세로 보간 (합계 최대 255 * 2^16, 32비트 안에 들어감)
+        uint r = ((a[0] * ix + b[0] * fx) * iy + (c[0] * ix + d[0] * fx) * fy) >> 16;
+        uint g = ((a[1] * ix + b[1] * fx) * iy + (c[1] * ix + d[1] * fx) * fy) >> 16;
+        uint bl = ((a[2] * ix + b[2] * fx) * iy + (c[2] * ix + d[2] * fx) * fy) >> 16;
+        dst[x] = 0xff000000u | (r << 16) | (g << 8) | bl;
+    }
+}
+
+const QImage &PreviewRenderer::render(const QImage &frame, const QSize &viewSize,
+                                      int radiusPercent, const QColor &ringColor)
+{
+    if (frame.isNull() || viewSize.isEmpty()) {
+        output = QImage();
+        return output;
+    }
+
+    const QImage *src = &frame;
+    if (frame.format() != QImage::Format_RGB888) {
+        // 카메라 프레임은 항상 RGB888이므로 예외 경로에서만 변환
+        converted = frame.convertToFormat(QImage::Format_RGB888);
+        src = &converted;
+    }
+
+    // 화면 크기가 바뀔 때만 출력 버퍼 재할당
+    // (QPixmap::fromImage는 데이터를 복사하므로 이 버퍼는 다른 곳과 공유되지 않음)
+    bool resized = output.size() != viewSize || output.format() != QImage::Format_RGB32;
+    if (resized) {
+        output = QImage(viewSize, QImage::Format_RGB32);
+        tableSrcWidth = tableSrcHeight = 0;
+        maskRadiusPercent = -1;
+    }
+
+    if (tableSrcWidth != src->width() || tableSrcHeight != src->height() || tableFilter != filter) {
+        rebuildScaleTables(src->width(), src->height());
+    }
+    if (radiusPercent < 0)
+        radiusPercent = 0;
+    if (maskRadiusPercent != radiusPercent || maskSize != output.size()) {
+        rebuildRingMask(radiusPercent);
+    }
+
+    // 원 색상은 프레임마다 바뀌므로 마스크에는 커버리지만 두고 합성 때 색을 곱함
+    int ringR = ringColor.red();
+    int ringG = ringColor.green();
+    int ringB = ringColor.blue();
+    const RingPixel *ring = ringPixels.constData();
+    const int *rowStart = ringRowStart.constData();
+    bool drawRing = radiusPercent > 0 && !ringPixels.isEmpty();
+
+    int height = output.height();
+    for (int y = 0; y < height; y++) {
+        QRgb *dst = reinterpret_cast<QRgb *>(output.scanLine(y));
+
+        if (filter == BILINEAR) {
+            scaleRowBilinear(src->constScanLine(yRow0[y]), src->constScanLine(yRow1[y]), yWeight[y], dst);
+        } else {
+            scaleRowNearest(src->constScanLine(yRow0[y]), dst);
+        }
+
+        // 방금 쓴 행(캐시에 남아 있음)에 원 테두리 합성
+        if (!drawRing)
+            continue;
+        for (int i = rowStart[y]; i < rowStart[y + 1]; i++) {
+            const RingPixel &p = ring[i];
+            QRgb &pixel = dst[p.x];
+            if (p.alpha == 256) {
+                pixel = 0xff000000u | (ringR << 16) | (ringG << 8) | ringB;
+                continue;
+            }
+            int inv = 256 - p.alpha;
+            int r = (qRed(pixel) * inv + ringR * p.alpha) >> 8;
+            int g = (qGreen(pixel) * inv + ringG * p.alpha) >> 8;
+            int b = (qBlue(pixel) * inv + ringB * p.alpha) >> 8;
+            pixel = 0xff000000u | (r << 16) | (g << 8) | b;
+        }
+    }
+
+    return output;
+}
@@ -0,0 +1,68 @@
+#ifndef PREVIEWRENDERER_H
+#define PREVIEWRENDERER_H
+
+#include <QImage>
+#include <QSize>
+#include <QColor>
+#include <QVector>
+
+// 카메라 프레임을 화면 크기 미리보기로 만드는 렌더러
+// 스케일(최근접/쌍선형)과 원 테두리 합성을 한 번의 행 단위 패스로 처리한다.
+// 좌표 테이블과 원 테두리 마스크는 크기/반지름이 바뀔 때만 다시 만들고,
+// 출력 이미지는 재사용하므로 매 프레임 할당이 없다 (RGB888 입력 기준).
+class PreviewRenderer
+{
+public:
+    enum Filter { NEAREST, BILINEAR };
+
+    explicit PreviewRenderer(Filter filter = NEAREST);
+
+    void setFilter(Filter filter);
+    Filter getFilter() const { return filter; }
+
+    // frame을 viewSize(RGB32)로 스케일하고, radiusPercent > 0이면 원 테두리를 합성
+    // 반지름은 화면 폭의 radiusPercent%, 중심은 화면 중앙, 선 두께는 RING_WIDTH
+    // 반환된 이미지는 다음 render() 호출 전까지 유효
+    const QImage &render(const QImage &frame, const QSize &viewSize,
+                         int radiusPercent = 0, const QColor &ringColor = QColor());
+
+    const QImage &image() const { return output; }
+    void clear();
+
+    static const int RING_WIDTH = 5;
+
+private:
+    // 원 테두리 픽셀 하나 (출력 행 내부 x 좌표와 안티앨리어싱 커버리지 0~256)
+    struct RingPixel {
+        int x;
+        int alpha;
+    };
+
+    void rebuildScaleTables(int srcWidth, int srcHeight);
+    void rebuildRingMask(int radiusPercent);
+    void scaleRowNearest(const uchar *srcRow, QRgb *dst) const;
+    void scaleRowBilinear(const uchar *row0, const uchar *row1, int fy, QRgb *dst) const;
+
+    Filter filter;
+    QImage output;
+    QImage converted;           // RGB888이 아닌 입력용 (일반적인 카메라 경로에서는 사용 안 함)
+
+    // 스케일 테이블 (출력 좌표 -> 입력 바이트 오프셋 / 행 번호, 쌍선형은 가중치 0~256)
+    int tableSrcWidth;
+    int tableSrcHeight;
+    Filter tableFilter;
+    QVector<int> xOffset0;
+    QVector<int> xOffset1;
+    QVector<int> xWeight;
+    QVector<int> yRow0;
+    QVector<int> yRow1;
+    QVector<int> yWeight;
+
+    // 원 테두리 마스크 (행별 구간, ringRowStart[y] ~ ringRowStart[y + 1])
+    int maskRadiusPercent;
+    QSize maskSize;
+    QVector<RingPixel> ringPixels;
+    QVector<int> ringRowStart;
+};
+
+#endif // PREVIEWRENDERER_H
@@ -0,0 +1,76 @@
+#include "utils/replaybenchmark.h"
+#include "utils/frametrace.h"
+#include "hardwareInterface/v4l2camera.h"
+#include "hardwareInterface/camerasource.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QDebug>
+
+// 프레임 수를 주지 않았을 때 (FrameTrace 링에 모두 들어가는 정도)
+static const int DEFAULT_BENCHMARK_FRAMES = 600;
+// 소스가 멈춰도 끝나도록 하는 상한
+static const int BENCHMARK_TIMEOUT_MS = 60000;
+
+int runReplayBenchmark(const QString &path, int frameCount)
+{
+    if (frameCount <= 0)
+        frameCount = DEFAULT_BENCHMARK_FRAMES;
+
+    // FrameTrace는 첫 getInstance()에서 환경 변수를 읽으므로 카메라 생성 전에 기록을 켬
+    if (qgetenv("COLORBINGO_FRAME_TRACE").isEmpty())
+        qputenv("COLORBINGO_FRAME_TRACE", "1");
+
+    V4L2Camera camera;
+    ReplaySource *source = new ReplaySource(path, false);
+    camera.setSource(source);
+    // 최대 속도 재생에서는 프레임 간격이 들쭉날쭉하므로 정지 감시는 끔
+    camera.setStallTimeout(0);
+
+    if (!camera.openCamera() || !camera.startCapturing()) {
+        qDebug() << "Replay benchmark: cannot start replay of" << path;
+        return 1;
+    }
+
+    FrameTrace *trace = FrameTrace::getInstance();
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    // GUI 위젯 대신 프레임을 가져가며 픽업 단계까지 기록
+    QObject::connect(&camera, &V4L2Camera::newFrameAvailable, [&]() {
+        FrameStats stats;
+        camera.getCurrentFrame(&stats);
+        trace->record(stats.stream, stats.sequence, FrameTrace::STAGE_PICKUP);
+
+        if (camera.getPipelineStats().publishedFrames >= (quint64)frameCount)
+            QCoreApplication::quit();
+    });
+    QTimer::singleShot(BENCHMARK_TIMEOUT_MS, []() {
+        qDebug() << "Replay benchmark: timed out";
+        QCoreApplication::quit();
+    });
+
+    QCoreApplication::exec();
+    qint64 wallMs = elapsed.elapsed();
+    camera.stopCapturing();
+
+    PipelineStats pipeline = camera.getPipelineStats();
+    FrameTrace::StageStats stats[FrameTrace::STAGE_COUNT];
+    double fps = 0.0;
+    trace->computeStats(stats, fps);
+
+    SourceFormat format = source->format();
+    qDebug() << "Replay benchmark:" << path << format.width << "x" << format.height;
+    qDebug() << "  frames published" << pipeline.publishedFrames << "delivered" << pipeline.deliveredFrames
+             << "coalesced" << pipeline.coalescedFrames << "in" << wallMs << "ms";
+    qDebug() << "  publish fps" << fps
+             << "wall fps" << (wallMs > 0 ? pipeline.publishedFrames * 1000.0 / wallMs : 0.0);
+
+    // 최대 속도 재생에서는 드라이버 타임스탬프가 녹화 간격이라 dequeue 단계는 의미가 없어 생략
+    for (int stage = FrameTrace::STAGE_CONVERT; stage <= FrameTrace::STAGE_PICKUP; stage++) {
+        qDebug() << "  " << FrameTrace::stageName(stage) << "p50" << stats[stage].p50Ms << "ms"
+                 << "p99" << stats[stage].p99Ms << "ms" << "(" << stats[stage].samples << "frames)";
+    }
+
+    return pipeline.publishedFrames > 0 ? 0 : 1;
+}
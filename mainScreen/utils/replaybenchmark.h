@@ -0,0 +1,13 @@
+#ifndef REPLAYBENCHMARK_H
+#define REPLAYBENCHMARK_H
+
+#include <QString>
+
+// 녹화 파일(COLORBINGO_CAMERA_RECORD로 저장)을 화면 없이 최대 속도로 재생해
+// 캡처 파이프라인의 단계별 프레임 시간(p50/p99)과 처리량을 출력한다.
+//   mainScreen --replay-benchmark <녹화 파일> [프레임 수]
+// COLORBINGO_FRAME_TRACE=<파일.json>을 함께 주면 프레임별 Chrome trace도 저장된다.
+// QCoreApplication이 만들어진 뒤 호출하며, 종료 코드를 반환한다.
+int runReplayBenchmark(const QString &path, int frameCount);
+
+#endif // REPLAYBENCHMARK_H
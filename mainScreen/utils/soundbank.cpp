@@ -0,0 +1,332 @@
+#include "soundbank.h"
+#include <QFile>
+#include <QResource>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QDebug>
+#include <cstring>
+
+namespace {
+const int DEFAULT_RATE = 44100;
+const int DEFAULT_CHANNELS = 2;
+
+const int WAVE_FORMAT_PCM = 0x0001;
+const int WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+inline quint32 readLe32(const uchar *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((quint32)p[3] << 24);
+}
+
+inline quint16 readLe16(const uchar *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+struct WavInfo {
+    int format;
+    int channels;
+    int rate;
+    int bits;
+    int blockAlign;
+    int factFrames;     // fact 청크의 전체 프레임 수 (압축 포맷, 없으면 0)
+    const uchar *data;
+    int dataSize;
+};
+
+// RIFF 청크를 따라가며 fmt/fact/data 위치를 찾음
+bool parseWav(const uchar *base, int size, WavInfo &info)
+{
+    if (size < 12 || memcmp(base, "RIFF", 4) != 0 || memcmp(base + 8, "WAVE", 4) != 0)
+        return false;
+
+    bool haveFormat = false;
+    info.factFrames = 0;
+    info.data = NULL;
+    info.dataSize = 0;
+
+    int offset = 12;
+    while (offset + 8 <= size) {
+        const uchar *chunk = base + offset;
+        quint32 chunkSize = readLe32(chunk + 4);
+        int available = size - offset - 8;
+
+        if (memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16 && (int)chunkSize <= available) {
+            info.format = readLe16(chunk + 8);
+            info.channels = readLe16(chunk + 10);
+            info.rate = (int)readLe32(chunk + 12);
+            info.blockAlign = readLe16(chunk + 20);
+            info.bits = readLe16(chunk + 22);
+            // EXTENSIBLE은 서브포맷 GUID 앞 2바이트가 실제 포맷
+            if (info.format == WAVE_FORMAT_EXTENSIBLE && chunkSize >= 40)
+                info.format = readLe16(chunk + 32);
+            haveFormat = true;
+        } else if (memcmp(chunk, "fact", 4) == 0 && chunkSize >= 4 && (int)chunkSize <= available) {
+            info.factFrames = (int)qMin(readLe32(chunk + 8), (quint32)0x7fffffff);
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            // 잘린 파일은 있는 만큼만 사용
+            info.data = chunk + 8;
+            info.dataSize = qMin((int)qMin(chunkSize, (quint32)0x7fffffff), available);
+            break;
+        }
+
+        // 청크는 2바이트 정렬
+        if (chunkSize > (quint32)available)
+            break;
+        offset += 8 + (int)chunkSize + (chunkSize & 1);
+    }
+
+    return haveFormat && info.data != NULL;
+}
+
+// 한 샘플을 16비트로 (8비트는 unsigned)
+inline int readSample(const uchar *p, int bytes)
+{
+    switch (bytes) {
+    case 1: return ((int)p[0] - 128) << 8;
+    case 2: return (qint16)readLe16(p);
+    case 3: return (qint16)readLe16(p + 1);
+    default: return (qint16)readLe16(p + 2);
+    }
+}
+}
+
+SoundBank::SoundBank() :
+    rate(DEFAULT_RATE),
+    channels(DEFAULT_CHANNELS)
+{
+}
+
+SoundBank::~SoundBank()
+{
+    for (QMap<int, Entry>::iterator it = entries.begin(); it != entries.end(); ++it) {
+        release(it.value());
+    }
+}
+
+void SoundBank::setOutputFormat(int outputRate, int outputChannels)
+{
+    QMutexLocker locker(&mutex);
+    if (outputRate <= 0 || outputChannels <= 0)
+        return;
+    if (outputRate == rate && outputChannels == channels)
+        return;
+
+    rate = outputRate;
+    channels = outputChannels;
+    for (QMap<int, Entry>::iterator it = entries.begin(); it != entries.end(); ++it) {
+        release(it.value());
+    }
+    qDebug() << "SoundBank: output format" << rate << "Hz," << channels << "channels";
+}
+
+void SoundBank::add(int id, const QString &path)
+{
+    QMutexLocker locker(&mutex);
+    Entry &entry = entries[id];
+    release(entry);
+    entry.path = path;
+}
+
+int SoundBank::preload()
+{
+    QMutexLocker locker(&mutex);
+    QElapsedTimer timer;
+    timer.start();
+
+    int loaded = 0;
+    for (QMap<int, Entry>::iterator it = entries.begin(); it != entries.end(); ++it) {
+        Entry &entry = it.value();
+        if (!entry.attempted)
+            decode(entry);
+        if (entry.data || entry.adpcm.isValid())
+            loaded++;
+    }
+
+    qDebug() << "SoundBank: preloaded" << loaded << "/" << entries.size() << "samples,"
+             << decodedBytes() / 1024 << "KB in" << timer.elapsed() << "ms";
+    return loaded;
+}
+
+SoundBank::Sample SoundBank::sample(int id)
+{
+    QMutexLocker locker(&mutex);
+    Sample result;
+    QMap<int, Entry>::iterator it = entries.find(id);
+    if (it == entries.end())
+        return result;
+
+    Entry &entry = it.value();
+    if (!entry.attempted)
+        decode(entry);
+
+    result.data = entry.data;
+    result.adpcm = entry.adpcm;
+    result.frames = entry.frames;
+    result.channels = channels;
+    return result;
+}
+
+qint64 SoundBank::memoryUsage() const
+{
+    QMutexLocker locker(&mutex);
+    return decodedBytes();
+}
+
+qint64 SoundBank::decodedBytes() const
+{
+    qint64 bytes = 0;
+    for (QMap<int, Entry>::const_iterator it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        const Entry &entry = it.value();
+        if (entry.data)
+            bytes += (qint64)entry.frames * channels * sizeof(qint16);
+        bytes += entry.file.size();
+    }
+    return bytes;
+}
+
+bool SoundBank::loadFile(Entry &entry, const uchar *&bytes, int &size)
+{
+    // 압축되지 않은 Qt 리소스는 실행 파일에 매핑된 데이터를 그대로 사용 (힙 복사 없음)
+    if (entry.path.startsWith(":")) {
+        QResource resource(entry.path);
+        if (resource.isValid() && !resource.isCompressed() && resource.data()) {
+            bytes = resource.data();
+            size = (int)resource.size();
+            return true;
+        }
+    }
+
+    QFile file(entry.path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "SoundBank: cannot open" << entry.path;
+        return false;
+    }
+    entry.file = file.readAll();
+    file.close();
+
+    bytes = reinterpret_cast<const uchar*>(entry.file.constData());
+    size = entry.file.size();
+    return true;
+}
+
+bool SoundBank::decode(Entry &entry)
+{
+    entry.attempted = true;
+    if (entry.path.isEmpty())
+        return false;
+
+    const uchar *bytes = NULL;
+    int size = 0;
+    if (!loadFile(entry, bytes, size))
+        return false;
+
+    WavInfo info;
+    if (!parseWav(bytes, size, info)) {
+        qDebug() << "SoundBank: not a WAV file:" << entry.path;
+        entry.file.clear();
+        return false;
+    }
+
+    // 1단계: 원본 레이트에서 출력 채널 수의 16비트로 (모노는 복제, 초과 채널은 버림)
+    QVector<qint16> converted;
+    int sourceFrames = 0;
+
+    if (info.format == ImaAdpcm::FORMAT_TAG) {
+        ImaAdpcm::Layout layout;
+        if (info.bits != 4 || info.rate <= 0
+                || !ImaAdpcm::describe(info.data, info.dataSize, info.blockAlign, info.channels, info.factFrames, layout)) {
+            qDebug() << "SoundBank: unsupported IMA-ADPCM layout" << info.channels << "channels, block"
+                     << info.blockAlign << ":" << entry.path;
+            entry.file.clear();
+            return false;
+        }
+
+        // 장치 레이트와 같으면 압축된 채로 두고 오디오 스레드에서 블록 단위로 디코드
+        if (info.rate == rate && layout.framesPerBlock <= ImaAdpcm::MAX_BLOCK_FRAMES) {
+            entry.adpcm = layout;
+            entry.frames = layout.frames;
+            qDebug() << "SoundBank: streaming" << entry.path << "- IMA-ADPCM" << info.rate << "Hz"
+                     << info.channels << "ch," << layout.frames << "frames in" << layout.dataSize / 1024 << "KB";
+            return true;
+        }
+
+        converted.resize((layout.blockCount * layout.framesPerBlock + 1) * channels);
+        for (int block = 0; block < layout.blockCount; block++) {
+            sourceFrames += ImaAdpcm::decodeBlock(layout, block, converted.data() + sourceFrames * channels, channels);
+        }
+    } else {
+        int sampleBytes = info.bits / 8;
+        if (info.format != WAVE_FORMAT_PCM || info.bits % 8 != 0 || sampleBytes < 1 || sampleBytes > 4
+                || info.channels < 1 || info.channels > 8 || info.rate <= 0
+                || info.blockAlign < info.channels * sampleBytes) {
+            qDebug() << "SoundBank: unsupported WAV format" << info.format << info.bits << "bit,"
+                     << info.channels << "channels:" << entry.path;
+            entry.file.clear();
+            return false;
+        }
+
+        sourceFrames = info.dataSize / info.blockAlign;
+        converted.resize(sourceFrames * channels);
+        qint16 *dst = converted.data();
+        for (int i = 0; i < sourceFrames; i++) {
+            const uchar *frame = info.data + i * info.blockAlign;
+            for (int c = 0; c < channels; c++) {
+                int source = qMin(c, info.channels - 1);
+                *dst++ = (qint16)readSample(frame + source * sampleBytes, sampleBytes);
+            }
+        }
+    }
+
+    // 디코드한 뒤에는 원본이 필요 없음
+    entry.file.clear();
+    if (sourceFrames <= 0)
+        return false;
+
+    // 2단계: 출력 레이트로 (같으면 그대로 복사)
+    int frames = sourceFrames;
+    if (info.rate != rate)
+        frames = (int)(((qint64)sourceFrames * rate) / info.rate);
+    if (frames <= 0)
+        return false;
+
+    qint16 *data = static_cast<qint16*>(qMallocAligned((size_t)frames * channels * sizeof(qint16), ALIGNMENT));
+    if (!data)
+        return false;
+
+    if (info.rate == rate) {
+        memcpy(data, converted.constData(), (size_t)frames * channels * sizeof(qint16));
+    } else {
+        // 선형 보간 (위치는 Q16)
+        const qint16 *src = converted.constData();
+        qint64 step = ((qint64)info.rate << 16) / rate;
+        qint64 position = 0;
+        for (int i = 0; i < frames; i++, position += step) {
+            int index = (int)(position >> 16);
+            int frac = (int)(position & 0xffff);
+            int next = qMin(index + 1, sourceFrames - 1);
+            for (int c = 0; c < channels; c++) {
+                int a = src[index * channels + c];
+                int b = src[next * channels + c];
+                data[i * channels + c] = (qint16)(a + (((b - a) * frac) >> 16));
+            }
+        }
+    }
+
+    entry.data = data;
+    entry.frames = frames;
+    qDebug() << "SoundBank: decoded" << entry.path << "-" << info.rate << "Hz" << info.bits << "bit"
+             << info.channels << "ch ->" << frames << "frames";
+    return true;
+}
+
+void SoundBank::release(Entry &entry)
+{
+    if (entry.data)
+        qFreeAligned(entry.data);
+    entry.data = NULL;
+    entry.frames = 0;
+    entry.file.clear();
+    entry.adpcm = ImaAdpcm::Layout();
+    entry.attempted = false;
+}
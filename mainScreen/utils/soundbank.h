@@ -0,0 +1,84 @@
+#ifndef SOUNDBANK_H
+#define SOUNDBANK_H
+
+#include <QByteArray>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include "utils/imaadpcm.h"
+
+// 효과음/배경음악 샘플 뱅크
+// WAV(리소스 또는 파일)를 한 번만 읽어 장치 포맷(S16 인터리브, 장치 레이트/채널)으로 준비한다.
+// 재생 시에는 메모리만 읽으므로 임시 파일 복사나 헤더 재해석이 없다.
+//
+// PCM WAV는 정렬된 S16 버퍼로 미리 디코드한다.
+// IMA-ADPCM WAV(0x11)는 장치 레이트와 같으면 압축된 채로 두고(압축되지 않은 Qt 리소스면
+// 실행 파일의 데이터를 복사 없이 가리킴) 오디오 스레드가 블록 단위로 디코드하므로
+// 상주 메모리가 PCM의 1/4 이하이다. 레이트가 다르면 PCM으로 디코드해 리샘플링한다.
+//
+// RIFF 청크를 순서대로 따라가므로 fmt/data 사이의 LIST, bext, fact 청크도 처리한다.
+// 입력: PCM 8/16/24/32비트, WAVE_FORMAT_EXTENSIBLE(PCM), 1~8채널, IMA-ADPCM 1~2채널,
+//       임의 레이트 (선형 보간)
+//
+// 준비된 버퍼는 뱅크가 살아 있는 동안 바뀌지 않으므로 어느 스레드에서나 읽을 수 있다.
+class SoundBank
+{
+public:
+    static const int ALIGNMENT = 16;   // SIMD 믹싱용 버퍼 정렬
+
+    // 재생할 샘플: 디코드된 PCM(data) 또는 스트리밍할 IMA-ADPCM 블록(adpcm) 중 하나
+    struct Sample {
+        const qint16 *data;         // frames * channels 개의 qint16 (스트리밍이면 NULL)
+        ImaAdpcm::Layout adpcm;
+        int frames;
+        int channels;               // 출력 채널 수
+
+        Sample() : data(NULL), frames(0), channels(0) {}
+        bool isStreamed() const { return data == NULL && adpcm.isValid(); }
+        bool isValid() const { return (data != NULL || adpcm.isValid()) && frames > 0; }
+    };
+
+    SoundBank();
+    ~SoundBank();
+
+    // 디코드 대상 포맷 (재생 시작 전에 설정, 이미 디코드된 샘플은 버려짐)
+    void setOutputFormat(int rate, int channels);
+    int outputRate() const { return rate; }
+    int outputChannels() const { return channels; }
+
+    // 경로 등록 (디코드는 preload() 또는 첫 sample() 호출 때)
+    void add(int id, const QString &path);
+    // 등록된 모든 샘플을 미리 디코드, 성공한 개수 반환
+    int preload();
+    // 샘플 조회, 아직 디코드 전이면 지금 디코드 (실패 시 invalid)
+    Sample sample(int id);
+
+    // 뱅크가 힙에 들고 있는 크기 (디코드된 PCM + 복사해 둔 압축 원본, 바이트)
+    qint64 memoryUsage() const;
+
+private:
+    struct Entry {
+        QString path;
+        qint16 *data;               // 디코드된 PCM
+        QByteArray file;            // 리소스를 직접 가리킬 수 없을 때의 원본 복사본 (스트리밍용)
+        ImaAdpcm::Layout adpcm;     // 스트리밍 재생할 블록 (file 또는 리소스 데이터를 가리킴)
+        int frames;
+        bool attempted;
+
+        Entry() : data(NULL), frames(0), attempted(false) {}
+    };
+
+    bool loadFile(Entry &entry, const uchar *&bytes, int &size);
+    bool decode(Entry &entry);
+    qint64 decodedBytes() const;
+    void release(Entry &entry);
+
+    int rate;
+    int channels;
+    QMap<int, Entry> entries;
+    mutable QMutex mutex;
+
+    Q_DISABLE_COPY(SoundBank)
+};
+
+#endif // SOUNDBANK_H
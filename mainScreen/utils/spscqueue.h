@@ -0,0 +1,54 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+
+// 단일 생산자 / 단일 소비자 고정 크기 잠금 없는 큐
+// 생산자 스레드 하나만 push, 소비자 스레드 하나만 pop 해야 한다.
+// 실시간 스레드(오디오)가 잠금이나 할당 없이 명령을 받기 위한 용도
+// Capacity는 2의 거듭제곱, 실제로 담을 수 있는 개수는 Capacity - 1
+template <typename T, int Capacity>
+class SpscQueue
+{
+public:
+    SpscQueue() : head(0), tail(0) {}
+
+    // 생산자: 가득 차 있으면 false
+    bool push(const T &item)
+    {
+        unsigned int h = head.load(std::memory_order_relaxed);
+        unsigned int next = (h + 1) & MASK;
+        if (next == tail.load(std::memory_order_acquire))
+            return false;
+        items[h] = item;
+        head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // 소비자: 비어 있으면 false
+    bool pop(T &item)
+    {
+        unsigned int t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire))
+            return false;
+        item = items[t];
+        tail.store((t + 1) & MASK, std::memory_order_release);
+        return true;
+    }
+
+    bool isEmpty() const
+    {
+        return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire);
+    }
+
+private:
+    static const unsigned int MASK = Capacity - 1;
+    static_assert((Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+    T items[Capacity];
+    // 생산자/소비자가 서로의 캐시 라인을 건드리지 않도록 분리
+    alignas(64) std::atomic<unsigned int> head;     // 다음에 쓸 자리 (생산자)
+    alignas(64) std::atomic<unsigned int> tail;     // 다음에 읽을 자리 (소비자)
+};
+
+#endif // SPSCQUEUE_H
@@ -0,0 +1,202 @@
+#include "summedareatable.h"
+#include <QDebug>
+#include <math.h>
+#include <string.h>
+
+SummedAreaTable::SummedAreaTable() :
+    w(0),
+    h(0),
+    key(0)
+{
+}
+
+void SummedAreaTable::clear()
+{
+    table.clear();
+    w = h = 0;
+    key = 0;
+}
+
+bool SummedAreaTable::build(const QImage &image)
+{
+    if (image.isNull()) {
+        clear();
+        return false;
+    }
+
+    // 같은 프레임이면 재사용 (슬라이더 조작 등으로 같은 프레임을 여러 번 샘플링하는 경우)
+    if (isValid() && image.cacheKey() == key && image.width() == w && image.height() == h)
+        return true;
+
+    QImage rgb = (image.format() == QImage::Format_RGB888)
+            ? image : image.convertToFormat(QImage::Format_RGB888);
+
+    w = rgb.width();
+    h = rgb.height();
+    key = image.cacheKey();
+
+    int stride = (w + 1) * 3;
+    table.resize(stride * (h + 1));
+    quint32 *data = table.data();
+
+    // 0행은 0
+    memset(data, 0, stride * sizeof(quint32));
+
+    for (int y = 0; y < h; y++) {
+        const uchar *src = rgb.constScanLine(y);
+        const quint32 *above = data + y * stride;
+        quint32 *row = data + (y + 1) * stride;
+
+        // 1단계: 행 내부 누적합 (채널별 순차 의존성)
+        quint32 r = 0, g = 0, b = 0;
+        row[0] = row[1] = row[2] = 0;
+        for (int x = 0; x < w; x++) {
+            r += src[0];
+            g += src[1];
+            b += src[2];
+            row[(x + 1) * 3 + 0] = r;
+            row[(x + 1) * 3 + 1] = g;
+            row[(x + 1) * 3 + 2] = b;
+            src += 3;
+        }
+
+        // 2단계: 윗행 더하기 (의존성 없는 단순 루프라 컴파일러가 벡터화)
+        for (int i = 3; i < stride; i++) {
+            row[i] += above[i];
+        }
+    }
+
+    return true;
+}
+
+int SummedAreaTable::rectSum(int x0, int y0, int x1, int y1, qint64 sum[3]) const
+{
+    sum[0] = sum[1] = sum[2] = 0;
+
+    x0 = qMax(x0, 0);
+    y0 = qMax(y0, 0);
+    x1 = qMin(x1, w);
+    y1 = qMin(y1, h);
+    if (x0 >= x1 || y0 >= y1)
+        return 0;
+
+    const quint32 *a = at(x0, y0);
+    const quint32 *b = at(x1, y0);
+    const quint32 *c = at(x0, y1);
+    const quint32 *d = at(x1, y1);
+    for (int i = 0; i < 3; i++) {
+        // 부호 없는 32비트 모듈러 연산: 중간에 넘쳐도 결과는 정확
+        sum[i] = (quint32)(d[i] - b[i] - c[i] + a[i]);
+    }
+
+    return (x1 - x0) * (y1 - y0);
+}
+
+// 원 안의 dy 행 구간 [x0, x1) (이미지 경계는 호출하는 쪽에서 자름)
+static void circleRowSpan(int centerX, int radius, int dy, int &x0, int &x1)
+{
+    // 이 행에서 dx^2 <= r^2 - dy^2 를 만족하는 최대 dx (정수 제곱근)
+    int rem = radius * radius - dy * dy;
+    int span = (int)sqrt((double)rem);
+    while (span * span > rem) span--;
+    while ((span + 1) * (span + 1) <= rem) span++;
+
+    x0 = centerX - span;
+    x1 = qMin(centerX + span, centerX + radius - 1) + 1;
+}
+
+int SummedAreaTable::circleSum(int centerX, int centerY, int radius, qint64 sum[3]) const
+{
+    sum[0] = sum[1] = sum[2] = 0;
+    if (!isValid() || radius <= 0)
+        return 0;
+
+    int count = 0;
+    for (int dy = -radius; dy < radius; dy++) {
+        int y = centerY + dy;
+        if (y < 0 || y >= h)
+            continue;
+
+        int x0, x1;
+        circleRowSpan(centerX, radius, dy, x0, x1);
+
+        qint64 rowSum[3];
+        count += rectSum(x0, y, x1, y + 1, rowSum);
+        sum[0] += rowSum[0];
+        sum[1] += rowSum[1];
+        sum[2] += rowSum[2];
+    }
+
+    return count;
+}
+
+int SummedAreaTable::imageCircleSum(const QImage &image, int centerX, int centerY, int radius, qint64 sum[3])
+{
+    sum[0] = sum[1] = sum[2] = 0;
+    if (image.isNull() || radius <= 0)
+        return 0;
+
+    // 원을 감싸는 사각형 (이미지 경계로 자름)
+    int bx0 = qMax(centerX - radius, 0);
+    int by0 = qMax(centerY - radius, 0);
+    int bx1 = qMin(centerX + radius, image.width());
+    int by1 = qMin(centerY + radius, image.height());
+    if (bx0 >= bx1 || by0 >= by1)
+        return 0;
+
+    // RGB888이 아니면 원을 감싸는 영역만 변환
+    QImage rgb = image;
+    int ox = 0, oy = 0;
+    if (image.format() != QImage::Format_RGB888) {
+        rgb = image.copy(bx0, by0, bx1 - bx0, by1 - by0).convertToFormat(QImage::Format_RGB888);
+        ox = bx0;
+        oy = by0;
+    }
+
+    int count = 0;
+    for (int y = by0; y < by1; y++) {
+        int x0, x1;
+        circleRowSpan(centerX, radius, y - centerY, x0, x1);
+        x0 = qMax(x0, bx0);
+        x1 = qMin(x1, bx1);
+        if (x0 >= x1)
+            continue;
+
+        const uchar *src = rgb.constScanLine(y - oy) + (x0 - ox) * 3;
+        quint32 r = 0, g = 0, b = 0; // 한 행은 최대 2r 픽셀이라 32비트로 충분
+        for (int x = x0; x < x1; x++) {
+            r += src[0];
+            g += src[1];
+            b += src[2];
+            src += 3;
+        }
+        sum[0] += r;
+        sum[1] += g;
+        sum[2] += b;
+        count += x1 - x0;
+    }
+
+    return count;
+}
+
+bool SummedAreaTable::rectAverage(int x0, int y0, int x1, int y1, QColor &color) const
+{
+    qint64 sum[3];
+    int count = rectSum(x0, y0, x1, y1, sum);
+    if (count <= 0)
+        return false;
+
+    color = QColor(sum[0] / count, sum[1] / count, sum[2] / count);
+    return true;
+}
+
+bool SummedAreaTable::circleAverage(int centerX, int centerY, int radius, QColor &color) const
+{
+    qint64 sum[3];
+    int count = circleSum(centerX, centerY, radius, sum);
+    if (count <= 0)
+        return false;
+
+    color = QColor(sum[0] / count, sum[1] / count, sum[2] / count);
+    return true;
+}
@@ -0,0 +1,51 @@
+#ifndef SUMMEDAREATABLE_H
+#define SUMMEDAREATABLE_H
+
+#include <QImage>
+#include <QColor>
+#include <QVector>
+
+// 프레임별 RGB 누적합 테이블 (integral image)
+// 한 번 구축하면 사각형 합은 O(1), 원 합은 행 구간(span)마다 O(1)로 계산한다.
+// 구축 비용이 프레임 전체에 비례하므로 같은 프레임을 여러 번 조회할 때만 쓴다.
+// 같은 프레임(QImage::cacheKey)에 대해 build()를 반복 호출해도 재구축하지 않는다.
+class SummedAreaTable
+{
+public:
+    SummedAreaTable();
+
+    // image로 테이블 구축 (이미 같은 프레임이면 바로 반환)
+    bool build(const QImage &image);
+    void clear();
+
+    bool isValid() const { return w > 0 && h > 0; }
+    int width() const { return w; }
+    int height() const { return h; }
+
+    // [x0, x1) x [y0, y1) 영역 합 (이미지 밖은 잘라냄), 반환값은 픽셀 수
+    int rectSum(int x0, int y0, int x1, int y1, qint64 sum[3]) const;
+
+    // 원 내부 합, 포함 규칙은 기존 calculateAverageRGB와 동일:
+    // x, y는 [c - r, c + r) 범위이고 dx^2 + dy^2 <= r^2 인 이미지 내부 픽셀
+    int circleSum(int centerX, int centerY, int radius, qint64 sum[3]) const;
+
+    // 테이블 없이 image에서 원의 행 구간을 직접 합산 (circleSum과 같은 포함 규칙)
+    // 한 프레임에 원 하나만 묻는 경우 테이블 구축(w x h 전체 누적)보다 훨씬 싸다
+    static int imageCircleSum(const QImage &image, int centerX, int centerY, int radius, qint64 sum[3]);
+
+    // 평균 색상 (포함된 픽셀이 없으면 false)
+    bool rectAverage(int x0, int y0, int x1, int y1, QColor &color) const;
+    bool circleAverage(int centerX, int centerY, int radius, QColor &color) const;
+
+private:
+    // (w + 1) x (h + 1) x 3 채널, 0행/0열은 0
+    // 합은 2^32를 넘을 수 있지만 사각형 합은 모듈러 연산으로 정확하다 (영역 < 16M 픽셀)
+    QVector<quint32> table;
+    int w;
+    int h;
+    qint64 key;
+
+    inline const quint32 *at(int x, int y) const { return table.constData() + ((qint64)y * (w + 1) + x) * 3; }
+};
+
+#endif // SUMMEDAREATABLE_H
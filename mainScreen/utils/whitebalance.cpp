@@ -0,0 +1,127 @@
+#include "whitebalance.h"
+#include <QDebug>
+
+namespace {
+// 포화되었거나 너무 어두운 점은 광원 색을 알려주지 않으므로 제외
+const int CLIPPED_LEVEL = 250;
+const int DARK_SUM = 45;
+
+// 유효 점이 격자의 이 비율(1/n) 미만이면 추정하지 않음
+const int MIN_VALID_DIVISOR = 20;
+
+// white-patch: 가장 밝은 점의 이 비율 이상인 점들의 평균
+const float WHITE_PATCH_LEVEL = 0.9f;
+
+// 프레임당 남은 편차를 고치는 비율 (30fps에서 약 1초에 수렴), 이보다 작은 편차는 무시
+const float ADAPT_RATE = 0.05f;
+const float DEAD_BAND = 0.01f;
+
+const float MIN_GAIN = 0.5f;
+const float MAX_GAIN = 2.0f;
+}
+
+WhiteBalance::WhiteBalance() :
+    enabled(qgetenv("COLORBINGO_AWB") != "0"),
+    lockedFlag(false),
+    resetRequested(false),
+    gainRed(1.0f),
+    gainBlue(1.0f),
+    publishedRed(UNITY_GAIN),
+    publishedBlue(UNITY_GAIN)
+{
+    if (!enabled) {
+        qDebug() << "WhiteBalance: disabled by COLORBINGO_AWB=0";
+    }
+}
+
+void WhiteBalance::reset()
+{
+    gainRed = gainBlue = 1.0f;
+    publishedRed.store(UNITY_GAIN, std::memory_order_relaxed);
+    publishedBlue.store(UNITY_GAIN, std::memory_order_relaxed);
+}
+
+bool WhiteBalance::update(const QImage &rgb)
+{
+    if (!enabled)
+        return false;
+
+    // 잠근 상태에서도 초기화 요청은 반영 (게인이 바뀌었으므로 true)
+    if (resetRequested.exchange(false, std::memory_order_acquire)) {
+        reset();
+        return true;
+    }
+
+    if (isLocked() || rgb.format() != QImage::Format_RGB888)
+        return false;
+
+    int width = rgb.width();
+    int height = rgb.height();
+    if (width < GRID_WIDTH || height < GRID_HEIGHT)
+        return false;
+
+    // 격자 점 통계 (프레임당 768점만 읽음)
+    int samples[GRID_WIDTH * GRID_HEIGHT][3];
+    int count = 0;
+    int maxSum = 0;
+    qint64 graySum[3] = { 0, 0, 0 };
+
+    for (int gy = 0; gy < GRID_HEIGHT; gy++) {
+        const uchar *line = rgb.constScanLine(((gy * 2 + 1) * height) / (GRID_HEIGHT * 2));
+        for (int gx = 0; gx < GRID_WIDTH; gx++) {
+            const uchar *p = line + (((gx * 2 + 1) * width) / (GRID_WIDTH * 2)) * 3;
+            int r = p[0], g = p[1], b = p[2];
+            int sum = r + g + b;
+            if (r >= CLIPPED_LEVEL || g >= CLIPPED_LEVEL || b >= CLIPPED_LEVEL || sum < DARK_SUM)
+                continue;
+
+            samples[count][0] = r;
+            samples[count][1] = g;
+            samples[count][2] = b;
+            count++;
+            graySum[0] += r;
+            graySum[1] += g;
+            graySum[2] += b;
+            maxSum = qMax(maxSum, sum);
+        }
+    }
+
+    if (count < (GRID_WIDTH * GRID_HEIGHT) / MIN_VALID_DIVISOR || graySum[1] == 0)
+        return false;
+
+    qint64 whiteSum[3] = { 0, 0, 0 };
+    int whiteLevel = (int)(maxSum * WHITE_PATCH_LEVEL);
+    for (int i = 0; i < count; i++) {
+        if (samples[i][0] + samples[i][1] + samples[i][2] < whiteLevel)
+            continue;
+        whiteSum[0] += samples[i][0];
+        whiteSum[1] += samples[i][1];
+        whiteSum[2] += samples[i][2];
+    }
+    if (whiteSum[1] == 0)
+        return false;
+
+    // 광원 색 추정 (초록 기준), 두 방법의 평균
+    float redCast = 0.5f * ((float)graySum[0] / graySum[1] + (float)whiteSum[0] / whiteSum[1]);
+    float blueCast = 0.5f * ((float)graySum[2] / graySum[1] + (float)whiteSum[2] / whiteSum[1]);
+    if (redCast <= 0.0f || blueCast <= 0.0f)
+        return false;
+
+    // 보정된 프레임에서 남은 편차만큼 게인을 조금씩 조정
+    float redResidual = 1.0f / redCast - 1.0f;
+    float blueResidual = 1.0f / blueCast - 1.0f;
+    if (qAbs(redResidual) > DEAD_BAND) {
+        gainRed = qBound(MIN_GAIN, gainRed * (1.0f + ADAPT_RATE * redResidual), MAX_GAIN);
+    }
+    if (qAbs(blueResidual) > DEAD_BAND) {
+        gainBlue = qBound(MIN_GAIN, gainBlue * (1.0f + ADAPT_RATE * blueResidual), MAX_GAIN);
+    }
+
+    int red = (int)(gainRed * UNITY_GAIN + 0.5f);
+    int blue = (int)(gainBlue * UNITY_GAIN + 0.5f);
+    bool changed = red != publishedRed.load(std::memory_order_relaxed)
+            || blue != publishedBlue.load(std::memory_order_relaxed);
+    publishedRed.store(red, std::memory_order_relaxed);
+    publishedBlue.store(blue, std::memory_order_relaxed);
+    return changed;
+}
@@ -0,0 +1,51 @@
+#ifndef WHITEBALANCE_H
+#define WHITEBALANCE_H
+
+#include <QImage>
+#include <atomic>
+
+// 소프트웨어 자동 화이트 밸런스 추정기
+// 변환된 프레임의 32x24 격자 점만 읽어 gray-world(전체 평균)와 white-patch(가장 밝은 점들)
+// 추정을 섞고, 초록 기준 빨강/파랑 게인을 프레임마다 조금씩 움직인다.
+// 격자는 이미 보정된 프레임에서 읽으므로 남은 색 편차만큼 게인을 고치는 폐루프이다.
+//
+// 카메라 자체 AWB는 시간이 지나면 흘러가므로, 빙고판을 만들 때 게인을 잠가
+// 판의 색과 게임 중 캡처한 색이 같은 보정을 거치게 한다.
+//
+// update()는 캡처 스레드 전용, 잠금/조회는 어느 스레드에서나 가능
+// COLORBINGO_AWB=0 이면 비활성 (게인 1.0 고정)
+class WhiteBalance
+{
+public:
+    static const int GRID_WIDTH = 32;
+    static const int GRID_HEIGHT = 24;
+    static const int UNITY_GAIN = 256;  // Q8
+
+    WhiteBalance();
+
+    // 캡처 스레드: 프레임 격자 통계로 게인 갱신, 적용할 게인(Q8)이 바뀌었으면 true
+    bool update(const QImage &rgb);
+    // 캡처 스레드: 게인을 1.0으로 되돌림 (잠금 상태는 유지)
+    void reset();
+    // 아무 스레드: 다음 update()에서 잠금 여부와 상관없이 게인을 1.0으로 되돌리도록 요청
+    void requestReset() { resetRequested.store(true, std::memory_order_release); }
+
+    void setLocked(bool locked) { lockedFlag.store(locked, std::memory_order_relaxed); }
+    bool isLocked() const { return lockedFlag.load(std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled; }
+
+    // 현재 적용 중인 게인 (Q8)
+    int redGain() const { return publishedRed.load(std::memory_order_relaxed); }
+    int blueGain() const { return publishedBlue.load(std::memory_order_relaxed); }
+
+private:
+    bool enabled;
+    std::atomic<bool> lockedFlag;
+    std::atomic<bool> resetRequested;
+    float gainRed;                      // 이하 캡처 스레드 전용
+    float gainBlue;
+    std::atomic<int> publishedRed;
+    std::atomic<int> publishedBlue;
+};
+
+#endif // WHITEBALANCE_H
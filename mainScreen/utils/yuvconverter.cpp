@@ -0,0 +1,439 @@
+#include "yuvconverter.h"
+#include "colorcorrection.h"
+#include <QDebug>
+#include <math.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#include <immintrin.h>
+#define YUV_HAVE_X86 1
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define YUV_HAVE_NEON 1
+#if !defined(__aarch64__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+
+// SIMD 경로용 고정소수점 계수 (Q13)
+// trunc(c * d) == floor(d * M / 8192) + (d < 0 ? 1 : 0) 이 d = -128..127 전 구간에서
+// 기존 테이블과 정확히 일치하도록 전수 검사로 고른 값이다.
+// 밝기(Y)는 floor(i * 9831 / 8192) == (int)(i * 1.2) (i = 0..255) 이다.
+static const int Q13_Y = 9831;          // 1.2
+static const int Q13_CB_BLUE = 14574;   // 1.7790
+static const int Q13_CB_GREEN = 2830;   // 0.3455
+static const int Q13_CR_GREEN = 5873;   // 0.7169
+static const int Q13_CR_RED = 11530;    // 1.4075
+
+YuvConverter::Tables::Tables()
+{
+    for (int i = 0; i < 256; i++) {
+        y[i] = qBound(0, (int)(i * 1.2), 255); // 밝기 향상 20%
+
+        cbBlue[i] = (int)(1.7790 * (i - 128));
+        cbGreen[i] = -(int)(0.3455 * (i - 128));
+        crGreen[i] = -(int)(0.7169 * (i - 128));
+        crRed[i] = (int)(1.4075 * (i - 128));
+    }
+}
+
+const YuvConverter::Tables &YuvConverter::tables()
+{
+    static const Tables t;
+    return t;
+}
+
+void YuvConverter::convertRowScalar(const uchar *yuyv, uchar *rgb, int width)
+{
+    const Tables &t = tables();
+
+    // 2픽셀마다 4바이트 (Y0 U Y1 V)
+    for (int j = 0; j < width / 2; j++) {
+        int Y0 = t.y[yuyv[0]];
+        int U = yuyv[1];
+        int Y1 = t.y[yuyv[2]];
+        int V = yuyv[3];
+
+        int cr = t.crRed[V];
+        int cg = t.cbGreen[U] + t.crGreen[V];
+        int cb = t.cbBlue[U];
+
+        rgb[0] = (uchar)qBound(0, Y0 + cr, 255);
+        rgb[1] = (uchar)qBound(0, Y0 + cg, 255);
+        rgb[2] = (uchar)qBound(0, Y0 + cb, 255);
+        rgb[3] = (uchar)qBound(0, Y1 + cr, 255);
+        rgb[4] = (uchar)qBound(0, Y1 + cg, 255);
+        rgb[5] = (uchar)qBound(0, Y1 + cb, 255);
+
+        yuyv += 4;
+        rgb += 6;
+    }
+}
+
+#ifdef YUV_HAVE_X86
+
+// trunc(d * M / 8192): mulhi((d << 3), M) 는 floor(d * M / 8192), 음수이면 1을 더해 0 방향으로 자른다
+static inline __m128i mulTruncQ13(__m128i d, short m)
+{
+    __m128i fl = _mm_mulhi_epi16(_mm_slli_epi16(d, 3), _mm_set1_epi16(m));
+    return _mm_sub_epi16(fl, _mm_srai_epi16(d, 15));
+}
+
+// SSE2: 한 번에 8픽셀 (16바이트 YUYV)
+static void convertRowSse2(const uchar *yuyv, uchar *rgb, int width)
+{
+    const __m128i lowByte = _mm_set1_epi16(0x00FF);
+    const __m128i bias = _mm_set1_epi16(128);
+    const __m128i maxY = _mm_set1_epi16(255);
+    const __m128i yScale = _mm_set1_epi16(Q13_Y);
+    alignas(16) quint32 rgbx[8];
+
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(yuyv + x * 2));
+        __m128i y = _mm_and_si128(v, lowByte);
+        __m128i c = _mm_srli_epi16(v, 8); // U0 V0 U1 V1 U2 V2 U3 V3
+
+        // 픽셀 쌍마다 U, V 복제
+        __m128i u = _mm_shufflehi_epi16(_mm_shufflelo_epi16(c, _MM_SHUFFLE(2, 2, 0, 0)), _MM_SHUFFLE(2, 2, 0, 0));
+        __m128i vv = _mm_shufflehi_epi16(_mm_shufflelo_epi16(c, _MM_SHUFFLE(3, 3, 1, 1)), _MM_SHUFFLE(3, 3, 1, 1));
+        __m128i du = _mm_sub_epi16(u, bias);
+        __m128i dv = _mm_sub_epi16(vv, bias);
+
+        __m128i yy = _mm_min_epi16(_mm_mulhi_epi16(_mm_slli_epi16(y, 3), yScale), maxY);
+
+        __m128i r = _mm_add_epi16(yy, mulTruncQ13(dv, Q13_CR_RED));
+        __m128i g = _mm_sub_epi16(_mm_sub_epi16(yy, mulTruncQ13(du, Q13_CB_GREEN)), mulTruncQ13(dv, Q13_CR_GREEN));
+        __m128i b = _mm_add_epi16(yy, mulTruncQ13(du, Q13_CB_BLUE));
+
+        // 0..255 포화 후 R G B X 로 묶기
+        __m128i r8 = _mm_packus_epi16(r, r);
+        __m128i g8 = _mm_packus_epi16(g, g);
+        __m128i b8 = _mm_packus_epi16(b, b);
+        __m128i rg = _mm_unpacklo_epi8(r8, g8);
+        __m128i bx = _mm_unpacklo_epi8(b8, _mm_setzero_si128());
+        _mm_store_si128(reinterpret_cast<__m128i *>(rgbx), _mm_unpacklo_epi16(rg, bx));
+        _mm_store_si128(reinterpret_cast<__m128i *>(rgbx + 4), _mm_unpackhi_epi16(rg, bx));
+
+        // SSE2에는 바이트 셔플이 없으므로 3바이트 포장은 스칼라로
+        uchar *out = rgb + x * 3;
+        for (int i = 0; i < 8; i++) {
+            out[i * 3 + 0] = (uchar)(rgbx[i]);
+            out[i * 3 + 1] = (uchar)(rgbx[i] >> 8);
+            out[i * 3 + 2] = (uchar)(rgbx[i] >> 16);
+        }
+    }
+
+    if (x < width) {
+        YuvConverter::convertRowScalar(yuyv + x * 2, rgb + x * 3, width - x);
+    }
+}
+
+__attribute__((target("avx2")))
+static inline __m256i mulTruncQ13Avx2(__m256i d, short m)
+{
+    __m256i fl = _mm256_mulhi_epi16(_mm256_slli_epi16(d, 3), _mm256_set1_epi16(m));
+    return _mm256_sub_epi16(fl, _mm256_srai_epi16(d, 15));
+}
+
+// AVX2: 한 번에 16픽셀 (32바이트 YUYV), 128비트 레인마다 8픽셀씩 처리
+__attribute__((target("avx2")))
+static void convertRowAvx2(const uchar *yuyv, uchar *rgb, int width)
+{
+    const __m256i lowByte = _mm256_set1_epi16(0x00FF);
+    const __m256i bias = _mm256_set1_epi16(128);
+    const __m256i maxY = _mm256_set1_epi16(255);
+    const __m256i yScale = _mm256_set1_epi16(Q13_Y);
+
+    // 레인 내부 바이트 셔플 인덱스: [R0..R7 G0..G7] + [B0..B7 0..] -> R G B 24바이트
+    const __m256i rgIdx0 = _mm256_setr_epi8(
+        0, 8, -1, 1, 9, -1, 2, 10, -1, 3, 11, -1, 4, 12, -1, 5,
+        0, 8, -1, 1, 9, -1, 2, 10, -1, 3, 11, -1, 4, 12, -1, 5);
+    const __m256i bIdx0 = _mm256_setr_epi8(
+        -1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1,
+        -1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1);
+    const __m256i rgIdx1 = _mm256_setr_epi8(
+        13, -1, 6, 14, -1, 7, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        13, -1, 6, 14, -1, 7, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m256i bIdx1 = _mm256_setr_epi8(
+        -1, 5, -1, -1, 6, -1, -1, 7, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, 5, -1, -1, 6, -1, -1, 7, -1, -1, -1, -1, -1, -1, -1, -1);
+
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(yuyv + x * 2));
+        __m256i y = _mm256_and_si256(v, lowByte);
+        __m256i c = _mm256_srli_epi16(v, 8);
+
+        __m256i u = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(c, _MM_SHUFFLE(2, 2, 0, 0)), _MM_SHUFFLE(2, 2, 0, 0));
+        __m256i vv = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(c, _MM_SHUFFLE(3, 3, 1, 1)), _MM_SHUFFLE(3, 3, 1, 1));
+        __m256i du = _mm256_sub_epi16(u, bias);
+        __m256i dv = _mm256_sub_epi16(vv, bias);
+
+        __m256i yy = _mm256_min_epi16(_mm256_mulhi_epi16(_mm256_slli_epi16(y, 3), yScale), maxY);
+
+        __m256i r = _mm256_add_epi16(yy, mulTruncQ13Avx2(dv, Q13_CR_RED));
+        __m256i g = _mm256_sub_epi16(_mm256_sub_epi16(yy, mulTruncQ13Avx2(du, Q13_CB_GREEN)), mulTruncQ13Avx2(dv, Q13_CR_GREEN));
+        __m256i b = _mm256_add_epi16(yy, mulTruncQ13Avx2(du, Q13_CB_BLUE));
+
+        __m256i rg = _mm256_packus_epi16(r, g);                      // 레인별 R0..7 G0..7
+        __m256i bz = _mm256_packus_epi16(b, _mm256_setzero_si256());  // 레인별 B0..7 0..
+        __m256i out0 = _mm256_or_si256(_mm256_shuffle_epi8(rg, rgIdx0), _mm256_shuffle_epi8(bz, bIdx0));
+        __m256i out1 = _mm256_or_si256(_mm256_shuffle_epi8(rg, rgIdx1), _mm256_shuffle_epi8(bz, bIdx1));
+
+        uchar *out = rgb + x * 3;
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm256_castsi256_si128(out0));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + 16), _mm256_castsi256_si128(out1));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 24), _mm256_extracti128_si256(out0, 1));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + 40), _mm256_extracti128_si256(out1, 1));
+    }
+
+    if (x < width) {
+        convertRowSse2(yuyv + x * 2, rgb + x * 3, width - x);
+    }
+}
+
+#endif // YUV_HAVE_X86
+
+#ifdef YUV_HAVE_NEON
+
+// vqdmulh(d << 2, M) == floor(d * M / 8192), 음수이면 1을 더해 0 방향으로 자른다
+static inline int16x8_t mulTruncQ13Neon(int16x8_t d, int16_t m)
+{
+    int16x8_t fl = vqdmulhq_n_s16(vshlq_n_s16(d, 2), m);
+    return vsubq_s16(fl, vshrq_n_s16(d, 15));
+}
+
+// NEON: 한 번에 16픽셀 (vld4로 Y0/U/Y1/V 분리, vst3로 RGB 인터리브 저장)
+static void convertRowNeon(const uchar *yuyv, uchar *rgb, int width)
+{
+    const int16x8_t bias = vdupq_n_s16(128);
+    const int16x8_t maxY = vdupq_n_s16(255);
+
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        uint8x8x4_t px = vld4_u8(yuyv + x * 2);
+
+        int16x8_t y0 = vreinterpretq_s16_u16(vmovl_u8(px.val[0]));
+        int16x8_t y1 = vreinterpretq_s16_u16(vmovl_u8(px.val[2]));
+        int16x8_t du = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(px.val[1])), bias);
+        int16x8_t dv = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(px.val[3])), bias);
+
+        int16x8_t yy0 = vminq_s16(vqdmulhq_n_s16(vshlq_n_s16(y0, 2), Q13_Y), maxY);
+        int16x8_t yy1 = vminq_s16(vqdmulhq_n_s16(vshlq_n_s16(y1, 2), Q13_Y), maxY);
+
+        int16x8_t cr = mulTruncQ13Neon(dv, Q13_CR_RED);
+        int16x8_t cg = vnegq_s16(vaddq_s16(mulTruncQ13Neon(du, Q13_CB_GREEN), mulTruncQ13Neon(dv, Q13_CR_GREEN)));
+        int16x8_t cb = mulTruncQ13Neon(du, Q13_CB_BLUE);
+
+        // 짝수/홀수 픽셀을 다시 인터리브
+        uint8x8x2_t r = vzip_u8(vqmovun_s16(vaddq_s16(yy0, cr)), vqmovun_s16(vaddq_s16(yy1, cr)));
+        uint8x8x2_t g = vzip_u8(vqmovun_s16(vaddq_s16(yy0, cg)), vqmovun_s16(vaddq_s16(yy1, cg)));
+        uint8x8x2_t b = vzip_u8(vqmovun_s16(vaddq_s16(yy0, cb)), vqmovun_s16(vaddq_s16(yy1, cb)));
+
+        uint8x8x3_t lo = { { r.val[0], g.val[0], b.val[0] } };
+        uint8x8x3_t hi = { { r.val[1], g.val[1], b.val[1] } };
+        vst3_u8(rgb + x * 3, lo);
+        vst3_u8(rgb + x * 3 + 24, hi);
+    }
+
+    if (x < width) {
+        YuvConverter::convertRowScalar(yuyv + x * 2, rgb + x * 3, width - x);
+    }
+}
+
+#endif // YUV_HAVE_NEON
+
+YuvConverter::Kernel YuvConverter::selectKernel()
+{
+    Kernel k = { &YuvConverter::convertRowScalar, "scalar" };
+
+#ifdef YUV_HAVE_X86
+    k.convert = &convertRowSse2;
+    k.name = "sse2";
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        k.convert = &convertRowAvx2;
+        k.name = "avx2";
+    }
+#endif
+
+#ifdef YUV_HAVE_NEON
+#if defined(__aarch64__)
+    k.convert = &convertRowNeon;
+    k.name = "neon";
+#else
+    if (getauxval(AT_HWCAP) & HWCAP_NEON) {
+        k.convert = &convertRowNeon;
+        k.name = "neon";
+    }
+#endif
+#endif
+
+    qDebug() << "YuvConverter: using" << k.name << "kernel";
+    return k;
+}
+
+const YuvConverter::Kernel &YuvConverter::kernel()
+{
+    static const Kernel k = selectKernel();
+    return k;
+}
+
+YuvConverter::RowConverter YuvConverter::rowConverter()
+{
+    return kernel().convert;
+}
+
+const char *YuvConverter::kernelName()
+{
+    return kernel().name;
+}
+
+void YuvConverter::yuyvToRgb888(const uchar *yuyv, int bytesPerLine, int width, int height, QImage &rgbImage,
+                                const ColorCorrection *correction)
+{
+    if (rgbImage.width() != width || rgbImage.height() != height || rgbImage.format() != QImage::Format_RGB888) {
+        qDebug() << "YuvConverter: destination image size/format mismatch";
+        return;
+    }
+
+    RowConverter convert = rowConverter();
+    if (correction && correction->isActive()) {
+        for (int i = 0; i < height; i++) {
+            uchar *rgb = rgbImage.scanLine(i);
+            convert(yuyv + i * bytesPerLine, rgb, width);
+            correction->applyRow(rgb, width);
+        }
+        return;
+    }
+
+    for (int i = 0; i < height; i++) {
+        convert(yuyv + i * bytesPerLine, rgbImage.scanLine(i), width);
+    }
+}
+
+void YuvConverter::nv12ToRgb888(const uchar *yPlane, const uchar *uvPlane, int bytesPerLine,
+                                int width, int height, QImage &rgbImage, const ColorCorrection *correction)
+{
+    if (rgbImage.width() != width || rgbImage.height() != height || rgbImage.format() != QImage::Format_RGB888) {
+        qDebug() << "YuvConverter: destination image size/format mismatch";
+        return;
+    }
+
+    const Tables &t = tables();
+    for (int i = 0; i < height; i++) {
+        const uchar *yRow = yPlane + i * bytesPerLine;
+        const uchar *uvRow = uvPlane + (i / 2) * bytesPerLine;  // 두 행이 같은 색차 행을 공유
+        uchar *rgb = rgbImage.scanLine(i);
+
+        for (int j = 0; j < width / 2; j++) {
+            int U = uvRow[0];
+            int V = uvRow[1];
+            int cr = t.crRed[V];
+            int cg = t.cbGreen[U] + t.crGreen[V];
+            int cb = t.cbBlue[U];
+            int Y0 = t.y[yRow[0]];
+            int Y1 = t.y[yRow[1]];
+
+            rgb[0] = (uchar)qBound(0, Y0 + cr, 255);
+            rgb[1] = (uchar)qBound(0, Y0 + cg, 255);
+            rgb[2] = (uchar)qBound(0, Y0 + cb, 255);
+            rgb[3] = (uchar)qBound(0, Y1 + cr, 255);
+            rgb[4] = (uchar)qBound(0, Y1 + cg, 255);
+            rgb[5] = (uchar)qBound(0, Y1 + cb, 255);
+
+            yRow += 2;
+            uvRow += 2;
+            rgb += 6;
+        }
+
+        if (correction && correction->isActive()) {
+            correction->applyRow(rgbImage.scanLine(i), width);
+        }
+    }
+}
+
+void YuvConverter::yuyvToRgb888Subsampled(const uchar *yuyv, int bytesPerLine, int width, int height,
+                                          int factor, QImage &rgbImage, const ColorCorrection *correction)
+{
+    int outWidth = width / factor;
+    int outHeight = height / factor;
+    if (factor < 2 || (factor & 1) || rgbImage.width() != outWidth || rgbImage.height() != outHeight
+            || rgbImage.format() != QImage::Format_RGB888) {
+        qDebug() << "YuvConverter: destination image size/format mismatch";
+        return;
+    }
+
+    const Tables &t = tables();
+    // 짝수 x만 샘플링하므로 각 출력 픽셀은 매크로픽셀의 Y0와 그 U/V를 사용
+    int step = factor * 2;
+    for (int i = 0; i < outHeight; i++) {
+        const uchar *src = yuyv + (i * factor) * bytesPerLine;
+        uchar *rgb = rgbImage.scanLine(i);
+
+        for (int j = 0; j < outWidth; j++) {
+            int Y = t.y[src[0]];
+            int U = src[1];
+            int V = src[3];
+
+            rgb[0] = (uchar)qBound(0, Y + t.crRed[V], 255);
+            rgb[1] = (uchar)qBound(0, Y + t.cbGreen[U] + t.crGreen[V], 255);
+            rgb[2] = (uchar)qBound(0, Y + t.cbBlue[U], 255);
+
+            src += step;
+            rgb += 3;
+        }
+
+        if (correction && correction->isActive()) {
+            correction->applyRow(rgbImage.scanLine(i), outWidth);
+        }
+    }
+}
+
+int YuvConverter::yuyvCircleSum(const uchar *yuyv, int bytesPerLine, int width, int height,
+                                int centerX, int centerY, int radius, qint64 sum[3],
+                                const ColorCorrection *correction)
+{
+    sum[0] = sum[1] = sum[2] = 0;
+    if (radius <= 0)
+        return 0;
+
+    if (correction && !correction->isActive())
+        correction = NULL;
+
+    int count = 0;
+    int r2 = radius * radius;
+    for (int dy = -radius; dy < radius; dy++) {
+        int y = centerY + dy;
+        if (y < 0 || y >= height)
+            continue;
+
+        // 이 행에서 dx^2 <= r^2 - dy^2 를 만족하는 최대 dx
+        int rem = r2 - dy * dy;
+        int span = (int)sqrt((double)rem);
+        while (span * span > rem) span--;
+        while ((span + 1) * (span + 1) <= rem) span++;
+
+        int x0 = qMax(centerX - span, 0);
+        int x1 = qMin(qMin(centerX + span, centerX + radius - 1), width - 1);
+
+        const uchar *row = yuyv + y * bytesPerLine;
+        for (int x = x0; x <= x1; x++) {
+            const uchar *macro = row + (x & ~1) * 2;
+            int r, g, b;
+            yuvToRgb(row[x * 2], macro[1], macro[3], r, g, b);
+            if (correction) {
+                correction->map(r, g, b);
+            }
+            sum[0] += r;
+            sum[1] += g;
+            sum[2] += b;
+        }
+        count += qMax(0, x1 - x0 + 1);
+    }
+    return count;
+}
@@ -0,0 +1,76 @@
+#ifndef YUVCONVERTER_H
+#define YUVCONVERTER_H
+
+#include <QImage>
+
+class ColorCorrection;
+
+// YUYV(YUV422) -> RGB888 변환 모듈
+// 스칼라 / NEON / SSE2 / AVX2 경로 중 하나를 CPU 기능에 따라 런타임에 선택하며,
+// 모든 경로는 기존 테이블 기반 변환(밝기 1.2배 보정 포함)과 비트 단위로 동일한 결과를 낸다.
+class YuvConverter
+{
+public:
+    // 한 행(row) 변환 함수 타입: yuyv 입력 width 픽셀을 rgb 출력(3바이트/픽셀)으로 변환
+    typedef void (*RowConverter)(const uchar *yuyv, uchar *rgb, int width);
+
+    // 프레임 전체 변환 (rgbImage는 Format_RGB888, width x height 크기여야 함)
+    // correction이 주어지면 각 행을 변환한 직후 (캐시에 있을 때) 같은 행에 색 보정 적용 (이하 동일)
+    static void yuyvToRgb888(const uchar *yuyv, int bytesPerLine, int width, int height, QImage &rgbImage,
+                             const ColorCorrection *correction = NULL);
+
+    // NV12(Y 평면 + UV 인터리브 평면, 4:2:0) -> RGB888, YUYV 경로와 같은 테이블 사용
+    static void nv12ToRgb888(const uchar *yPlane, const uchar *uvPlane, int bytesPerLine,
+                             int width, int height, QImage &rgbImage, const ColorCorrection *correction = NULL);
+
+    // 가로/세로 factor(2 또는 4)배 축소 변환 (factor 간격으로 점 샘플링, 미리보기용)
+    // rgbImage는 Format_RGB888, (width / factor) x (height / factor) 크기여야 함
+    static void yuyvToRgb888Subsampled(const uchar *yuyv, int bytesPerLine, int width, int height,
+                                       int factor, QImage &rgbImage, const ColorCorrection *correction = NULL);
+
+    // YUYV 버퍼에서 원 내부 RGB 합계를 직접 계산 (전체 프레임 변환 없이)
+    // 포함 규칙은 위젯의 calculateAverageRGB와 동일: x, y는 [c - r, c + r), dx^2 + dy^2 <= r^2
+    // 반환값은 포함된 픽셀 수 (correction이 주어지면 보정된 픽셀을 합산)
+    static int yuyvCircleSum(const uchar *yuyv, int bytesPerLine, int width, int height,
+                             int centerX, int centerY, int radius, qint64 sum[3],
+                             const ColorCorrection *correction = NULL);
+
+    // 단일 픽셀 변환 (테이블 기반, 일부 픽셀만 필요할 때 사용)
+    static inline void yuvToRgb(int y, int u, int v, int &r, int &g, int &b)
+    {
+        const Tables &t = tables();
+        int Y = t.y[y];
+        r = qBound(0, Y + t.crRed[v], 255);
+        g = qBound(0, Y + t.cbGreen[u] + t.crGreen[v], 255);
+        b = qBound(0, Y + t.cbBlue[u], 255);
+    }
+
+    // 현재 CPU에서 선택된 행 변환 함수와 그 이름
+    static RowConverter rowConverter();
+    static const char *kernelName();
+
+    // 스칼라 기준 구현 (SIMD 경로 검증용으로 공개)
+    static void convertRowScalar(const uchar *yuyv, uchar *rgb, int width);
+
+private:
+    // 기존 yuv422ToRgb888의 사전 계산 테이블
+    struct Tables {
+        int y[256];
+        int cbBlue[256];
+        int cbGreen[256];
+        int crGreen[256];
+        int crRed[256];
+        Tables();
+    };
+
+    struct Kernel {
+        RowConverter convert;
+        const char *name;
+    };
+
+    static const Tables &tables();
+    static const Kernel &kernel();
+    static Kernel selectKernel();
+};
+
+#endif // YUVCONVERTER_H